@@ -7,7 +7,9 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
+#include "include/utils/SkPathTriangulator.h"
 #include "tools/ToolUtils.h"
 
 enum Align {
@@ -82,3 +84,43 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// Triangulates the same path on the CPU, as a mesh exporter would.
+class BigPathTriangulateBench : public Benchmark {
+    SkPath                          fPath;
+    SkString                        fName;
+    int                             fThreads;
+    std::unique_ptr<SkExecutor>     fExecutor;
+    SkPathTriangulator::Mesh        fMesh;
+
+public:
+    explicit BigPathTriangulateBench(int threads) : fThreads(threads) {
+        fName.printf("bigpath_triangulate_%s", threads ? "threaded" : "serial");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fPath = ToolUtils::make_big_path();
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // One triangulator across loops, so its scratch memory is reused as a client's would be.
+        SkPathTriangulator triangulator(fExecutor.get());
+        for (int i = 0; i < loops; i++) {
+            triangulator.triangulate(fPath, &fMesh);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BigPathTriangulateBench(0); )
+DEF_BENCH( return new BigPathTriangulateBench(4); )
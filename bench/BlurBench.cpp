@@ -31,12 +31,15 @@ static const char* gStyleName[] = {
 class BlurBench : public Benchmark {
     SkScalar    fRadius;
     SkBlurStyle fStyle;
+    SkScalar    fMaxSize;
     SkString    fName;
 
 public:
-    BlurBench(SkScalar rad, SkBlurStyle bs) {
+    // Ovals are up to maxSize on a side; big ones are blurred in strips in parallel.
+    BlurBench(SkScalar rad, SkBlurStyle bs, SkScalar maxSize = 400) {
         fRadius = rad;
         fStyle = bs;
+        fMaxSize = maxSize;
         const char* name = rad > 0 ? gStyleName[bs] : "none";
         const char* quality = "high_quality";
         if (SkScalarFraction(rad) != 0) {
@@ -44,6 +47,9 @@ public:
         } else {
             fName.printf("blur_%d_%s_%s", SkScalarRoundToInt(rad), name, quality);
         }
+        if (maxSize != 400) {
+            fName.appendf("_%d", SkScalarRoundToInt(maxSize));
+        }
     }
 
 protected:
@@ -59,8 +65,8 @@ protected:
 
         SkRandom rand;
         for (int i = 0; i < loops; i++) {
-            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * 400,
-                                      rand.nextUScalar1() * 400);
+            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * fMaxSize,
+                                      rand.nextUScalar1() * fMaxSize);
             r.offset(fRadius, fRadius);
 
             if (fRadius > 0) {
@@ -101,3 +107,8 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Large shadows, through both the small-sigma Gaussian and the triple box kernels.
+DEF_BENCH(return new BlurBench(SMALL, kNormal_SkBlurStyle, 2000);)
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, 2000);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, 2000);)
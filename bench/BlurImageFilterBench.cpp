@@ -18,6 +18,8 @@
 #define FILTER_HEIGHT_SMALL 32
 #define FILTER_WIDTH_LARGE  256
 #define FILTER_HEIGHT_LARGE 256
+#define FILTER_WIDTH_HUGE   2048
+#define FILTER_HEIGHT_HUGE  1536
 #define BLUR_SIGMA_MINI     0.5f
 #define BLUR_SIGMA_SMALL    1.0f
 #define BLUR_SIGMA_LARGE    10.0f
@@ -61,19 +63,21 @@ static SkBitmap make_checkerboard(int width, int height) {
 class BlurImageFilterBench : public Benchmark {
 public:
     BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY,  bool small, bool cropped,
-                         bool expanded)
+                         bool expanded, bool huge = false)
       : fIsSmall(small)
+      , fIsHuge(huge)
       , fIsCropped(cropped)
       , fIsExpanded(expanded)
       , fInitialized(false)
       , fSigmaX(sigmaX)
       , fSigmaY(sigmaY) {
         fName.printf("blur_image_filter_%s%s%s_%.2f_%.2f",
-            fIsSmall ? "small" : "large",
+            fIsHuge ? "huge" : fIsSmall ? "small" : "large",
             fIsCropped ? "_cropped" : "",
             fIsExpanded ? "_expanded" : "",
             SkScalarToFloat(sigmaX), SkScalarToFloat(sigmaY));
         SkASSERT(!fIsExpanded || fIsCropped); // never want expansion w/o cropping
+        SkASSERT(!fIsHuge || !fIsSmall);
     }
 
 protected:
@@ -83,8 +87,13 @@ protected:
 
     void onDelayedSetup() override {
         if (!fInitialized) {
-            fCheckerboard = make_checkerboard(fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE,
-                                              fIsSmall ? FILTER_HEIGHT_SMALL : FILTER_HEIGHT_LARGE);
+            if (fIsHuge) {
+                fCheckerboard = make_checkerboard(FILTER_WIDTH_HUGE, FILTER_HEIGHT_HUGE);
+            } else {
+                fCheckerboard = make_checkerboard(
+                        fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE,
+                        fIsSmall ? FILTER_HEIGHT_SMALL : FILTER_HEIGHT_LARGE);
+            }
             fInitialized = true;
         }
     }
@@ -114,6 +123,7 @@ private:
 
     SkString fName;
     bool fIsSmall;
+    bool fIsHuge;
     bool fIsCropped;
     bool fIsExpanded;
     bool fInitialized;
@@ -160,3 +170,9 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Layers big enough that both passes are split into strips.
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false,
+                                          true);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false,
+                                          true);)
@@ -10,9 +10,11 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkHighContrastFilter.h"
+#include "include/effects/SkColorMatrix.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkOverdrawColorFilter.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/effects/SkTableColorFilter.h"
 #include "src/core/SkColorFilterPriv.h"
 #include "tools/Resources.h"
 
@@ -161,6 +163,35 @@ static constexpr float gColorMatrix[] = {
     0.3f, 0.0f, 0.3f, 0.3f, 0.0f,
 };
 
+// Long chains, as built up by UI code applying one adjustment after another. Matrices that keep
+// colors in range fold into one, as do tables; brightening matrices clamp and can't.
+static sk_sp<SkColorFilter> matrix_chain(float scale) {
+    sk_sp<SkColorFilter> chain;
+    for (int i = 0; i < 8; ++i) {
+        SkColorMatrix cm;
+        if (i % 2) {
+            cm.setSaturation(0.8f);
+        } else {
+            cm.setScale(scale, scale, scale);
+        }
+        chain = SkColorFilters::Matrix(cm)->makeComposed(std::move(chain));
+    }
+    return chain;
+}
+
+static sk_sp<SkColorFilter> table_chain() {
+    sk_sp<SkColorFilter> chain;
+    for (int i = 0; i < 4; ++i) {
+        uint8_t table[256];
+        for (int j = 0; j < 256; ++j) {
+            table[j] = std::min(255, j * (i + 3) / 4);
+        }
+        chain = SkTableColorFilter::MakeARGB(nullptr, table, table, table)
+                        ->makeComposed(std::move(chain));
+    }
+    return chain;
+}
+
 } // namespace
 
 DEF_BENCH( return new ColorFilterBench("none",
@@ -201,6 +232,12 @@ DEF_BENCH( return new ColorFilterBench("overdraw", []() {
 DEF_BENCH( return new ColorFilterBench("gaussian", []() {
     return SkColorFilterPriv::MakeGaussian();
 }); )
+DEF_BENCH( return new ColorFilterBench("matrix_chain8",
+    []() { return matrix_chain(0.9f); }); )
+DEF_BENCH( return new ColorFilterBench("matrix_chain8_clamped",
+    []() { return matrix_chain(1.1f); }); )
+DEF_BENCH( return new ColorFilterBench("table_chain4",
+    []() { return table_chain(); }); )
 
 #if SK_SUPPORT_GPU
 DEF_BENCH( return new ColorFilterBench("src_runtime", []() {
@@ -7,11 +7,20 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
+#include "src/core/SkSpecialSurfacePool.h"
 #include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
+
+static DEFINE_bool(filterPoolStats, false,
+                   "Print how many image filter intermediates each run allocates and reuses?");
 
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
 // This bench shows an improvement in performance once cacheing of re-used
@@ -103,6 +112,105 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Filters a large raster layer through blur -> color filter -> merge, either all at once or one
+// tile at a time. Untiled, every node of the DAG produces a full-size intermediate; tiled, the
+// intermediates are tile-sized and only the final image covers the whole layer. Unpooled, the
+// intermediates' pixels are freed rather than kept for reuse (see SkSpecialSurfacePool);
+// --filterPoolStats prints how many intermediates each run had to allocate.
+class ImageMakeWithFilterTiledDAGBench : public Benchmark {
+public:
+    ImageMakeWithFilterTiledDAGBench(int tileSize, int threads, bool pooled = true)
+            : fTileSize(tileSize), fThreads(threads), fPooled(pooled) {
+        if (tileSize) {
+            fName.printf("image_make_with_filter_dag_tiled_%d%s", tileSize,
+                         threads ? "_threaded" : "");
+        } else {
+            fName.set("image_make_with_filter_dag_untiled");
+        }
+        if (!pooled) {
+            fName.append("_unpooled");
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(kLayerSize, kLayerSize);
+        SkPaint paint;
+        for (int i = 0; i < 64; ++i) {
+            paint.setColor(0xFF000000 | (i * 0x3F1D27));
+            surface->getCanvas()->drawCircle((i % 8 + 0.5f) * kLayerSize / 8,
+                                             (i / 8 + 0.5f) * kLayerSize / 8,
+                                             kLayerSize / 20.f, paint);
+        }
+        fImage = surface->makeImageSnapshot();
+
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(10.0f, 10.0f, nullptr);
+        sk_sp<SkImageFilter> tinted = SkImageFilters::ColorFilter(
+                SkColorFilters::Blend(0x80FF8000, SkBlendMode::kSrcATop), blur);
+        fFilter = SkImageFilters::Merge(blur, tinted);
+
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        SkSpecialSurfacePool* pool = SkSpecialSurfacePool::Get();
+        fSavedBudget = pool->budget();
+        if (!fPooled) {
+            pool->setBudget(0);
+        }
+        fStartStats = pool->stats();
+        fRuns = 0;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkSpecialSurfacePool* pool = SkSpecialSurfacePool::Get();
+        SkSpecialSurfacePool::Stats stats = pool->stats();
+        pool->setBudget(fSavedBudget);
+        if (FLAGS_filterPoolStats && fRuns) {
+            SkDebugf("%s: %.1f intermediates allocated, %.1f reused per run\n", fName.c_str(),
+                     (double)(stats.fAllocations - fStartStats.fAllocations) / fRuns,
+                     (double)(stats.fReuses - fStartStats.fReuses) / fRuns);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkIRect bounds = SkIRect::MakeSize(fImage->dimensions());
+        SkIRect outSubset;
+        SkIPoint offset;
+        for (int j = 0; j < loops; j++) {
+            sk_sp<SkImage> result =
+                    fTileSize ? fImage->makeWithFilter(fFilter.get(), bounds, bounds, &outSubset,
+                                                       &offset, fTileSize, fExecutor.get())
+                              : fImage->makeWithFilter(nullptr, fFilter.get(), bounds, bounds,
+                                                       &outSubset, &offset);
+            SkASSERT(result);
+        }
+        fRuns += loops;
+    }
+
+private:
+    static constexpr int kLayerSize = 4096;
+
+    int                         fTileSize;
+    int                         fThreads;
+    bool                        fPooled;
+    SkString                    fName;
+    size_t                      fSavedBudget = 0;
+    SkSpecialSurfacePool::Stats fStartStats;
+    int                         fRuns = 0;
+    sk_sp<SkImage>              fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
 // Exercise a blur filter connected to both inputs of an SkDisplacementMapEffect.
 
 class ImageFilterDisplacedBlur : public Benchmark {
@@ -166,5 +274,9 @@ private:
 
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
+DEF_BENCH(return new ImageMakeWithFilterTiledDAGBench(0, 0);)
+DEF_BENCH(return new ImageMakeWithFilterTiledDAGBench(512, 0);)
+DEF_BENCH(return new ImageMakeWithFilterTiledDAGBench(512, 4);)
+DEF_BENCH(return new ImageMakeWithFilterTiledDAGBench(512, 0, false);)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
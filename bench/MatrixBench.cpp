@@ -6,10 +6,13 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPoint3.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMatrixUtils.h"
 
+#include <vector>
+
 class MatrixBench : public Benchmark {
     SkString    fName;
 public:
@@ -300,6 +303,73 @@ DEF_BENCH( return new MapPointsMatrixBench("mappoints_affine", make_afine()); )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static SkMatrix make_persp() { SkMatrix m(make_afine()); m.setPerspX(0.001f); return m; }
+
+// Maps arrays far larger than cache, as a renderer transforming a whole tile of geometry does.
+class MapArrayMatrixBench : public MatrixBench {
+public:
+    enum class Kind { kPoints, kHomogeneous, kRects, kQuads };
+
+    MapArrayMatrixBench(const char name[], const SkMatrix& m, Kind kind)
+        : MatrixBench(name), fM(m), fKind(kind) {}
+
+protected:
+    static constexpr int N = 1 << 20;
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        if (fKind == Kind::kRects || fKind == Kind::kQuads) {
+            fRects.resize(N / 4);
+            for (SkRect& r : fRects) {
+                r.setXYWH(rand.nextSScalar1(), rand.nextSScalar1(), rand.nextUScalar1(),
+                          rand.nextUScalar1());
+            }
+        } else {
+            fSrc.resize(N);
+            for (SkPoint& p : fSrc) {
+                p.set(rand.nextSScalar1(), rand.nextSScalar1());
+            }
+        }
+        fDst.resize(N);
+        fDst3.resize(fKind == Kind::kHomogeneous ? N : 0);
+        fDstRects.resize(fKind == Kind::kRects ? N / 4 : 0);
+    }
+
+    void performTest() override {
+        switch (fKind) {
+            case Kind::kPoints:
+                fM.mapPoints(fDst.data(), fSrc.data(), N);
+                break;
+            case Kind::kHomogeneous:
+                fM.mapHomogeneousPoints(fDst3.data(), fSrc.data(), N);
+                break;
+            case Kind::kRects:
+                fM.mapRects(fDstRects.data(), fRects.data(), N / 4);
+                break;
+            case Kind::kQuads:
+                fM.mapRectsToQuads(fDst.data(), fRects.data(), N / 4);
+                break;
+        }
+    }
+
+private:
+    SkMatrix              fM;
+    Kind                  fKind;
+    std::vector<SkPoint>  fSrc, fDst;
+    std::vector<SkPoint3> fDst3;
+    std::vector<SkRect>   fRects, fDstRects;
+};
+using MapArray = MapArrayMatrixBench::Kind;
+DEF_BENCH( return new MapArrayMatrixBench("mappoints_1M_affine", make_afine(), MapArray::kPoints); )
+DEF_BENCH( return new MapArrayMatrixBench("mappoints_1M_persp", make_persp(), MapArray::kPoints); )
+DEF_BENCH( return new MapArrayMatrixBench("maphomogeneous_1M_persp", make_persp(),
+                                          MapArray::kHomogeneous); )
+DEF_BENCH( return new MapArrayMatrixBench("maprects_256K_affine", make_afine(), MapArray::kRects); )
+DEF_BENCH( return new MapArrayMatrixBench("maprectstoquads_256K_persp", make_persp(),
+                                          MapArray::kQuads); )
+
+///////////////////////////////////////////////////////////////////////////////
+
 class MapRectMatrixBench : public MatrixBench {
     SkMatrix fM;
     SkRect   fR;
@@ -14,38 +14,42 @@
 
 #include "tools/ToolUtils.h"
 
+#include <memory>
+
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
-        : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+    // Square kernels of the given size. A separable kernel is the outer product of two vectors,
+    // which the raster backend convolves as a row pass followed by a column pass.
+    MatrixConvolutionBench(int kernelSize, SkTileMode tileMode, bool convolveAlpha,
+                           bool separable = false)
+        : fName(SkStringPrintf("matrixconvolution_%s%s%s%s",
+                               kernel_size_name(kernelSize).c_str(),
+                               separable ? "separable_" : "",
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
-            SkISize kernelSize = SkISize::Make(9, 9);
-            SkScalar kernel[81];
-            for (int i = 0; i < 81; i++) {
-                kernel[i] = SkIntToScalar(1);
+        int count = kernelSize * kernelSize;
+        std::unique_ptr<SkScalar[]> kernel(new SkScalar[count]);
+        SkScalar gain = 0.3f, bias = SkIntToScalar(100);
+        if (separable) {
+            // A tent in each direction, normalized to sum to 1.
+            int half = kernelSize / 2;
+            for (int i = 0; i < count; i++) {
+                kernel[i] = SkIntToScalar((half + 1 - SkTAbs(i / kernelSize - half)) *
+                                          (half + 1 - SkTAbs(i % kernelSize - half)));
             }
-            kernel[40] = SkIntToScalar(-79);
-            SkScalar gain = 0.3f, bias = SkIntToScalar(100);
-            SkIPoint kernelOffset = SkIPoint::Make(4, 4);
-            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
-                                                        kernelOffset, tileMode, convolveAlpha,
-                                                        nullptr);
+            gain = 1.0f / ((half + 1) * (half + 1) * (half + 1) * (half + 1));
+            bias = 0;
         } else {
-            SkISize kernelSize = SkISize::Make(3, 3);
-            SkScalar kernel[9] = {
-                SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-                SkIntToScalar( 1), SkIntToScalar(-7), SkIntToScalar( 1),
-                SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-            };
-            SkScalar gain = 0.3f, bias = SkIntToScalar(100);
-            SkIPoint kernelOffset = SkIPoint::Make(1, 1);
-            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
-                                                        kernelOffset, tileMode, convolveAlpha,
-                                                        nullptr);
+            // All ones around a center that cancels them out, so flat areas map to 'bias'.
+            for (int i = 0; i < count; i++) {
+                kernel[i] = SkIntToScalar(1);
+            }
+            kernel[count / 2] = SkIntToScalar(2 - count);
         }
+        SkIPoint kernelOffset = SkIPoint::Make(kernelSize / 2, kernelSize / 2);
+        fFilter = SkImageFilters::MatrixConvolution(SkISize::Make(kernelSize, kernelSize),
+                                                    kernel.get(), gain, bias, kernelOffset,
+                                                    tileMode, convolveAlpha, nullptr);
     }
 
 protected:
@@ -68,20 +72,36 @@ protected:
     }
 
 private:
+    static SkString kernel_size_name(int kernelSize) {
+        switch (kernelSize) {
+            case 3:  return SkString();
+            case 9:  return SkString("bigKernel_");
+            default: return SkStringPrintf("%dx%dKernel_", kernelSize, kernelSize);
+        }
+    }
+
     sk_sp<SkImageFilter> fFilter;
     SkString fName;
 
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(25, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(25, SkTileMode::kDecal, true); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(3, SkTileMode::kClamp, true, true); )
+DEF_BENCH( return new MatrixConvolutionBench(9, SkTileMode::kClamp, true, true); )
+DEF_BENCH( return new MatrixConvolutionBench(25, SkTileMode::kClamp, true, true); )
+DEF_BENCH( return new MatrixConvolutionBench(25, SkTileMode::kDecal, false, true); )
@@ -14,15 +14,20 @@ class MipmapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    SkMipmap::Averaging fAveraging;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false,
+                SkMipmap::Averaging averaging = SkMipmap::Averaging::kEncoded)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fAveraging(averaging)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (averaging == SkMipmap::Averaging::kLinearLight) {
+            fName.append("_linear");
+        }
     }
 
 protected:
@@ -42,7 +47,7 @@ protected:
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap.pixmap(), nullptr, true, fAveraging)->unref();
         }
     }
 
@@ -65,3 +70,11 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Large textures fill their top levels in strips; nanobench's --threads sets how many run at once.
+DEF_BENCH( return new MipmapBench(4096, 4096); )
+DEF_BENCH( return new MipmapBench(4095, 4095); )
+DEF_BENCH( return new MipmapBench(4096, 4096, true); )
+
+DEF_BENCH( return new MipmapBench(512, 512, false, SkMipmap::Averaging::kLinearLight); )
+DEF_BENCH( return new MipmapBench(2048, 2048, false, SkMipmap::Averaging::kLinearLight); )
@@ -94,3 +94,11 @@ DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
 DEF_BENCH( return new MorphologyBench(0, kErode_MT); )
+
+// Large radii, as used for outlines, up to the raster limit.
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(1), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(16), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(64), kErode_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(64), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(256), kErode_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(256), kDilate_MT); )
@@ -12,6 +12,7 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
+#include "include/utils/SkCompactPath.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkPathPriv.h"
 
@@ -19,9 +20,10 @@ enum class PathIterType {
     kIter,
     kRaw,
     kEdge,
+    kCompact,
 };
 const char* gPathIterNames[] = {
-    "iter", "raw", "edge"
+    "iter", "raw", "edge", "compact"
 };
 
 static int rand_pts(SkRandom& rand, SkPoint pts[4]) {
@@ -38,6 +40,7 @@ static int rand_pts(SkRandom& rand, SkPoint pts[4]) {
 class PathIterBench : public Benchmark {
     SkString        fName;
     SkPath          fPath;
+    SkCompactPath   fCompact;
     PathIterType    fType;
 
     int fVerbInc = 0;
@@ -66,6 +69,9 @@ public:
                     break;
             }
         }
+        if (PathIterType::kCompact == fType) {
+            fCompact = SkCompactPath::Make(fPath);
+        }
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -112,6 +118,16 @@ protected:
                     }
                 }
                 break;
+            case PathIterType::kCompact:
+                for (int i = 0; i < loops; ++i) {
+                    SkCompactPath::Iter iter(fCompact);
+                    SkPathVerb compactVerb;
+                    SkScalar weight;
+                    while (iter.next(&compactVerb, pts, &weight)) {
+                        handle((int)compactVerb, pts);
+                    }
+                }
+                break;
         }
     }
 
@@ -124,3 +140,4 @@ private:
 DEF_BENCH( return new PathIterBench(PathIterType::kIter); )
 DEF_BENCH( return new PathIterBench(PathIterType::kRaw); )
 DEF_BENCH( return new PathIterBench(PathIterType::kEdge); )
+DEF_BENCH( return new PathIterBench(PathIterType::kCompact); )
@@ -6,6 +6,7 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
@@ -17,10 +18,14 @@ class PathOpsBench : public Benchmark {
     SkString    fName;
     SkPath      fPath1, fPath2;
     SkPathOp    fOp;
+    std::unique_ptr<SkOpContext> fContext;
 
 public:
-    PathOpsBench(const char suffix[], SkPathOp op) : fOp(op) {
-        fName.printf("pathops_%s", suffix);
+    PathOpsBench(const char suffix[], SkPathOp op, bool useContext = false) : fOp(op) {
+        fName.printf("pathops_%s%s", suffix, useContext ? "_context" : "");
+        if (useContext) {
+            fContext = std::make_unique<SkOpContext>();
+        }
 
         fPath1.addOval({-10, -20, 10, 20});
         fPath2.addOval({-20, -10, 20, 10});
@@ -39,7 +44,11 @@ protected:
         for (int i = 0; i < loops; i++) {
             for (int j = 0; j < 1000; ++j) {
                 SkPath result;
-                Op(fPath1, fPath2, fOp, &result);
+                if (fContext) {
+                    fContext->op(fPath1, fPath2, fOp, &result);
+                } else {
+                    Op(fPath1, fPath2, fOp, &result);
+                }
             }
         }
     }
@@ -80,6 +89,8 @@ private:
 };
 DEF_BENCH( return new PathOpsBench("sect", kIntersect_SkPathOp); )
 DEF_BENCH( return new PathOpsBench("join", kUnion_SkPathOp); )
+DEF_BENCH( return new PathOpsBench("sect", kIntersect_SkPathOp, true); )
+DEF_BENCH( return new PathOpsBench("join", kUnion_SkPathOp, true); )
 
 static SkPath makerects() {
     SkRandom rand;
@@ -94,6 +105,81 @@ static SkPath makerects() {
 }
 DEF_BENCH( return new PathOpsSimplifyBench("rects", makerects()); )
 
+// Unions many small, partially overlapping quads, in the style of building footprints on a
+// map tile: clusters of a few neighbors, with most clusters disjoint from one another.
+class PathOpsManyBench : public Benchmark {
+public:
+    enum class Mode { kBuilder, kBulk, kBulkThreaded };
+
+private:
+    SkString                     fName;
+    int                          fCount;
+    Mode                         fMode;
+    SkTArray<SkPath>             fPaths;
+    std::unique_ptr<SkExecutor>  fExecutor;
+
+public:
+    PathOpsManyBench(int count, Mode mode) : fCount(count), fMode(mode) {
+        const char* modeNames[] = { "builder", "bulk", "bulk_threaded" };
+        fName.printf("pathops_union_many_%d_%s", count, modeNames[(int)mode]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        int cols = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(fCount)));
+        for (int i = 0; i < fCount; ++i) {
+            SkScalar x = (i % cols) * 10 + rand.nextRangeScalar(0, 6);
+            SkScalar y = (i / cols) * 10 + rand.nextRangeScalar(0, 6);
+            SkScalar w = rand.nextRangeScalar(3, 9);
+            SkScalar h = rand.nextRangeScalar(3, 9);
+            SkPath& path = fPaths.push_back();
+            path.moveTo(x, y);
+            path.lineTo(x + w, y + rand.nextRangeScalar(-1, 1));
+            path.lineTo(x + w, y + h);
+            path.lineTo(x + rand.nextRangeScalar(-1, 1), y + h);
+            path.close();
+        }
+        if (Mode::kBulkThreaded == fMode) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkPath result;
+            if (Mode::kBuilder == fMode) {
+                SkOpBuilder builder;
+                for (const SkPath& path : fPaths) {
+                    builder.add(path, kUnion_SkPathOp);
+                }
+                builder.resolve(&result);
+            } else {
+                BulkOp(fPaths.begin(), fPaths.count(), kUnion_SkPathOp, &result,
+                       fExecutor.get());
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new PathOpsManyBench(100, PathOpsManyBench::Mode::kBuilder); )
+DEF_BENCH( return new PathOpsManyBench(100, PathOpsManyBench::Mode::kBulk); )
+DEF_BENCH( return new PathOpsManyBench(1000, PathOpsManyBench::Mode::kBuilder); )
+DEF_BENCH( return new PathOpsManyBench(1000, PathOpsManyBench::Mode::kBulk); )
+DEF_BENCH( return new PathOpsManyBench(1000, PathOpsManyBench::Mode::kBulkThreaded); )
+DEF_BENCH( return new PathOpsManyBench(10000, PathOpsManyBench::Mode::kBulk); )
+DEF_BENCH( return new PathOpsManyBench(10000, PathOpsManyBench::Mode::kBulkThreaded); )
+
 #include "include/core/SkPathBuilder.h"
 
 template <size_t N> struct ArrayPath {
@@ -6,9 +6,14 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
+#include "include/core/SkSerialProcs.h"
 
 class ClipOverheadRecordingBench : public Benchmark {
 public:
@@ -40,3 +45,56 @@ private:
     }
 };
 DEF_BENCH( return new ClipOverheadRecordingBench; )
+
+// Deserializes a picture drawing many distinct encoded images, with an image proc that decodes
+// them up front, as media-heavy clients do. In parallel, the images decode on a thread pool.
+class PictureDeserializeBench : public Benchmark {
+public:
+    explicit PictureDeserializeBench(bool parallel) : fParallel(parallel) {}
+
+private:
+    static constexpr int kImages = 32;
+
+    const char* onGetName() override {
+        return fParallel ? "picture_deserialize_images_parallel" : "picture_deserialize_images";
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder rec;
+        SkCanvas* canvas = rec.beginRecording({0,0, 2048,1024});
+        for (int i = 0; i < kImages; i++) {
+            SkBitmap bm;
+            bm.allocN32Pixels(256, 256);
+            bm.eraseColor(SkColorSetARGB(0xFF, 8*i, 255 - 8*i, 0x80));
+            for (int y = 0; y < 256; y += 8) {
+                bm.erase(SkColorSetARGB(0xFF, y, 4*i, 255 - y), SkIRect::MakeXYWH(y, y, 64, 8));
+            }
+            bm.setImmutable();
+            canvas->drawImage(SkImage::MakeFromBitmap(bm), 256 * (i % 8), 256 * (i / 8));
+        }
+        fData = rec.finishRecordingAsPicture()->serialize();
+
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkDeserialProcs procs;
+        procs.fImageProc = [](const void* data, size_t length, void*) -> sk_sp<SkImage> {
+            auto image = SkImage::MakeFromEncoded(SkData::MakeWithCopy(data, length));
+            return image ? image->makeRasterImage() : nullptr;
+        };
+        procs.fExecutor = fExecutor.get();
+        for (int i = 0; i < loops; i++) {
+            (void)SkPicture::MakeFromData(fData.get(), &procs);
+        }
+    }
+
+    const bool                  fParallel;
+    sk_sp<SkData>               fData;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+DEF_BENCH( return new PictureDeserializeBench(false); )
+DEF_BENCH( return new PictureDeserializeBench(true); )
@@ -15,6 +15,7 @@
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkString.h"
+#include "include/utils/SkNoDrawCanvas.h"
 #include "include/utils/SkRandom.h"
 
 // This is designed to emulate about 4 screens of textual content
@@ -97,3 +98,44 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Plays back ops that point at recorded arrays into a canvas that draws nothing, to measure the
+// cost of walking the SkRecord itself.
+class OpDispatchPlaybackBench : public Benchmark {
+public:
+    const char* onGetName() override { return "picture_playback_op_dispatch"; }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+            SkRandom rand;
+            for (int i = 0; i < 10000; i++) {
+                SkPaint paint;
+                paint.setColor(rand.nextU());
+                SkPoint pts[8];
+                for (SkPoint& pt : pts) {
+                    pt = {rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024)};
+                }
+                canvas->drawRect(SkRect::MakeXYWH(pts[0].fX, pts[0].fY, 16, 16), paint);
+                canvas->drawPoints(SkCanvas::kLines_PointMode, 8, pts, paint);
+                canvas->save();
+                    canvas->translate(pts[1].fX, pts[1].fY);
+                    canvas->drawOval({0,0, 16,16}, paint);
+                canvas->restore();
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkNoDrawCanvas canvas(1024, 1024);
+        for (int i = 0; i < loops; i++) {
+            fPic->playback(&canvas);
+        }
+    }
+
+private:
+    sk_sp<SkPicture> fPic;
+};
+
+DEF_BENCH( return new OpDispatchPlaybackBench; )
@@ -12,6 +12,8 @@
 #include "include/utils/SkRandom.h"
 #include "src/core/SkRTree.h"
 
+#include <memory>
+
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
@@ -126,6 +128,99 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
     return SkRect::MakeWH(SkIntToScalar(index+1), SkIntToScalar(index+1));
 }
 
+// Build, update and query a tree of a million small rects spread over a large, mostly empty area.
+class RTreeMillionBench : public Benchmark {
+public:
+    enum class Mode {
+        kBuild,          // bulk load
+        kUpdate,         // move one rect a little, or far away
+        kQuery,          // search() into a vector
+        kQueryCallback,  // search() with a callback
+    };
+
+    RTreeMillionBench(Mode mode, SkRTree::BulkLoad bulkLoad, const char* name)
+            : fMode(mode), fBulkLoad(bulkLoad) {
+        fName.printf("rtree_1M_%s", name);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    static constexpr int kRects = 1000000;
+    static constexpr SkScalar kExtents = 20000;
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    static SkRect MakeRect(SkRandom& rand) {
+        return SkRect::MakeXYWH(rand.nextRangeF(0, kExtents), rand.nextRangeF(0, kExtents),
+                                rand.nextRangeF(1, 20), rand.nextRangeF(1, 20));
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fRects.reset(kRects);
+        for (int i = 0; i < kRects; ++i) {
+            fRects[i] = MakeRect(rand);
+        }
+        if (fMode != Mode::kBuild) {
+            fTree = std::make_unique<SkRTree>(fBulkLoad);
+            fTree->insert(fRects.get(), kRects);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRandom rand;
+        switch (fMode) {
+            case Mode::kBuild:
+                for (int i = 0; i < loops; ++i) {
+                    SkRTree tree(fBulkLoad);
+                    tree.insert(fRects.get(), kRects);
+                }
+                break;
+            case Mode::kUpdate:
+                for (int i = 0; i < loops; ++i) {
+                    int index = rand.nextULessThan(kRects);
+                    SkRect& rect = fRects[index];
+                    if (rand.nextULessThan(8)) {
+                        rect.offset(rand.nextRangeF(-2, 2), rand.nextRangeF(-2, 2));
+                    } else {
+                        rect = MakeRect(rand);
+                    }
+                    fTree->update(index, rect);
+                }
+                break;
+            case Mode::kQuery:
+                for (int i = 0; i < loops; ++i) {
+                    std::vector<int> hits;
+                    fTree->search(SkRect::MakeXYWH(rand.nextRangeF(0, kExtents),
+                                                   rand.nextRangeF(0, kExtents), 256, 256),
+                                  &hits);
+                }
+                break;
+            case Mode::kQueryCallback:
+                for (int i = 0; i < loops; ++i) {
+                    int hits = 0;
+                    fTree->search(SkRect::MakeXYWH(rand.nextRangeF(0, kExtents),
+                                                   rand.nextRangeF(0, kExtents), 256, 256),
+                                  [&hits](int) { hits++; });
+                }
+                break;
+        }
+    }
+
+private:
+    Mode fMode;
+    SkRTree::BulkLoad fBulkLoad;
+    SkString fName;
+    SkAutoTMalloc<SkRect> fRects;
+    std::unique_ptr<SkRTree> fTree;
+    using INHERITED = Benchmark;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
@@ -137,3 +232,13 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+using Mode = RTreeMillionBench::Mode;
+using BulkLoad = SkRTree::BulkLoad;
+DEF_BENCH(return new RTreeMillionBench(Mode::kBuild, BulkLoad::kInputOrder, "build"));
+DEF_BENCH(return new RTreeMillionBench(Mode::kBuild, BulkLoad::kHilbert, "build_hilbert"));
+DEF_BENCH(return new RTreeMillionBench(Mode::kUpdate, BulkLoad::kHilbert, "update"));
+DEF_BENCH(return new RTreeMillionBench(Mode::kQuery, BulkLoad::kInputOrder, "query"));
+DEF_BENCH(return new RTreeMillionBench(Mode::kQuery, BulkLoad::kHilbert, "query_hilbert"));
+DEF_BENCH(return new RTreeMillionBench(Mode::kQueryCallback, BulkLoad::kHilbert,
+                                       "query_hilbert_callback"));
@@ -46,6 +46,54 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+
+static const char* pass_name(RecordOptsBench::Pass pass) {
+    switch (pass) {
+        case RecordOptsBench::Pass::kNone:            return "none";
+        case RecordOptsBench::Pass::kSubsumedClips:   return "subsumed_clips";
+        case RecordOptsBench::Pass::kOccludedDraws:   return "occluded_draws";
+        case RecordOptsBench::Pass::kMergeImageDraws: return "merge_image_draws";
+        case RecordOptsBench::Pass::kOptimize2:       return "optimize2";
+    }
+    SkUNREACHABLE;
+}
+
+RecordOptsBench::RecordOptsBench(const char* name, const SkPicture* pic, Pass pass)
+    : INHERITED(name, pic)
+    , fPass(pass) {
+    fName.appendf("_%s", pass_name(pass));
+}
+
+bool RecordOptsBench::isSuitableFor(Backend backend) {
+    // What the passes save is mostly in drawing, so this one wants a real canvas.
+    return backend != kNonRendering_Backend;
+}
+
+void RecordOptsBench::onDelayedSetup() {
+    fRecord = sk_make_sp<SkRecord>();
+    SkRecorder recorder(fRecord.get(), fSrc->cullRect());
+    fSrc->playback(&recorder);
+
+    switch (fPass) {
+        case Pass::kNone:                                                         break;
+        case Pass::kSubsumedClips:   SkRecordNoopSubsumedClips(fRecord.get());   break;
+        case Pass::kOccludedDraws:   SkRecordNoopOccludedDraws(fRecord.get());   break;
+        case Pass::kMergeImageDraws: SkRecordMergeImageDraws(fRecord.get());     break;
+        case Pass::kOptimize2:       SkRecordOptimize2(fRecord.get());           break;
+    }
+    fRecord->defrag();
+}
+
+void RecordOptsBench::onDraw(int loops, SkCanvas* canvas) {
+    while (loops --> 0) {
+        SkRecordDraw(*fRecord, canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
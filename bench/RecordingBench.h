@@ -10,6 +10,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkPicture.h"
+#include "src/core/SkRecord.h"
 
 class PictureCentricBench : public Benchmark {
 public:
@@ -40,6 +41,32 @@ private:
     using INHERITED = PictureCentricBench;
 };
 
+// Draws a picture after running one of the experimental SkRecordOpts passes over it.
+class RecordOptsBench : public PictureCentricBench {
+public:
+    enum class Pass {
+        kNone,
+        kSubsumedClips,
+        kOccludedDraws,
+        kMergeImageDraws,
+        kOptimize2,
+    };
+    static constexpr int kPassCount = 5;
+
+    RecordOptsBench(const char* name, const SkPicture*, Pass);
+
+protected:
+    bool isSuitableFor(Backend) override;
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    Pass            fPass;
+    sk_sp<SkRecord> fRecord;
+
+    using INHERITED = PictureCentricBench;
+};
+
 class DeserializePictureBench : public Benchmark {
 public:
     DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/utils/SkRandom.h"
+#include "include/utils/SkRetainedPictureRecorder.h"
+
+#include <vector>
+
+// A UI-like scene of many small groups, of which one changes each frame: recorded from scratch
+// with SkPictureRecorder, or with SkRetainedPictureRecorder re-recording only what changed.
+class RetainedRecordingBench : public Benchmark {
+public:
+    static constexpr int kGroups = 200,
+                         kRectsPerGroup = 50;
+
+    explicit RetainedRecordingBench(bool retained) : fRetained(retained) {}
+
+private:
+    const char* onGetName() override {
+        return fRetained ? "retained_recording" : "retained_recording_baseline";
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fRects.resize(kGroups * kRectsPerGroup);
+        for (SkRect& rect : fRects) {
+            rect = SkRect::MakeXYWH(rand.nextRangeF(0, 90), rand.nextRangeF(0, 90),
+                                    rand.nextRangeF(1, 10), rand.nextRangeF(1, 10));
+        }
+    }
+
+    void drawGroup(SkCanvas* canvas, int group) {
+        SkPaint paint;
+        paint.setColor(SK_ColorBLACK + group);
+        for (int i = 0; i < kRectsPerGroup; i++) {
+            canvas->drawRect(fRects[group * kRectsPerGroup + i], paint);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkRect bounds = SkRect::MakeWH(1000, 1000),
+                     groupBounds = SkRect::MakeWH(100, 100);
+        SkRTreeFactory factory;
+        for (int frame = 0; frame < loops; frame++) {
+            const int changed = frame % kGroups;
+            SkCanvas* canvas;
+            if (fRetained) {
+                fRecorder.invalidate(changed);
+                canvas = fRecorder.beginRecording(bounds, &factory);
+            } else {
+                canvas = fBaseline.beginRecording(bounds, &factory);
+            }
+            for (int group = 0; group < kGroups; group++) {
+                canvas->save();
+                canvas->translate(group % 10 * 100, group / 10 * 100);
+                if (!fRetained) {
+                    this->drawGroup(canvas, group);
+                } else if (!fRecorder.drawGroup(group)) {
+                    this->drawGroup(fRecorder.beginGroup(group, groupBounds), group);
+                    fRecorder.endGroup();
+                }
+                canvas->restore();
+            }
+            (void)(fRetained ? fRecorder.finishRecordingAsPicture()
+                             : fBaseline.finishRecordingAsPicture());
+        }
+    }
+
+    bool                      fRetained;
+    std::vector<SkRect>       fRects;
+    SkPictureRecorder         fBaseline;
+    SkRetainedPictureRecorder fRecorder;
+};
+
+DEF_BENCH(return new RetainedRecordingBench(false);)
+DEF_BENCH(return new RetainedRecordingBench(true);)
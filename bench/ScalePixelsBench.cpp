@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkPixmap.h"
+
+// Compares the kHigh_SkFilterQuality path of SkPixmap::scalePixels(), which draws through a
+// bicubic shader, with the separable ResampleFilter path.
+class ScalePixelsBench : public Benchmark {
+public:
+    ScalePixelsBench(SkISize src, SkISize dst, const char* filterName,
+                     SkPixmap::ResampleFilter filter, bool useFilter, bool linear = false)
+        : fSrcSize(src), fDstSize(dst), fFilter(filter), fUseFilter(useFilter), fLinear(linear) {
+        fName.printf("scalepixels_%dx%d_%dx%d_%s%s", src.width(), src.height(), dst.width(),
+                     dst.height(), filterName, linear ? "_linear" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        auto info = SkImageInfo::MakeN32Premul(fSrcSize.width(), fSrcSize.height(),
+                                               SkColorSpace::MakeSRGB());
+        fSrc.allocPixels(info);
+        for (int y = 0; y < fSrc.height(); ++y) {
+            for (int x = 0; x < fSrc.width(); ++x) {
+                *fSrc.getAddr32(x, y) = SkPackARGB32(0xFF, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF);
+            }
+        }
+        fDst.allocPixels(info.makeDimensions(fDstSize));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fUseFilter) {
+                fSrc.pixmap().scalePixels(fDst.pixmap(), fFilter, fLinear);
+            } else {
+                fSrc.pixmap().scalePixels(fDst.pixmap(), kHigh_SkFilterQuality);
+            }
+        }
+    }
+
+private:
+    SkString                 fName;
+    SkISize                  fSrcSize,
+                             fDstSize;
+    SkPixmap::ResampleFilter fFilter;
+    bool                     fUseFilter,
+                             fLinear;
+    SkBitmap                 fSrc,
+                             fDst;
+};
+
+#define SCALE_PIXELS_BENCHES(sw, sh, dw, dh)                                                    \
+    DEF_BENCH(return new ScalePixelsBench({sw, sh}, {dw, dh}, "high",                           \
+                                          SkPixmap::ResampleFilter::kMitchell, false);)         \
+    DEF_BENCH(return new ScalePixelsBench({sw, sh}, {dw, dh}, "triangle",                       \
+                                          SkPixmap::ResampleFilter::kTriangle, true);)          \
+    DEF_BENCH(return new ScalePixelsBench({sw, sh}, {dw, dh}, "mitchell",                       \
+                                          SkPixmap::ResampleFilter::kMitchell, true);)          \
+    DEF_BENCH(return new ScalePixelsBench({sw, sh}, {dw, dh}, "lanczos3",                       \
+                                          SkPixmap::ResampleFilter::kLanczos3, true);)          \
+    DEF_BENCH(return new ScalePixelsBench({sw, sh}, {dw, dh}, "mitchell",                       \
+                                          SkPixmap::ResampleFilter::kMitchell, true, true);)
+
+SCALE_PIXELS_BENCHES(1024, 1024, 256, 256)
+SCALE_PIXELS_BENCHES(2048, 1536, 1280, 960)
+SCALE_PIXELS_BENCHES(256, 256, 1024, 1024)
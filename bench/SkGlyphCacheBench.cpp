@@ -12,6 +12,7 @@
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "src/core/SkRemoteGlyphCache.h"
+#include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkTaskGroup.h"
@@ -244,6 +245,52 @@ public:
     DiffCanvasBench(SkString n, std::function<std::unique_ptr<SkStreamAsset>()> f)
         : fBenchName(std::move(n)), fDataProvider(std::move(f)) {}
 };
+
+// Replays a trace through a strike server and into a strike client, as an out-of-process
+// renderer would, but with both in this process. Each loop starts both sides from nothing, so
+// every glyph the trace uses is serialized and read back.
+class RemoteGlyphCacheLoopbackBench : public Benchmark {
+    SkString fBenchName;
+    std::function<std::unique_ptr<SkStreamAsset>()> fDataProvider;
+    std::vector<SkTextBlobTrace::Record> fTrace;
+
+    const char* onGetName() override { return fBenchName.c_str(); }
+
+    bool isSuitableFor(Backend b) override { return b == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas* modelCanvas) override {
+        SkSurfaceProps props;
+        if (modelCanvas) { modelCanvas->getProps(&props); }
+        while (loops --> 0) {
+            auto discardableManager = sk_make_sp<DiscardableManager>();
+            SkStrikeServer server(discardableManager.get());
+            SkStrikeCache clientStrikeCache;
+            SkStrikeClient client(discardableManager, false, &clientStrikeCache);
+
+            SkTextBlobCacheDiffCanvas canvas{1024, 1024, props, &server};
+            for (const auto& record : fTrace) {
+                canvas.drawTextBlob(
+                        record.blob.get(), record.offset.x(), record.offset.y(), record.paint);
+            }
+            std::vector<uint8_t> strikeData;
+            server.writeStrikeData(&strikeData);
+            if (!strikeData.empty()) {
+                SkAssertResult(client.readStrikeData(strikeData.data(), strikeData.size()));
+            }
+            discardableManager->unlockAndDeleteAll();
+        }
+    }
+
+    void onDelayedSetup() override {
+        auto stream = fDataProvider();
+        fTrace = SkTextBlobTrace::CreateBlobTrace(stream.get());
+    }
+
+public:
+    RemoteGlyphCacheLoopbackBench(SkString n,
+                                  std::function<std::unique_ptr<SkStreamAsset>()> f)
+        : fBenchName(std::move(n)), fDataProvider(std::move(f)) {}
+};
 }  // namespace
 
 Benchmark* CreateDiffCanvasBench(
@@ -254,3 +301,7 @@ Benchmark* CreateDiffCanvasBench(
 DEF_BENCH( return CreateDiffCanvasBench(
         SkString("SkDiffBench-lorem_ipsum"),
         [](){ return GetResourceAsStream("diff_canvas_traces/lorem_ipsum.trace"); }));
+
+DEF_BENCH( return new RemoteGlyphCacheLoopbackBench(
+        SkString("SkRemoteGlyphCacheLoopback-lorem_ipsum"),
+        [](){ return GetResourceAsStream("diff_canvas_traces/lorem_ipsum.trace"); }));
@@ -124,6 +124,8 @@ static DEFINE_string(zoom, "1.0,0",
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+static DEFINE_bool(recordOpts, false,
+                   "Also draw SKPs once per experimental SkRecordOpts pass run over them?");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 static DEFINE_bool(gpuStatsDump, false, "Dump GPU states after each benchmark to json");
@@ -806,6 +808,25 @@ public:
             return new DeserializePictureBench(name.c_str(), std::move(data));
         }
 
+        // With --recordOpts, draw all .skps as RecordOptsBenches, once per pass.
+        while (FLAGS_recordOpts &&
+               fCurrentRecordOpts < fSKPs.count() * RecordOptsBench::kPassCount) {
+            const int skp  = fCurrentRecordOpts / RecordOptsBench::kPassCount,
+                      pass = fCurrentRecordOpts % RecordOptsBench::kPassCount;
+            fCurrentRecordOpts++;
+            sk_sp<SkPicture> pic = ReadPicture(fSKPs[skp].c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(fSKPs[skp].c_str());
+            fSourceType = "skp";
+            fBenchType  = "recordopts";
+            fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
+            fSKPOps   = pic->approximateOpCount();
+            return new RecordOptsBench(name.c_str(), pic.get(),
+                                       static_cast<RecordOptsBench::Pass>(pass));
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -1114,6 +1135,7 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
     int fCurrentDeserialPicture = 0;
+    int fCurrentRecordOpts = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
     int fCurrentSVG = 0;
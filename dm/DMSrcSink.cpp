@@ -1359,6 +1359,7 @@ MSKPSrc::MSKPSrc(Path path) : fPath(path) {
     std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(fPath.c_str());
     int count = SkMultiPictureDocumentReadPageCount(stream.get());
     if (count > 0) {
+        fIndexed = SkMultiPictureDocumentIsIndexed(stream.get());
         fPages.reset(count);
         (void)SkMultiPictureDocumentReadPageSizes(stream.get(), &fPages[0], fPages.count());
     }
@@ -1387,7 +1388,10 @@ Result MSKPSrc::draw(int i, GrDirectContext*, SkCanvas* canvas) const {
         if (!stream) {
             return Result::Fatal("Unable to open file: %s", fPath.c_str());
         }
-        if (!SkMultiPictureDocumentRead(stream.get(), &fPages[0], fPages.count())) {
+        // Pages of an indexed document are read as they're drawn. Any page of an older one
+        // means reading them all, so we keep them all.
+        if (fIndexed ? !SkMultiPictureDocumentReadPage(stream.get(), i, &fPages[i])
+                     : !SkMultiPictureDocumentRead(stream.get(), &fPages[0], fPages.count())) {
             return Result::Fatal("SkMultiPictureDocument reader failed on page %d: %s", i,
                                  fPath.c_str());
         }
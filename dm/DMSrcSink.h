@@ -365,6 +365,7 @@ public:
 
 private:
     Path fPath;
+    bool fIndexed = false;
     mutable SkTArray<SkDocumentPage> fPages;
 };
 
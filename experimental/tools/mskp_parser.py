@@ -27,31 +27,51 @@ if magic != magic_constant:
   sys.stderr.write('Not a mskp file: "%s"\n' % mskp_src)
   exit(2)
 
-version, page_count = struct.unpack('II', src.read(8))[:2]
+# Version 3 writes each page's skp after the header, then a table of where each
+# starts, the page count, and a tag to tell the document was finished.
+# Version 2 writes the page count and sizes after the header, then one skp.
+end_of_file_tag = struct.unpack('>I', b'mpde')[0]
+
+version, = struct.unpack('<I', src.read(4))
 print('MSKP version: ', version)
-print('page count: ', page_count)
-if version > 2 or version < 1:
-  #TODO(halcanary): Remove support for version 1.
+if version == 3:
+  src.seek(-8, 2)
+  trailer_start = src.tell()
+  page_count, end_of_file = struct.unpack('<II', src.read(8))
+  if end_of_file != end_of_file_tag:
+    sys.stderr.write('unfinished mskp file\n')
+    exit(3)
+  table_start = trailer_start - 16 * page_count
+  src.seek(table_start)
+elif version == 2:
+  page_count, = struct.unpack('<I', src.read(4))
+else:
   sys.stderr.write('unsupported mskp version\n')
   exit(3)
+print('page count: ', page_count)
+
 offsets = []
 for page in range(page_count):
   print('page %3d\t' % page, end='')
-  if version == 1:
-    offset, size_x, size_y =struct.unpack('Qff', src.read(16))
+  if version == 3:
+    size_x, size_y, offset = struct.unpack('<ffQ', src.read(16))
     print('offset = %-7d\t' % offset, end='')
     offsets.append(offset)
-  elif version == 2:
-    size_x, size_y =struct.unpack('ff', src.read(8))
+  else:
+    size_x, size_y = struct.unpack('<ff', src.read(8))
   print('size = (%r,%r)' % (size_x, size_y))
 
 if len(sys.argv) >= 3:
   with open(sys.argv[2], 'wb') as o:
-    if version == 2 or len(offsets) < 2:
+    if version == 2:
+      # The whole document is one skp, with the pages drawn one after another.
       while True:
         file_buffer = src.read(8192)
         if 0 == len(file_buffer):
           break
         o.write(file_buffer)
-    else:
-      o.write(src.read(offsets[1] - offsets[0]))
+    elif page_count > 0:
+      # Just the first page.
+      end = offsets[1] if page_count > 1 else table_start
+      src.seek(offsets[0])
+      o.write(src.read(end - offsets[0]))
@@ -131,6 +131,22 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Image filter results drawn through raster canvases are cached per SkImageFilter object, so
+     *  a filter rebuilt each frame with the same parameters never finds the previous frame's
+     *  result. With content keys enabled, results are instead keyed by the filter's parameters,
+     *  inputs, and the images and pictures it references, and are shared by all equal filters.
+     *  Off by default. Returns the previous setting.
+     */
+    static bool SetImageFilterCacheContentKeys(bool useContentKeys);
+
+    /**
+     *  The number of lookups in the raster image filter cache that found, or did not find, a
+     *  cached result since the process started.
+     */
+    static int64_t GetImageFilterCacheHitCount();
+    static int64_t GetImageFilterCacheMissCount();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
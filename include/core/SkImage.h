@@ -25,6 +25,7 @@
 
 class SkData;
 class SkCanvas;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageGenerator;
@@ -1219,6 +1220,29 @@ public:
                                   const SkIRect& clipBounds, SkIRect* outSubset,
                                   SkIPoint* offset) const;
 
+    /** Creates filtered SkImage from a raster SkImage, like makeWithFilter() above, but evaluates
+        filter over clipBounds in tiles of at most tileSize by tileSize pixels. Images created
+        while filtering are sized to a tile, plus whatever margin filter reads around it, rather
+        than to clipBounds, so peak memory for large outputs is much lower. If executor is
+        non-null, tiles are filtered in parallel on it.
+
+        Returns nullptr if SkImage is texture backed, if tileSize is not positive, or under the
+        same conditions as makeWithFilter() above.
+
+        @param filter      image filter DAG applied to SkImage
+        @param subset      bounds of SkImage processed by filter
+        @param clipBounds  expected bounds of filtered SkImage
+        @param outSubset   storage for returned SkImage bounds
+        @param offset      storage for returned SkImage translation
+        @param tileSize    maximum width and height of each tile
+        @param executor    optional executor to filter tiles on
+        @return            filtered SkImage, or nullptr
+    */
+    sk_sp<SkImage> makeWithFilter(const SkImageFilter* filter, const SkIRect& subset,
+                                  const SkIRect& clipBounds, SkIRect* outSubset,
+                                  SkIPoint* offset, int tileSize,
+                                  SkExecutor* executor = nullptr) const;
+
     /** Defines a callback function, taking one parameter of type GrBackendTexture with
         no return value. Function is called when back-end texture is to be released.
     */
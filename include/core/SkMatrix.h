@@ -1545,6 +1545,30 @@ public:
         this->mapPoints(dst, 4);
     }
 
+    /** Sets each dst[i] to the bounds of src[i] corners mapped by SkMatrix, for count rects.
+        Equivalent to calling mapRect(&dst[i], src[i]) for each rect, but affine matrices map
+        the whole array at once with the widest SIMD the CPU supports.
+
+        src and dst may point to the same storage.
+
+        @param dst    storage for bounds of mapped rects; may be src
+        @param src    rects to map
+        @param count  number of rects to map
+    */
+    void mapRects(SkRect dst[], const SkRect src[], int count) const;
+
+    /** Maps the four corners of each of count rects in src, as mapRectToQuad() would, storing
+        the corners of src[i] in dst[4 * i] through dst[4 * i + 3]. The whole array of corners
+        is mapped in one mapPoints() call.
+
+        @param dst    storage for 4 * count mapped corners; must not overlap src
+        @param src    rects to map
+        @param count  number of rects to map
+
+        Note: like mapRectToQuad(), this does not perform perspective clipping.
+    */
+    void mapRectsToQuads(SkPoint dst[], const SkRect src[], int count) const;
+
     /** Sets dst to bounds of src corners mapped by SkMatrix. If matrix contains
         elements other than scale or translate: asserts if SK_DEBUG is defined;
         otherwise, results are undefined.
@@ -243,6 +243,11 @@ private:
         bool textBlobsOnly=false) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
                                            class SkTypefacePlayback*);
+    // Holds a serialized picture that needs no custom procs, and parses it on first playback.
+    // Returns null if the picture's tags and sizes don't fit in the data.
+    static sk_sp<SkPicture> MakeLazyFromData(sk_sp<SkData>, int approxOpCount);
+    // Reads past a serialized picture that needs no custom procs, checking only its structure.
+    static bool SkipStream(SkStream*);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
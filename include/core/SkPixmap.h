@@ -668,6 +668,31 @@ public:
     */
     bool scalePixels(const SkPixmap& dst, SkFilterQuality filterQuality) const;
 
+    /** \enum SkPixmap::ResampleFilter
+        Separable filters for scalePixels(), roughly in order of increasing sharpness and cost.
+        When reducing, each is widened to cover every source pixel that maps to a destination
+        pixel, so unlike SkFilterQuality they do not alias at any scale.
+    */
+    enum class ResampleFilter {
+        kTriangle,   //!< linear interpolation; an area average when reducing
+        kMitchell,   //!< cubic with B = C = 1/3; smooth, little ringing
+        kCatmullRom, //!< cubic with B = 0, C = 1/2; sharper than kMitchell
+        kLanczos3,   //!< sinc windowed to three lobes; sharpest, with some ringing
+    };
+
+    /** Copies SkPixmap to dst, scaling pixels to fit dst.width() and dst.height() with filter,
+        and converting pixels to match dst.colorType(), dst.alphaType() and dst.colorSpace()
+        as readPixels() does. If linear is true and SkPixmap has a color space, pixels are
+        filtered in that color space's linear gamma. Large dst are filled on the default
+        SkExecutor, if there is one.
+
+        @param dst     SkImageInfo and pixel address to write to
+        @param filter  separable filter to scale with
+        @param linear  whether to filter linear rather than encoded values
+        @return        true if pixels are scaled to fit dst
+    */
+    bool scalePixels(const SkPixmap& dst, ResampleFilter filter, bool linear = false) const;
+
     /** Writes color to pixels bounded by subset; returns true on success.
         Returns false if colorType() is kUnknown_SkColorType, or if subset does
         not intersect bounds().
@@ -12,6 +12,8 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkTypeface.h"
 
+class SkExecutor;
+
 /**
  *  A serial-proc is asked to serialize the specified object (e.g. picture or image).
  *  If a data object is returned, it will be used (even if it is zero-length).
@@ -67,6 +69,12 @@ struct SK_API SkDeserialProcs {
 
     SkDeserialTypefaceProc  fTypefaceProc = nullptr;
     void*                   fTypefaceCtx = nullptr;
+
+    // If set, pictures decode their images, typefaces and sub-pictures concurrently on this
+    // executor, so the procs above must be safe to call from several threads at once. Only the
+    // top-level picture waits on it, so it need not allow borrowing unless that picture is itself
+    // deserialized on one of its threads.
+    SkExecutor*             fExecutor = nullptr;
 };
 
 #endif
@@ -430,6 +430,10 @@ private:
     friend class SkPaintPriv;      // GetDefaultTypeface
     friend class SkFont;           // getGlyphToUnicodeMap
 
+    /** The second half of MakeDeserialize(), once the descriptor has been read. */
+    static sk_sp<SkTypeface> MakeFromDescriptor(SkFontDescriptor*);
+    friend class SkPictureData;    // MakeFromDescriptor
+
 private:
     SkFontID            fUniqueID;
     SkFontStyle         fStyle;
@@ -11,6 +11,10 @@
 #include "include/private/SkTArray.h"
 #include "include/private/SkTDArray.h"
 
+#include <memory>
+
+class SkExecutor;
+class SkOpScratch;
 class SkPath;
 struct SkRect;
 
@@ -81,6 +85,57 @@ bool SK_API TightBounds(const SkPath& path, SkRect* result);
   */
 bool SK_API AsWinding(const SkPath& path, SkPath* result);
 
+/** Set result to the union (kUnion_SkPathOp) or intersection (kIntersect_SkPathOp) of
+    count paths. Operands are grouped spatially: paths whose bounds do not touch are resolved
+    as independent clusters, each as a balanced tree of pairwise ops, and the disjoint results
+    are merged. This scales to thousands of operands where repeated pairwise ops do not.
+
+    Returns true if operation was able to produce a result;
+    otherwise, result is unmodified.
+
+    @param paths The operands.
+    @param count The number of operands.
+    @param op kUnion_SkPathOp or kIntersect_SkPathOp; other operators fail.
+    @param result The product of the operands. The result may be one of the inputs.
+    @param executor If not null, independent clusters are resolved on this executor.
+    @return True if the operation succeeded.
+  */
+bool SK_API BulkOp(const SkPath paths[], int count, SkPathOp op, SkPath* result,
+                   SkExecutor* executor = nullptr);
+
+/** Scratch memory for path operations that is reused from one call to the next. Ops run
+    through a context carve their contours, segments, spans, and curve intersection state out
+    of arenas that are rewound rather than freed; once the arenas have grown to fit the
+    workload, a batch of ops no longer reaches the heap for them.
+
+    A context is not thread safe. Keep one per thread.
+  */
+class SK_API SkOpContext {
+public:
+    SkOpContext();
+    ~SkOpContext();
+
+    /** Same as Op(), using this context's scratch memory. */
+    bool op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
+
+    /** Same as Simplify(), using this context's scratch memory. */
+    bool simplify(const SkPath& path, SkPath* result);
+
+    struct Stats {
+        int    fOpCount;        //!< ops and simplifies run through this context
+        int    fArenaGrowths;   //!< times a scratch arena outgrew its block and used the heap
+        size_t fBytesReserved;  //!< scratch memory currently retained by this context
+    };
+
+    Stats stats() const;
+
+    /** Releases the retained scratch memory and clears the stats. */
+    void reset();
+
+private:
+    std::unique_ptr<SkOpScratch> fScratch;
+};
+
 /** Perform a series of path operations, optimized for unioning many paths together.
   */
 class SK_API SkOpBuilder {
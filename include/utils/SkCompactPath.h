@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompactPath_DEFINED
+#define SkCompactPath_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+/**
+ *  A read-only, lossy, compact encoding of an SkPath, for clients that keep very many points
+ *  resident and only occasionally iterate or draw them.
+ *
+ *  Points are quantized to 16-bit fixed point relative to the path's bounds (so the error is
+ *  at most half of bounds.width() / 65535 horizontally, likewise vertically), then stored as
+ *  variable-length deltas from the previous point. Verbs are stored as runs. Conic weights are
+ *  kept exactly. A typical polyline needs two to four bytes per point instead of eight.
+ *
+ *  The encoding is decoded in a streaming fashion by Iter, or all at once by toPath().
+ */
+class SK_API SkCompactPath {
+public:
+    SkCompactPath() = default;
+
+    /**
+     *  Encodes the path. Returns an empty SkCompactPath if the path is not finite.
+     */
+    static SkCompactPath Make(const SkPath& path);
+
+    /** Decodes the whole path. */
+    SkPath toPath() const;
+
+    bool isEmpty() const { return fVerbCount == 0; }
+    const SkRect& getBounds() const { return fBounds; }
+    SkPathFillType getFillType() const { return fFillType; }
+    int countVerbs() const { return fVerbCount; }
+    int countPoints() const { return fPointCount; }
+
+    /** Returns the number of bytes of encoded storage, excluding sizeof(SkCompactPath). */
+    size_t approximateBytesUsed() const { return fData ? fData->size() : 0; }
+
+    /**
+     *  Decodes the verbs and points one segment at a time, without materializing the path.
+     *  Like SkPath::RawIter, pts[0] is the segment's start point for every verb but kMove,
+     *  and kClose does not return a line back to the contour's start.
+     */
+    class SK_API Iter {
+    public:
+        explicit Iter(const SkCompactPath&);
+
+        /**
+         *  Returns false once every verb has been returned. Otherwise sets verb and fills pts
+         *  with up to four points. weight is set for kConic.
+         */
+        bool next(SkPathVerb* verb, SkPoint pts[4], SkScalar* weight);
+
+    private:
+        SkPoint decodePoint();
+
+        const uint8_t* fVerbs;
+        const uint8_t* fVerbsStop;
+        const uint8_t* fPoints;
+        const uint8_t* fWeights;
+        SkPathVerb     fRunVerb;
+        uint32_t       fRunRemaining;
+        uint16_t       fLastX, fLastY;
+        SkPoint        fLastPt;
+        SkPoint        fOrigin;
+        SkVector       fScale;
+    };
+
+private:
+    sk_sp<SkData>  fData;
+    SkRect         fBounds = SkRect::MakeEmpty();
+    uint32_t       fVerbBytes = 0;
+    uint32_t       fPointBytes = 0;
+    int            fVerbCount = 0;
+    int            fPointCount = 0;
+    int            fConicCount = 0;
+    SkPathFillType fFillType = SkPathFillType::kWinding;
+};
+
+#endif
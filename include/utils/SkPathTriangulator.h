@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathTriangulator_DEFINED
+#define SkPathTriangulator_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "include/private/SkMutex.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkExecutor;
+class SkPath;
+
+/**
+ *  Converts filled paths into indexed triangle meshes on the CPU, for clients that render the
+ *  geometry elsewhere. The triangulation is the same one the GPU backend uses for paths it
+ *  tessellates, and does not require a GPU context.
+ *
+ *  An SkPathTriangulator keeps its scratch memory between calls, so reusing one object for many
+ *  paths avoids most allocation. It is not safe to use one SkPathTriangulator from more than one
+ *  thread at a time.
+ */
+class SK_API SkPathTriangulator {
+public:
+    /** Default tolerance, in path units, for flattening curves into line segments. */
+    static constexpr SkScalar kDefaultTolerance = 0.25f;
+
+    /**
+     *  If executor is non-null, contours of a path that cannot affect one another's fill (their
+     *  bounds do not overlap) are split into groups and triangulated on the executor in parallel.
+     *  The executor must outlive the SkPathTriangulator.
+     */
+    explicit SkPathTriangulator(SkExecutor* executor = nullptr);
+    ~SkPathTriangulator();
+
+    struct Mesh {
+        /** Unique vertex positions. */
+        std::vector<SkPoint>  fVertices;
+        /** Three entries per triangle, each indexing fVertices. */
+        std::vector<uint32_t> fIndices;
+
+        int triangleCount() const { return (int)(fIndices.size() / 3); }
+    };
+
+    /**
+     *  Triangulates the fill of path, replacing the contents of mesh. Curves are flattened to
+     *  within tolerance. clipBounds only matters for inverse fill types, where it bounds the
+     *  area outside the path that gets triangulated.
+     *
+     *  Returns false, leaving mesh empty, if the path or tolerance is not finite. A path that
+     *  fills no area returns true with an empty mesh.
+     */
+    bool triangulate(const SkPath& path, const SkRect& clipBounds, Mesh* mesh,
+                     SkScalar tolerance = kDefaultTolerance);
+
+    /** As above, using the path's own bounds as the clip for inverse fill types. */
+    bool triangulate(const SkPath& path, Mesh* mesh, SkScalar tolerance = kDefaultTolerance);
+
+private:
+    struct Scratch;
+
+    std::unique_ptr<Scratch> acquireScratch();
+    void releaseScratch(std::unique_ptr<Scratch>);
+    void triangulateContours(const SkPath&, const SkRect& clipBounds, SkScalar tolerance, Mesh*);
+
+    SkExecutor* const                     fExecutor;
+    // Scratch is checked out by each task for the duration of one contour group.
+    SkMutex                               fScratchMutex;
+    std::vector<std::unique_ptr<Scratch>> fFreeScratch;
+};
+
+#endif
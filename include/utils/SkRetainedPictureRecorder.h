@@ -0,0 +1,93 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRetainedPictureRecorder_DEFINED
+#define SkRetainedPictureRecorder_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include <cstdint>
+#include <memory>
+
+class SkBBHFactory;
+class SkCanvas;
+
+/**
+ *  Records a picture every frame, like SkPictureRecorder, but keeps keyed groups of drawing from
+ *  one frame to the next, so that parts of a scene that haven't changed needn't be re-recorded.
+ *
+ *  Each frame, between beginRecording() and finishRecordingAsPicture(), the caller draws each
+ *  group with drawGroup(key). If that returns false, the group has no valid recording, and the
+ *  caller records it between beginGroup() and endGroup(). Groups nest: drawGroup() and
+ *  beginGroup() draw into whichever group is being recorded, or into the frame.
+ *
+ *  A group stays valid until invalidate() is called with its key or the key of any group drawn
+ *  inside it, or until a frame is finished without drawing it, directly or inside another group.
+ *
+ *  Each group is recorded as its own picture, with its own bounding box hierarchy if the frame has
+ *  an SkBBHFactory, and drawn into the frame as a nested picture. So a frame only builds a
+ *  hierarchy over its groups and the drawing between them, and reused groups bring theirs along.
+ */
+class SK_API SkRetainedPictureRecorder {
+public:
+    SkRetainedPictureRecorder();
+    ~SkRetainedPictureRecorder();
+
+    /**
+     *  Starts recording a frame. bounds and bbhFactory are as for SkPictureRecorder; bbhFactory,
+     *  if set, must outlive the frame, and is also used for each group recorded in it.
+     */
+    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr);
+
+    /**
+     *  If the group recorded under key is still valid, draws it into the recording canvas and
+     *  returns true. Otherwise returns false; the caller should then record it with beginGroup().
+     */
+    bool drawGroup(uint64_t key);
+
+    /**
+     *  Starts recording the group for key, replacing any recording it had, and returns the canvas
+     *  to draw it with. Drawing outside bounds is undefined, as for a picture's cull rect. The
+     *  canvas starts out with an identity matrix and no clip; the group is drawn under the matrix
+     *  and clip of the canvas it's drawn into, when endGroup() is called.
+     */
+    SkCanvas* beginGroup(uint64_t key, const SkRect& bounds);
+
+    /** Finishes recording the innermost group, and draws it. */
+    void endGroup();
+
+    /** Marks the group for key, and every group it's drawn inside, as needing recording. */
+    void invalidate(uint64_t key);
+
+    /** Marks every group as needing recording. */
+    void invalidateAll();
+
+    /**
+     *  Finishes the frame, ending any groups still being recorded, and returns its picture. Groups
+     *  that weren't drawn in this frame are dropped.
+     */
+    sk_sp<SkPicture> finishRecordingAsPicture();
+
+    struct Stats {
+        int fGroupsReused = 0;    // groups drawn from a recording made in an earlier frame
+        int fGroupsRecorded = 0;  // groups recorded this frame
+        int fGroupsRetained = 0;  // valid groups kept for the next frame
+    };
+    /** Stats for the frame being recorded, or the last one finished. */
+    Stats stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> fImpl;
+
+    SkRetainedPictureRecorder(SkRetainedPictureRecorder&&) = delete;
+    SkRetainedPictureRecorder& operator=(SkRetainedPictureRecorder&&) = delete;
+};
+
+#endif
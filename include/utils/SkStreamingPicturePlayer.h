@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingPicturePlayer_DEFINED
+#define SkStreamingPicturePlayer_DEFINED
+
+#include "include/core/SkRect.h"
+#include "include/core/SkSerialProcs.h"
+
+#include <memory>
+
+class SkCanvas;
+class SkStreamAsset;
+
+/**
+ *  Plays a serialized picture straight from its stream, without holding all of it in memory the
+ *  way a picture made with SkPicture::MakeFromStream() does.
+ *
+ *  The ops are read and played a window at a time. The paints, paths, text blobs, vertices,
+ *  images and nested pictures they use are read from the stream when an op first needs them, and
+ *  kept while they fit in a memory budget along with the window, the least recently used going
+ *  first. A resource that doesn't fit the budget by itself is still read for each op that uses it.
+ *
+ *  Making a player reads through the picture once, to find where each resource is; each playback
+ *  then seeks to what it needs. The typefaces, and a few words of bookkeeping for each resource,
+ *  stay in memory throughout. Nested pictures are resources like any other, read whole.
+ *
+ *  Only pictures whose nested pictures are indexed, as this version of Skia writes them, can be
+ *  played this way. A player isn't safe to use from several threads at once.
+ */
+class SK_API SkStreamingPicturePlayer {
+public:
+    struct Options {
+        size_t fMemoryBudget = 64 << 20;    // For the op window and the resources kept.
+        size_t fOpWindowBytes = 256 << 10;  // How much op data to read at a time.
+
+        // These must outlive the player.
+        SkDeserialProcs fProcs;
+    };
+
+    /**
+     *  Returns a player for the picture in stream, or nullptr if it isn't a picture that can be
+     *  played this way.
+     */
+    static std::unique_ptr<SkStreamingPicturePlayer> Make(std::unique_ptr<SkStreamAsset> stream,
+                                                          const Options&);
+    static std::unique_ptr<SkStreamingPicturePlayer> Make(std::unique_ptr<SkStreamAsset> stream);
+
+    ~SkStreamingPicturePlayer();
+
+    SkRect cullRect() const;
+
+    /**
+     *  Plays the picture into canvas. Returns false if the stream couldn't be read or turned out
+     *  to be corrupt part way, after drawing the ops before that. Resources are kept from one
+     *  playback to the next, so playing tiles of a picture one after another reads less.
+     */
+    bool playback(SkCanvas* canvas);
+
+    struct Stats {
+        size_t fPeakBytes = 0;       // most held at once, by the op window and loaded resources
+        int    fWindowsRead = 0;     // windows of op data read
+        int    fResourcesLoaded = 0;
+        int    fResourcesEvicted = 0;
+    };
+    /** Stats for every playback so far. */
+    Stats stats() const;
+
+private:
+    class Impl;
+    explicit SkStreamingPicturePlayer(std::unique_ptr<Impl>);
+
+    std::unique_ptr<Impl> fImpl;
+};
+
+#endif
@@ -103,6 +103,7 @@ void SkArenaAlloc::ensureSpace(uint32_t size, uint32_t alignment) {
     }
 
     char* newBlock = new char[allocationSize];
+    fHeapBytesAllocated += allocationSize;
 
     auto previousDtor = fDtorCursor;
     fCursor = newBlock;
@@ -72,6 +72,9 @@ public:
 
     ~SkArenaAlloc();
 
+    // The number of bytes requested from the heap because the initial block was exhausted.
+    size_t heapBytesAllocated() const { return fHeapBytesAllocated; }
+
     template <typename T, typename... Args>
     T* make(Args&&... args) {
         uint32_t size      = ToU32(sizeof(T));
@@ -244,6 +247,8 @@ private:
     // That makes the nth allocation fib(n) * fFirstHeapAllocationSize bytes.
     uint32_t fNextHeapAlloc,     // How many bytes minimum will we allocate next from the heap?
     fYetNextHeapAlloc;           // And then how many the next allocation after that?
+
+    size_t fHeapBytesAllocated = 0;
 };
 
 class SkArenaAllocWithReset : public SkArenaAlloc {
@@ -290,7 +290,12 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    // Images whose pixels stay resident get their levels built as they are sampled. Others
+    // build them all now, rather than keep a decoded copy alive to build from later.
+    SkPixmap pixmap;
+    SkMipmap* mipmap = image->peekPixels(&pixmap)
+            ? SkMipmap::BuildLazy(src, get_fact(localCache))
+            : SkMipmap::Build(src, get_fact(localCache));
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
@@ -20,6 +20,10 @@ static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
     sk_sp<const SkMipmap> mips = image->refMips();
     if (!mips) {
         mips.reset(SkMipmapCache::FindAndRef(SkBitmapCacheDesc::Make(image)));
+        SkBitmap base;
+        if (mips && mips->needsBase() && image->getROPixels(nullptr, &base)) {
+            mips->setBase(base);
+        }
     }
     if (!mips) {
         mips.reset(SkMipmapCache::AddAndRef(image));
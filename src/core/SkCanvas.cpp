@@ -38,6 +38,7 @@
 #include "src/core/SkPaintPriv.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkSpecialSurfacePool.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkTextFormatParams.h"
@@ -1025,7 +1026,8 @@ void SkCanvas::DrawDeviceWithFilter(SkBaseDevice* src, const SkImageFilter* filt
     layerTargetBounds.offset(-layerInputBounds.fLeft, -layerInputBounds.fTop);
     SkMatrix filterCTM = layerMatrix;
     filterCTM.postTranslate(-layerInputBounds.fLeft, -layerInputBounds.fTop);
-    skif::Context ctx(filterCTM, layerTargetBounds, nullptr, colorType, colorSpace, special.get());
+    skif::Context ctx(filterCTM, layerTargetBounds, nullptr, colorType, colorSpace, special.get(),
+                      SkSpecialSurfacePool::Get());
 
     SkIPoint offset;
     special = as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset);
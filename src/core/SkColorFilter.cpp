@@ -54,6 +54,22 @@ bool SkColorFilterBase::onAsAColorMatrix(float matrix[20]) const {
     return false;
 }
 
+sk_sp<SkColorFilter> SkColorFilterBase::onMakeComposed(const SkColorFilterBase&) const {
+    return nullptr;
+}
+
+bool SkColorFilterBase::onAsComponentTables(const uint8_t*[4]) const {
+    return false;
+}
+
+sk_sp<SkColorFilter> SkColorFilterBase::makeComposedWith(const SkColorFilterBase& inner) const {
+    return this->onMakeComposed(inner);
+}
+
+bool SkColorFilterBase::asComponentTables(const uint8_t* tables[4]) const {
+    return this->onAsComponentTables(tables);
+}
+
 #if SK_SUPPORT_GPU
 GrFPResult SkColorFilterBase::asFragmentProcessor(std::unique_ptr<GrFragmentProcessor> inputFP,
                                                   GrRecordingContext* context,
@@ -129,6 +145,14 @@ public:
                fOuter->appendStages(rec, innerIsOpaque);
     }
 
+    sk_sp<SkColorFilter> onMakeComposed(const SkColorFilterBase& next) const override {
+        // (outer o inner) o next == outer o (inner o next), when inner can absorb next.
+        if (sk_sp<SkColorFilter> folded = fInner->makeComposedWith(next)) {
+            return fOuter->makeComposed(std::move(folded));
+        }
+        return nullptr;
+    }
+
     skvm::Color onProgram(skvm::Builder* p, skvm::Color c,
                           SkColorSpace* dstCS,
                           skvm::Uniforms* uniforms, SkArenaAlloc* alloc) const override {
@@ -193,6 +217,9 @@ sk_sp<SkColorFilter> SkColorFilter::makeComposed(sk_sp<SkColorFilter> inner) con
     if (!inner) {
         return sk_ref_sp(this);
     }
+    if (sk_sp<SkColorFilter> folded = as_CFB(this)->makeComposedWith(*as_CFB(inner))) {
+        return folded;
+    }
 
     return sk_sp<SkColorFilter>(new SkComposeColorFilter(sk_ref_sp(this), std::move(inner)));
 }
@@ -54,6 +54,19 @@ public:
                                            const GrColorInfo& dstColorInfo) const;
 #endif
 
+    /**
+     *  Returns a single filter equivalent to this(inner(...)), or null if this filter cannot
+     *  absorb inner. makeComposed() asks before building a compose filter, so that a chain of
+     *  color matrices, or of tables, costs one stage per pixel rather than one per link.
+     */
+    sk_sp<SkColorFilter> makeComposedWith(const SkColorFilterBase& inner) const;
+
+    /**
+     *  If this filter looks up each unpremultiplied component in a table of 256 bytes, returns
+     *  true and sets tables[] to the A, R, G and B tables, leaving null those it leaves unchanged.
+     */
+    bool asComponentTables(const uint8_t* tables[4]) const;
+
     bool affectsTransparentBlack() const {
         return this->filterColor(SK_ColorTRANSPARENT) != SK_ColorTRANSPARENT;
     }
@@ -80,6 +93,8 @@ protected:
 
     virtual bool onAsAColorMatrix(float[20]) const;
     virtual bool onAsAColorMode(SkColor* color, SkBlendMode* bmode) const;
+    virtual sk_sp<SkColorFilter> onMakeComposed(const SkColorFilterBase& inner) const;
+    virtual bool onAsComponentTables(const uint8_t* tables[4]) const;
 
 private:
     virtual bool onAppendStages(const SkStageRec& rec, bool shaderIsOpaque) const = 0;
@@ -59,12 +59,60 @@ sk_sp<SkFlattenable> SkColorFilter_Matrix::CreateProc(SkReadBuffer& buffer) {
 }
 
 bool SkColorFilter_Matrix::onAsAColorMatrix(float matrix[20]) const {
+    // An HSLA matrix is not a color matrix; applied to RGBA it would mean something else.
+    if (fDomain != Domain::kRGBA) {
+        return false;
+    }
     if (matrix) {
         memcpy(matrix, fMatrix, 20 * sizeof(float));
     }
     return true;
 }
 
+// The range of row j of matrix over unpremultiplied inputs in [0,1].
+static void row_range(const float matrix[20], int j, float* lo, float* hi) {
+    *lo = *hi = matrix[4 + j*5];
+    for (int i = 0; i < 4; ++i) {
+        const float m = matrix[i + j*5];
+        *(m < 0 ? lo : hi) += m;
+    }
+}
+
+sk_sp<SkColorFilter> SkColorFilter_Matrix::onMakeComposed(const SkColorFilterBase& inner) const {
+    float in[20];
+    if (fDomain != Domain::kRGBA || !inner.asAColorMatrix(in)) {
+        return nullptr;
+    }
+
+    // Each matrix clamps its result, and between the two the color is premultiplied and then
+    // unpremultiplied again. One matrix can stand in for both only where neither step matters:
+    // the inner results must already lie in [0,1], and wherever the inner alpha can reach 0
+    // (which loses the color), our alpha must come out 0 regardless of that color.
+    for (int j = 0; j < 4; ++j) {
+        float lo, hi;
+        row_range(in, j, &lo, &hi);
+        if (lo < -SK_ScalarNearlyZero || hi > 1 + SK_ScalarNearlyZero) {
+            return nullptr;
+        }
+        if (j == 3 && lo <= 0 && (fMatrix[15] != 0 || fMatrix[16] != 0 || fMatrix[17] != 0 ||
+                                  fMatrix[19] != 0)) {
+            return nullptr;
+        }
+    }
+
+    float folded[20];
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 5; ++i) {
+            float sum = i == 4 ? fMatrix[4 + j*5] : 0;
+            for (int k = 0; k < 4; ++k) {
+                sum += fMatrix[k + j*5] * in[i + k*5];
+            }
+            folded[i + j*5] = sum;
+        }
+    }
+    return SkColorFilters::Matrix(folded);
+}
+
 bool SkColorFilter_Matrix::onAppendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
     const bool willStayOpaque = shaderIsOpaque && (fFlags & kAlphaUnchanged_Flag),
                          hsla = fDomain == Domain::kHSLA;
@@ -28,6 +28,7 @@ public:
 private:
     void flatten(SkWriteBuffer&) const override;
     bool onAsAColorMatrix(float matrix[20]) const override;
+    sk_sp<SkColorFilter> onMakeComposed(const SkColorFilterBase& inner) const override;
 
     SK_FLATTENABLE_HOOKS(SkColorFilter_Matrix)
 
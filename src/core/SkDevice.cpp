@@ -26,6 +26,7 @@
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkSpecialSurfacePool.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "src/core/SkUtils.h"
@@ -352,7 +353,7 @@ void SkBaseDevice::drawFilteredImage(const skif::Mapping& mapping, SkSpecialImag
     // filter's filterImage(ctx) function returns.
     sk_sp<SkImageFilterCache> cache(this->getImageFilterCache());
     skif::Context ctx(mapping, targetOutput, cache.get(), colorType, this->imageInfo().colorSpace(),
-                      skif::FilterResult<For::kInput>(sk_ref_sp(src)));
+                      skif::FilterResult<For::kInput>(sk_ref_sp(src)), SkSpecialSurfacePool::Get());
 
     SkIPoint offset;
     sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset);
@@ -7,10 +7,17 @@
 
 #include "include/core/SkImageFilter.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkTypeface.h"
 #include "include/effects/SkComposeImageFilter.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkSafe32.h"
+#include "include/private/SkTHash.h"
 #include "src/core/SkFuzzLogging.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -19,6 +26,8 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkSpecialSurfacePool.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -158,7 +167,8 @@ static int32_t next_image_filter_unique_id() {
 SkImageFilter_Base::SkImageFilter_Base(sk_sp<SkImageFilter> const* inputs,
                                        int inputCount, const CropRect* cropRect)
         : fUsesSrcInput(false)
-        , fUniqueID(next_image_filter_unique_id()) {
+        , fUniqueID(next_image_filter_unique_id())
+        , fContentID(0) {
     fCropRect = cropRect ? *cropRect : CropRect(SkRect(), 0x0);
 
     fInputs.reset(inputCount);
@@ -175,6 +185,52 @@ SkImageFilter_Base::~SkImageFilter_Base() {
     SkImageFilterCache::Get()->purgeByImageFilter(this);
 }
 
+static sk_sp<SkData> serialize_unique_id(uint32_t uniqueID) {
+    return SkData::MakeWithCopy(&uniqueID, sizeof(uniqueID));
+}
+
+// Maps flattened filter DAGs to content IDs. IDs are never handed out twice, so dropping the
+// whole map when it gets large only costs cache misses for filters that have not yet asked.
+static uint32_t content_id_for(const sk_sp<SkData>& flattened) {
+    static constexpr int kMaxContentIDs = 4096;
+    static SkMutex mutex;
+    static SkTHashMap<SkString, uint32_t>* contentIDs = new SkTHashMap<SkString, uint32_t>;
+
+    SkString key(static_cast<const char*>(flattened->data()), flattened->size());
+    SkAutoMutexExclusive lock(mutex);
+    if (uint32_t* id = contentIDs->find(key)) {
+        return *id;
+    }
+    if (contentIDs->count() >= kMaxContentIDs) {
+        contentIDs->reset();
+    }
+    return *contentIDs->set(std::move(key), next_image_filter_unique_id());
+}
+
+uint32_t SkImageFilter_Base::contentID() const {
+    uint32_t id = fContentID.load(std::memory_order_relaxed);
+    if (id) {
+        return id;
+    }
+
+    SkSerialProcs procs;
+    procs.fImageProc = [](SkImage* image, void*) { return serialize_unique_id(image->uniqueID()); };
+    procs.fPictureProc = [](SkPicture* picture, void*) {
+        return serialize_unique_id(picture->uniqueID());
+    };
+    procs.fTypefaceProc = [](SkTypeface* typeface, void*) {
+        return serialize_unique_id(typeface->uniqueID());
+    };
+    SkBinaryWriteBuffer buffer;
+    buffer.setSerialProcs(procs);
+    buffer.writeFlattenable(this);
+
+    // Racing threads intern the same bytes, so they agree on the ID.
+    id = content_id_for(buffer.snapshotAsData());
+    fContentID.store(id, std::memory_order_relaxed);
+    return id;
+}
+
 bool SkImageFilter_Base::Common::unflatten(SkReadBuffer& buffer, int expectedCount) {
     const int count = buffer.readInt();
     if (!buffer.validate(count >= 0)) {
@@ -237,8 +293,11 @@ skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImage(const skif::Con
     const SkIRect srcSubset = fUsesSrcInput ? context.sourceImage()->subset()
                                             : SkIRect::MakeWH(0, 0);
 
-    SkImageFilterCacheKey key(fUniqueID, context.mapping().layerMatrix(), context.clipBounds(),
-                              srcGenID, srcSubset);
+    // Content-keyed results may be shared by other filters, so they are not tied to this one.
+    uint32_t contentID = context.cache() && context.cache()->usesContentKeys()
+            ? this->contentID() : 0;
+    SkImageFilterCacheKey key(contentID ? contentID : fUniqueID, context.mapping().layerMatrix(),
+                              context.clipBounds(), srcGenID, srcSubset);
     if (context.cache() && context.cache()->get(key, &result)) {
         return result;
     }
@@ -250,12 +309,77 @@ skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImage(const skif::Con
     }
 
     if (context.cache()) {
-        context.cache()->set(key, this, result);
+        context.cache()->set(key, contentID ? nullptr : this, result);
     }
 
     return result;
 }
 
+skif::FilterResult<For::kOutput> SkImageFilter_Base::filterImageTiled(
+        const skif::Context& context, int tileSize, SkExecutor* executor) const {
+    const SkIRect& outputBounds = context.clipBounds();
+    if (!context.isValid() || context.gpuBacked() || tileSize <= 0 ||
+        (outputBounds.width() <= tileSize && outputBounds.height() <= tileSize)) {
+        return this->filterImage(context);
+    }
+
+    // Raster special surfaces are always N32, so the assembled output matches what filterImage()
+    // would have produced.
+    SkBitmap output;
+    if (!output.tryAllocPixels(SkImageInfo::MakeN32Premul(outputBounds.size(),
+                                                          context.refColorSpace()))) {
+        return {};
+    }
+
+    const int tilesX = (outputBounds.width()  + tileSize - 1) / tileSize,
+              tilesY = (outputBounds.height() + tileSize - 1) / tileSize;
+    auto filterTile = [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH(outputBounds.x() + (i % tilesX) * tileSize,
+                                         outputBounds.y() + (i / tilesX) * tileSize,
+                                         tileSize, tileSize);
+        SkAssertResult(tile.intersect(outputBounds));
+        SkPixmap dst;
+        SkAssertResult(output.pixmap().extractSubset(&dst,
+                                                     tile.makeOffset(-outputBounds.topLeft())));
+        dst.erase(SK_ColorTRANSPARENT);
+
+        // The cache is dropped, along with every intermediate it holds, once the tile is done.
+        sk_sp<SkImageFilterCache> cache(
+                SkImageFilterCache::Create(SkImageFilterCache::kDefaultTransientSize));
+        skif::Context tileContext = context.withNewDesiredOutput(skif::LayerSpace<SkIRect>(tile))
+                                           .withNewCache(cache.get());
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result = this->filterImage(tileContext).imageAndOffset(&offset);
+        SkBitmap pixels;
+        if (!result || !result->getROPixels(&pixels)) {
+            return;
+        }
+        SkIRect resultBounds = SkIRect::MakeXYWH(offset.x(), offset.y(),
+                                                 result->width(), result->height());
+        SkPixmap dstSubset;
+        if (resultBounds.intersect(tile) &&
+            dst.extractSubset(&dstSubset, resultBounds.makeOffset(-tile.topLeft()))) {
+            pixels.readPixels(dstSubset, resultBounds.x() - offset.x(),
+                              resultBounds.y() - offset.y());
+        }
+    };
+
+    const int tileCount = tilesX * tilesY;
+    if (executor) {
+        SkTaskGroup(*executor).batch(tileCount, filterTile);
+    } else {
+        for (int i = 0; i < tileCount; ++i) {
+            filterTile(i);
+        }
+    }
+
+    output.setImmutable();
+    return skif::FilterResult<For::kOutput>(
+            SkSpecialImage::MakeFromRaster(SkIRect::MakeSize(outputBounds.size()), output,
+                                           context.surfaceProps()),
+            skif::LayerSpace<SkIPoint>(outputBounds.topLeft()));
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getInputBounds(
         const skif::Mapping& mapping, const skif::DeviceSpace<SkIRect>& desiredOutput,
         const skif::ParameterSpace<SkRect>* knownContentBounds) const {
@@ -670,6 +794,7 @@ SkIRect SkImageFilter_Base::DetermineRepeatedSrcBound(const SkIRect& srcBounds,
 
 void SkImageFilter_Base::PurgeCache() {
     SkImageFilterCache::Get()->purge();
+    SkSpecialSurfacePool::Get()->purge();
 }
 
 static sk_sp<SkImageFilter> apply_ctm_to_filter(sk_sp<SkImageFilter> input, const SkMatrix& ctm,
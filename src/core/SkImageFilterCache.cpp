@@ -7,8 +7,10 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include <atomic>
 #include <vector>
 
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkRefCnt.h"
 #include "include/private/SkMutex.h"
@@ -30,7 +32,8 @@ namespace {
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes, bool useContentKeys)
+            : fMaxBytes(maxBytes), fCurrentBytes(0), fUseContentKeys(useContentKeys) { }
     ~CacheImpl() override {
         fLookup.foreach([&](Value* v) { delete v; });
     }
@@ -62,8 +65,10 @@ public:
             }
 
             *result = v->fImage;
+            fHits++;
             return true;
         }
+        fMisses++;
         return false;
     }
 
@@ -77,10 +82,12 @@ public:
         fLookup.add(v);
         fLRU.addToHead(v);
         fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
+        if (filter) {
+            if (auto* values = fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                fImageFilterValues.set(filter, {v});
+            }
         }
 
         while (fCurrentBytes > fMaxBytes) {
@@ -117,6 +124,20 @@ public:
         fImageFilterValues.remove(filter);
     }
 
+    bool usesContentKeys() const override { return fUseContentKeys; }
+
+    void setUseContentKeys(bool useContentKeys) override { fUseContentKeys = useContentKeys; }
+
+    Stats stats() const override {
+        SkAutoMutexExclusive mutex(fMutex);
+        Stats stats;
+        stats.fHits = fHits;
+        stats.fMisses = fMisses;
+        stats.fCount = fLookup.count();
+        stats.fBytesUsed = fCurrentBytes;
+        return stats;
+    }
+
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
     void removeInternal(Value* v) {
@@ -146,13 +167,16 @@ private:
     SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
     size_t                                                fMaxBytes;
     size_t                                                fCurrentBytes;
+    std::atomic<bool>                                     fUseContentKeys;
+    mutable int64_t                                       fHits = 0;
+    mutable int64_t                                       fMisses = 0;
     mutable SkMutex                                       fMutex;
 };
 
 } // namespace
 
-SkImageFilterCache* SkImageFilterCache::Create(size_t maxBytes) {
-    return new CacheImpl(maxBytes);
+SkImageFilterCache* SkImageFilterCache::Create(size_t maxBytes, bool useContentKeys) {
+    return new CacheImpl(maxBytes, useContentKeys);
 }
 
 SkImageFilterCache* SkImageFilterCache::Get() {
@@ -162,3 +186,18 @@ SkImageFilterCache* SkImageFilterCache::Get() {
     once([]{ cache = SkImageFilterCache::Create(kDefaultCacheSize); });
     return cache;
 }
+
+bool SkGraphics::SetImageFilterCacheContentKeys(bool useContentKeys) {
+    SkImageFilterCache* cache = SkImageFilterCache::Get();
+    bool previous = cache->usesContentKeys();
+    cache->setUseContentKeys(useContentKeys);
+    return previous;
+}
+
+int64_t SkGraphics::GetImageFilterCacheHitCount() {
+    return SkImageFilterCache::Get()->stats().fHits;
+}
+
+int64_t SkGraphics::GetImageFilterCacheMissCount() {
+    return SkImageFilterCache::Get()->stats().fMisses;
+}
@@ -47,18 +47,34 @@ struct SkImageFilterCacheKey {
 };
 
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to result
-// NOTE: this is the _specific_ unique ID of the image filter, so refiltering the same image with a
-// copy of the image filter (with exactly the same parameters) will not yield a cache hit.
+// NOTE: by default this is the _specific_ unique ID of the image filter, so refiltering the same
+// image with a copy of the image filter (with exactly the same parameters) will not yield a cache
+// hit. A cache that uses content keys is instead keyed by SkImageFilter_Base::contentID(), which is
+// shared by every filter DAG that flattens to the same parameters, inputs, and images.
 class SkImageFilterCache : public SkRefCnt {
 public:
     SK_USE_FLUENT_IMAGE_FILTER_TYPES_IN_CLASS
 
     enum { kDefaultTransientSize = 32 * 1024 * 1024 };
 
+    struct Stats {
+        int64_t fHits = 0;
+        int64_t fMisses = 0;
+        int     fCount = 0;
+        size_t  fBytesUsed = 0;
+    };
+
     ~SkImageFilterCache() override {}
-    static SkImageFilterCache* Create(size_t maxBytes);
+    static SkImageFilterCache* Create(size_t maxBytes, bool useContentKeys = false);
     static SkImageFilterCache* Get();
 
+    // Content-keyed results are not tied to the filter that produced them: they are set with a
+    // null filter and stay in the cache until evicted or purged.
+    virtual bool usesContentKeys() const = 0;
+    virtual void setUseContentKeys(bool) = 0;
+    // Lookup counts since the cache was created, and its current contents.
+    virtual Stats stats() const = 0;
+
     // Returns true on cache hit and updates 'result' to be the cached result. Returns false when
     // not in the cache, in which case 'result' is not modified.
     virtual bool get(const SkImageFilterCacheKey& key,
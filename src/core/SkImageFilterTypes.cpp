@@ -9,6 +9,7 @@
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkSpecialSurfacePool.h"
 
 // Both [I]Vectors and Sk[I]Sizes are transformed as non-positioned values, i.e. go through
 // mapVectors() not mapPoints().
@@ -26,6 +27,19 @@ static SkVector map_as_vector(SkScalar x, SkScalar y, const SkMatrix& matrix) {
 
 namespace skif {
 
+sk_sp<SkSpecialSurface> Context::makeSurface(const SkISize& size,
+                                             const SkSurfaceProps* props) const {
+    if (fSurfacePool && !fSource.image()->isTextureBacked()) {
+        // Like SkSpecialImage::makeSurface(), raster intermediates are always N32.
+        return fSurfacePool->makeRaster(SkImageInfo::Make(size, kN32_SkColorType,
+                                                          kPremul_SkAlphaType,
+                                                          sk_ref_sp(fColorSpace)),
+                                        props);
+    }
+    return fSource.image()->makeSurface(fColorType, fColorSpace, size,
+                                        kPremul_SkAlphaType, props);
+}
+
 Mapping Mapping::DecomposeCTM(const SkMatrix& ctm, const SkImageFilter* filter,
                               const skif::ParameterSpace<SkPoint>& representativePoint) {
     SkMatrix remainder, layer;
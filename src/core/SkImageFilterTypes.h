@@ -16,6 +16,7 @@ class GrRecordingContext;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkSpecialSurface;
+class SkSpecialSurfacePool;
 class SkSurfaceProps;
 
 // The skif (SKI[mage]F[ilter]) namespace contains types that are used for filter implementations.
@@ -597,23 +598,26 @@ public:
     // Creates a context with the given layer matrix and destination clip, reading from 'source'
     // with an origin of (0,0).
     Context(const SkMatrix& layerMatrix, const SkIRect& clipBounds, SkImageFilterCache* cache,
-            SkColorType colorType, SkColorSpace* colorSpace, const SkSpecialImage* source)
+            SkColorType colorType, SkColorSpace* colorSpace, const SkSpecialImage* source,
+            SkSpecialSurfacePool* surfacePool = nullptr)
         : fMapping(SkMatrix::I(), layerMatrix)
         , fDesiredOutput(clipBounds)
         , fCache(cache)
         , fColorType(colorType)
         , fColorSpace(colorSpace)
-        , fSource(sk_ref_sp(source), LayerSpace<SkIPoint>({0, 0})) {}
+        , fSource(sk_ref_sp(source), LayerSpace<SkIPoint>({0, 0}))
+        , fSurfacePool(surfacePool) {}
 
     Context(const Mapping& mapping, const LayerSpace<SkIRect>& desiredOutput,
             SkImageFilterCache* cache, SkColorType colorType, SkColorSpace* colorSpace,
-            const FilterResult<For::kInput>& source)
+            const FilterResult<For::kInput>& source, SkSpecialSurfacePool* surfacePool = nullptr)
         : fMapping(mapping)
         , fDesiredOutput(desiredOutput)
         , fCache(cache)
         , fColorType(colorType)
         , fColorSpace(colorSpace)
-        , fSource(source) {}
+        , fSource(source)
+        , fSurfacePool(surfacePool) {}
 
     // The mapping that defines the transformation from local parameter space of the filters to the
     // layer space where the image filters are evaluated, as well as the remaining transformation
@@ -636,6 +640,9 @@ public:
     // The cache to use when recursing through the filter DAG, in order to avoid repeated
     // calculations of the same image.
     SkImageFilterCache* cache() const { return fCache; }
+    // Where raster intermediates get their pixels, so they can be recycled rather than
+    // reallocated. Null allocates each one anew.
+    SkSpecialSurfacePool* surfacePool() const { return fSurfacePool; }
     // The output device's color type, which can be used for intermediate images to be
     // compatible with the eventual target of the filtered result.
     SkColorType colorType() const { return fColorType; }
@@ -677,18 +684,22 @@ public:
     // as closely as possible, and uses the same backend of the device that produced the source
     // image.
     sk_sp<SkSpecialSurface> makeSurface(const SkISize& size,
-                                        const SkSurfaceProps* props = nullptr) const {
-        return fSource.image()->makeSurface(fColorType, fColorSpace, size,
-                                            kPremul_SkAlphaType, props);
-    }
+                                        const SkSurfaceProps* props = nullptr) const;
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
-        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource,
+                       fSurfacePool);
     }
     // Create a new context that matches this context, but with an overridden desired output rect.
     Context withNewDesiredOutput(const LayerSpace<SkIRect>& desiredOutput) const {
-        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource,
+                       fSurfacePool);
+    }
+    // Create a new context that matches this context, but with an overridden cache.
+    Context withNewCache(SkImageFilterCache* cache) const {
+        return Context(fMapping, fDesiredOutput, cache, fColorType, fColorSpace, fSource,
+                       fSurfacePool);
     }
 
 private:
@@ -700,6 +711,7 @@ private:
     // is bounded by the device, so this can be a bare pointer.
     SkColorSpace*             fColorSpace;
     FilterResult<For::kInput> fSource;
+    SkSpecialSurfacePool*     fSurfacePool;
 };
 
 } // end namespace skif
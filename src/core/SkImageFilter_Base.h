@@ -16,8 +16,11 @@
 
 #include "src/core/SkImageFilterTypes.h"
 
+#include <atomic>
+
 class GrFragmentProcessor;
 class GrRecordingContext;
+class SkExecutor;
 
 // True base class that all SkImageFilter implementations need to extend from. This provides the
 // actual API surface that Skia will use to compute the filtered images.
@@ -41,6 +44,21 @@ public:
      */
     skif::FilterResult<For::kOutput> filterImage(const skif::Context& context) const;
 
+    /**
+     *  Like filterImage(), but for raster contexts the DAG is evaluated once per tile of the
+     *  context's desired output, with each tile as the desired output of its own evaluation. The
+     *  input bounds each node requests of its children add the halo that node needs, so every
+     *  intermediate image is sized to a tile plus its halo rather than to the whole output. Only
+     *  the final image covers the full desired output.
+     *
+     *  Each tile gets its own transient cache, so nodes that are reused within the DAG are still
+     *  evaluated once per tile; the context's cache is not used. If 'executor' is non-null, tiles
+     *  are evaluated on it in parallel. GPU-backed contexts, and outputs no larger than one tile,
+     *  are evaluated by filterImage() directly.
+     */
+    skif::FilterResult<For::kOutput> filterImageTiled(const skif::Context& context, int tileSize,
+                                                      SkExecutor* executor) const;
+
     /**
      *  Calculate the smallest-possible required layer bounds that would provide sufficient
      *  information to correctly compute the image filter for every pixel in the desired output
@@ -150,6 +168,12 @@ public:
 
     uint32_t uniqueID() const { return fUniqueID; }
 
+    // Like uniqueID(), but shared by every filter DAG that flattens to the same bytes, with the
+    // images, pictures, and typefaces it references standing in by their unique IDs. The two kinds
+    // of ID are drawn from the same sequence, so they never collide in the cache. Computed on
+    // first use.
+    uint32_t contentID() const;
+
 protected:
     class Common {
     public:
@@ -413,6 +437,7 @@ private:
     bool fUsesSrcInput;
     CropRect fCropRect;
     uint32_t fUniqueID; // Globally unique
+    mutable std::atomic<uint32_t> fContentID; // 0 until contentID() is first called
 
     using INHERITED = SkImageFilter;
 };
@@ -15,6 +15,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <cmath>
 #include <climits>
@@ -869,6 +870,32 @@ static void direct_blur_y(ToA8 toA8, const int strideOf8,
     }
 }
 
+// Big masks are blurred in strips, rows for one pass and columns for the other, on the default
+// executor. Strips share memory only at their edges, and are long enough that the per-strip
+// setup is lost in the noise.
+static constexpr int     kMinStripSize      = 64;
+static constexpr int     kMaxStrips         = 16;
+static constexpr int64_t kMinParallelPixels = 256 * 256;
+
+static int strip_count(int count, int64_t pixels) {
+    if (pixels < kMinParallelPixels) {
+        return 1;
+    }
+    return SkTPin(count / kMinStripSize, 1, kMaxStrips);
+}
+
+// Calls fn(begin, end, strip) for each of 'strips' even slices of [0, count).
+template <typename Fn>
+static void for_each_strip(int count, int strips, Fn&& fn) {
+    if (strips <= 1) {
+        fn(0, count, 0);
+        return;
+    }
+    SkTaskGroup().batch(strips, [&](int i) {
+        fn(SkToInt((int64_t)count * i / strips), SkToInt((int64_t)count * (i + 1) / strips), i);
+    });
+}
+
 static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMask* dst) {
     SkASSERT(sigmaX == sigmaY); // TODO
     SkASSERT(0.01 <= sigmaX && sigmaX < 2);
@@ -915,39 +942,35 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
 
     //TODO: handle bluring in only one direction.
 
-    // Blur vertically and copy to destination.
+    // Blur vertically and copy to destination. Columns are blurred in groups of eight, so the
+    // strips split the columns on group boundaries.
+    ToA8* toA8;
+    int strideOf8;
     switch (src.fFormat) {
-        case SkMask::kBW_Format:
-            direct_blur_y(bw_to_a8, 1,
-                          radiusY, gaussFactorsY,
-                          src.fImage, srcRB, srcW, srcH,
-                          dst->fImage + radiusX, dstRB);
-            break;
-        case SkMask::kA8_Format:
-            direct_blur_y(nullptr, 8,
-                          radiusY, gaussFactorsY,
-                          src.fImage, srcRB, srcW, srcH,
-                          dst->fImage + radiusX, dstRB);
-            break;
-        case SkMask::kARGB32_Format:
-            direct_blur_y(argb32_to_a8, 32,
-                          radiusY, gaussFactorsY,
-                          src.fImage, srcRB, srcW, srcH,
-                          dst->fImage + radiusX, dstRB);
-            break;
-        case SkMask::kLCD16_Format:
-            direct_blur_y(lcd_to_a8, 16, radiusY, gaussFactorsY,
-                          src.fImage, srcRB, srcW, srcH,
-                          dst->fImage + radiusX, dstRB);
-            break;
+        case SkMask::kBW_Format:     toA8 = bw_to_a8;     strideOf8 =  1; break;
+        case SkMask::kA8_Format:     toA8 = nullptr;      strideOf8 =  8; break;
+        case SkMask::kARGB32_Format: toA8 = argb32_to_a8; strideOf8 = 32; break;
+        case SkMask::kLCD16_Format:  toA8 = lcd_to_a8;    strideOf8 = 16; break;
         default:
             SK_ABORT("Unhandled format.");
     }
+    const int64_t dstPixels = (int64_t)dstW * dstH;
+    const int groupCount = (srcW + 7) / 8;
+    for_each_strip(groupCount, strip_count(srcW, dstPixels), [&](int begin, int end, int) {
+        int x = begin * 8;
+        direct_blur_y(toA8, strideOf8,
+                      radiusY, gaussFactorsY,
+                      src.fImage + begin * strideOf8, srcRB, std::min(end * 8, srcW) - x, srcH,
+                      dst->fImage + radiusX + x, dstRB);
+    });
 
     // Blur horizontally in place.
-    direct_blur_x(radiusX, gaussFactorsX,
-                  dst->fImage + radiusX,  dstRB, srcW,
-                  dst->fImage,            dstRB, dstW, dstH);
+    for_each_strip(dstH, strip_count(dstH, dstPixels), [&](int begin, int end, int) {
+        uint8_t* rows = dst->fImage + begin * dstRB;
+        direct_blur_x(radiusX, gaussFactorsX,
+                      rows + radiusX, dstRB, srcW,
+                      rows,           dstRB, dstW, end - begin);
+    });
 
     return {radiusX, radiusY};
 }
@@ -985,68 +1008,82 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
-
     // Blur both directions.
     int tmpW = srcH,
         tmpH = dstW;
 
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
+    // Every strip gets its own scan buffers.
+    const int64_t dstPixels = (int64_t)dstW * dstH;
+    const int stripsW = strip_count(srcH, dstPixels),
+              stripsH = strip_count(tmpH, dstPixels);
+    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
+    auto buffers = alloc.makeArrayDefault<uint32_t>(bufferSize * std::max(stripsW, stripsH));
+
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        default:
-            SK_ABORT("Unhandled format.");
-    }
+    for_each_strip(srcH, stripsW, [&](int yBegin, int yEnd, int strip) {
+        const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffers + strip * bufferSize);
+        switch (src.fFormat) {
+            case SkMask::kBW_Format: {
+                const uint8_t* bwStart = src.fImage + yBegin * src.fRowBytes;
+                auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
+                auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
+                for (int y = yBegin; y < yEnd;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kA8_Format: {
+                const uint8_t* a8Start = src.fImage + yBegin * src.fRowBytes;
+                auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
+                auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
+                for (int y = yBegin; y < yEnd;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kARGB32_Format: {
+                const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(
+                        src.fImage + yBegin * src.fRowBytes);
+                auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
+                auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
+                for (int y = yBegin; y < yEnd;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kLCD16_Format: {
+                const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(
+                        src.fImage + yBegin * src.fRowBytes);
+                auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
+                auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
+                for (int y = yBegin; y < yEnd;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            default:
+                SK_ABORT("Unhandled format.");
+        }
+    });
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    for_each_strip(tmpH, stripsH, [&](int yBegin, int yEnd, int strip) {
+        const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffers + strip * bufferSize);
+        for (int y = yBegin; y < yEnd; y++) {
+            auto tmpStart = &tmp[y * tmpW];
+            auto dstStart = &dst->fImage[y];
+
+            scanH.blur(tmpStart, tmpStart + tmpW,
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+        }
+    });
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -16,6 +16,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkPathPriv.h"
 
 #include <cstddef>
@@ -964,6 +965,7 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
                          const SkPoint src[], int count) {
     SkASSERT(m.hasPerspective());
 
+#ifdef SK_LEGACY_MATRIX_MATH_ORDER
     if (count > 0) {
         do {
             SkScalar sy = src->fY;
@@ -972,11 +974,7 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
 
             SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
             SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
-#ifdef SK_LEGACY_MATRIX_MATH_ORDER
             SkScalar z = sx * m.fMat[kMPersp0] + (sy * m.fMat[kMPersp1] + m.fMat[kMPersp2]);
-#else
-            SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
-#endif
             if (z) {
                 z = 1 / z;
             }
@@ -986,35 +984,14 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
             dst += 1;
         } while (--count);
     }
+#else
+    SkOpts::map_persp_points(m, dst, src, count);
+#endif
 }
 
 void SkMatrix::Affine_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() != SkMatrix::kPerspective_Mask);
-    if (count > 0) {
-        SkScalar tx = m.getTranslateX();
-        SkScalar ty = m.getTranslateY();
-        SkScalar sx = m.getScaleX();
-        SkScalar sy = m.getScaleY();
-        SkScalar kx = m.getSkewX();
-        SkScalar ky = m.getSkewY();
-        if (count & 1) {
-            dst->set(src->fX * sx + src->fY * kx + tx,
-                     src->fX * ky + src->fY * sy + ty);
-            src += 1;
-            dst += 1;
-        }
-        Sk4s trans4(tx, ty, tx, ty);
-        Sk4s scale4(sx, sy, sx, sy);
-        Sk4s  skew4(kx, ky, kx, ky);    // applied to swizzle of src4
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
-            Sk4s src4 = Sk4s::Load(src);
-            Sk4s swz4 = SkNx_shuffle<1,0,3,2>(src4);  // y0 x0, y1 x1
-            (src4 * scale4 + swz4 * skew4 + trans4).store(dst);
-            src += 2;
-            dst += 2;
-        }
-    }
+    SkOpts::map_affine_points(m, dst, src, count);
 }
 
 const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
@@ -1081,22 +1058,8 @@ void SkMatrix::mapHomogeneousPoints(SkPoint3 dst[], const SkPoint src[], int cou
         for (int i = 0; i < count; ++i) {
             dst[i] = { src[i].fX, src[i].fY, 1 };
         }
-    } else if (this->hasPerspective()) {
-        for (int i = 0; i < count; ++i) {
-            dst[i] = {
-                fMat[0] * src[i].fX + fMat[1] * src[i].fY + fMat[2],
-                fMat[3] * src[i].fX + fMat[4] * src[i].fY + fMat[5],
-                fMat[6] * src[i].fX + fMat[7] * src[i].fY + fMat[8],
-            };
-        }
-    } else {    // affine
-        for (int i = 0; i < count; ++i) {
-            dst[i] = {
-                fMat[0] * src[i].fX + fMat[1] * src[i].fY + fMat[2],
-                fMat[3] * src[i].fX + fMat[4] * src[i].fY + fMat[5],
-                1,
-            };
-        }
+    } else {
+        SkOpts::map_homogeneous_points(*this, dst, src, count);
     }
 }
 
@@ -1175,6 +1138,31 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src, SkApplyPerspectiveClip pc
     }
 }
 
+void SkMatrix::mapRects(SkRect dst[], const SkRect src[], int count) const {
+    SkASSERT((dst && src && count > 0) || 0 == count);
+
+    if (this->isScaleTranslate()) {
+        for (int i = 0; i < count; ++i) {
+            this->mapRectScaleTranslate(&dst[i], src[i]);
+        }
+    } else if (this->hasPerspective()) {
+        for (int i = 0; i < count; ++i) {
+            this->mapRect(&dst[i], src[i]);
+        }
+    } else {
+        SkOpts::map_affine_rects(*this, dst, src, count);
+    }
+}
+
+void SkMatrix::mapRectsToQuads(SkPoint dst[], const SkRect src[], int count) const {
+    SkASSERT((dst && src && count > 0) || 0 == count);
+
+    for (int i = 0; i < count; ++i) {
+        src[i].toQuad(&dst[4 * i]);
+    }
+    this->mapPoints(dst, 4 * count);
+}
+
 SkScalar SkMatrix::mapRadius(SkScalar radius) const {
     SkVector    vec[2];
 
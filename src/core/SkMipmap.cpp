@@ -6,16 +6,25 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkPixelRef.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkHalf.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkNx.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "include/private/SkVx.h"
+#include "include/third_party/skcms/skcms.h"
+#include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
+#include "src/core/SkTaskGroup.h"
+#include <memory>
 #include <new>
+#include <vector>
 
 //
 // ColorTypeFilter is the "Type" we pass to some downsample template functions.
@@ -103,11 +112,11 @@ struct ColorTypeFilter_88 {
 
 struct ColorTypeFilter_1616 {
     typedef uint32_t Type;
-    static uint64_t Expand(uint32_t x) {
+    static uint64_t Expand(uint64_t x) {
         return (x & 0xFFFF) | ((x & ~0xFFFF) << 16);
     }
-    static uint16_t Compact(uint64_t x) {
-        return (x & 0xFFFF) | ((x >> 16) & ~0xFFFF);
+    static uint32_t Compact(uint64_t x) {
+        return (x & 0xFFFF) | ((x >> 16) & 0xFFFF0000);
     }
 };
 
@@ -381,6 +390,83 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+// Averaging in linear light decodes the src rows of each dst row to 16-bit linear 16161616,
+// filters those with the 16161616 procs, and encodes the filtered row back to 8888. Alpha is
+// widened and narrowed without decoding.
+class LinearLight {
+public:
+    LinearLight(const skcms_TransferFunction& tf, bool premul) : fPremul(premul) {
+        float prev = 0;
+        for (int i = 0; i < 256; ++i) {
+            float linear = SkTPin(skcms_TransferFunction_eval(&tf, i * (1 / 255.0f)), 0.0f, 1.0f);
+            fToLinear[i] = (uint16_t)sk_float_round2int(linear * 65535);
+            if (i > 0) {
+                fThresholds[i - 1] = sk_float_round2int((prev + linear) * (65535 / 2.0f));
+            }
+            prev = linear;
+        }
+        fThresholds[255] = 0x10000;  // Never below any value, so the search stops at 255.
+
+        int e = 0;
+        for (int bucket = 0; bucket < kBuckets; ++bucket) {
+            while (fThresholds[e] < (uint32_t)(bucket << kBucketShift)) {
+                e++;
+            }
+            fBucketStart[bucket] = (uint8_t)e;
+        }
+    }
+
+    void decode(uint64_t dst[], const uint32_t src[], int count) const {
+        auto s = reinterpret_cast<const uint8_t*>(src);
+        auto d = reinterpret_cast<uint16_t*>(dst);
+        for (int i = 0; i < 4*count; i += 4) {
+            d[i + 0] = fToLinear[s[i + 0]];
+            d[i + 1] = fToLinear[s[i + 1]];
+            d[i + 2] = fToLinear[s[i + 2]];
+            d[i + 3] = s[i + 3] * 257;
+        }
+    }
+
+    void encode(uint32_t dst[], const uint64_t src[], int count) const {
+        auto s = reinterpret_cast<const uint16_t*>(src);
+        auto d = reinterpret_cast<uint8_t*>(dst);
+        for (int i = 0; i < 4*count; i += 4) {
+            auto a = (uint8_t)((s[i + 3] + 128) / 257);
+            for (int c = 0; c < 3; ++c) {
+                uint8_t e = this->nearestEncoding(s[i + c]);
+                d[i + c] = fPremul ? std::min(e, a) : e;
+            }
+            d[i + 3] = a;
+        }
+    }
+
+private:
+    static constexpr int kBucketShift = 4;
+    static constexpr int kBuckets     = 0x10000 >> kBucketShift;
+
+    // fThresholds[i] is the linear value halfway between encodings i and i+1, so the nearest
+    // encoding of a linear value is the number of thresholds below it. fBucketStart[] counts
+    // those below the start of each run of 16 linear values, leaving a step or two to take.
+    uint8_t nearestEncoding(uint32_t linear) const {
+        int e = fBucketStart[linear >> kBucketShift];
+        while (fThresholds[e] < linear) {
+            e++;
+        }
+        return (uint8_t)e;
+    }
+
+    uint16_t   fToLinear[256];
+    uint32_t   fThresholds[256];
+    uint8_t    fBucketStart[kBuckets];
+    const bool fPremul;
+};
+
+// Levels with at least this many pixels are filled in strips of rows on the default executor.
+// Each dst row reads its own src rows and nothing else, so the strips need no coordination.
+static constexpr int64_t kMinParallelPixels = 256 * 256;
+static constexpr int     kMinStripRows      = 32;
+static constexpr int     kMaxStrips         = 16;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
@@ -394,166 +480,184 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
+namespace {
+
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+// The filters for one color type, and how to use them to make each level from the one above it.
+class Downsampler {
+public:
+    // Returns false if src's color type cannot be mipmapped.
+    bool init(const SkPixmap& src, SkMipmap::Averaging averaging) {
+        switch (src.colorType()) {
+            case kRGBA_8888_SkColorType:
+            case kBGRA_8888_SkColorType:      this->setProcs<ColorTypeFilter_8888>();       break;
+            case kRGB_565_SkColorType:        this->setProcs<ColorTypeFilter_565>();        break;
+            case kARGB_4444_SkColorType:      this->setProcs<ColorTypeFilter_4444>();       break;
+            case kAlpha_8_SkColorType:
+            case kGray_8_SkColorType:         this->setProcs<ColorTypeFilter_8>();          break;
+            case kRGBA_F16Norm_SkColorType:
+            case kRGBA_F16_SkColorType:       this->setProcs<ColorTypeFilter_RGBA_F16>();   break;
+            case kR8G8_unorm_SkColorType:     this->setProcs<ColorTypeFilter_88>();         break;
+            case kR16G16_unorm_SkColorType:   this->setProcs<ColorTypeFilter_1616>();       break;
+            case kA16_unorm_SkColorType:      this->setProcs<ColorTypeFilter_16>();         break;
+            case kRGBA_1010102_SkColorType:
+            case kBGRA_1010102_SkColorType:   this->setProcs<ColorTypeFilter_1010102>();    break;
+            case kA16_float_SkColorType:      this->setProcs<ColorTypeFilter_Alpha_F16>();  break;
+            case kR16G16_float_SkColorType:   this->setProcs<ColorTypeFilter_F16F16>();     break;
+            case kR16G16B16A16_unorm_SkColorType:
+                                              this->setProcs<ColorTypeFilter_16161616>();   break;
+
+            case kUnknown_SkColorType:
+            case kRGB_888x_SkColorType:     // TODO: use 8888?
+            case kRGB_101010x_SkColorType:  // TODO: use 1010102?
+            case kBGR_101010x_SkColorType:  // TODO: use 1010102?
+            case kRGBA_F32_SkColorType:
+                return false;
+        }
+
+        if (averaging == SkMipmap::Averaging::kLinearLight &&
+            (src.colorType() == kRGBA_8888_SkColorType ||
+             src.colorType() == kBGRA_8888_SkColorType) &&
+            !(src.colorSpace() && src.colorSpace()->gammaIsLinear())) {
+            skcms_TransferFunction tf = *skcms_sRGB_TransferFunction();
+            if (src.colorSpace()) {
+                src.colorSpace()->transferFn(&tf);
+            }
+            fLinear = std::make_unique<LinearLight>(tf, src.alphaType() == kPremul_SkAlphaType);
+            this->setProcs<ColorTypeFilter_16161616>();
+        }
+        return true;
+    }
+
+    // Fills dst, which must be the level below src, from src.
+    void operator()(const SkPixmap& srcPM, const SkPixmap& dstPM) const {
+        int width = srcPM.width();
+        int height = srcPM.height();
+        FilterProc* proc;
+        const int srcRowsPerDst = (height & 1) ? (height == 1 ? 1 : 3) : 2;
+        if (height & 1) {
+            if (height == 1) {        // src-height is 1
+                if (width & 1) {      // src-width is 3
+                    proc = fProc_3_1;
+                } else {              // src-width is 2
+                    proc = fProc_2_1;
+                }
+            } else {                  // src-height is 3
+                if (width & 1) {
+                    if (width == 1) { // src-width is 1
+                        proc = fProc_1_3;
+                    } else {          // src-width is 3
+                        proc = fProc_3_3;
+                    }
+                } else {              // src-width is 2
+                    proc = fProc_2_3;
+                }
+            }
+        } else {                      // src-height is 2
+            if (width & 1) {
+                if (width == 1) {     // src-width is 1
+                    proc = fProc_1_2;
+                } else {              // src-width is 3
+                    proc = fProc_3_2;
+                }
+            } else {                  // src-width is 2
+                proc = fProc_2_2;
+            }
+        }
+        width = dstPM.width();
+        height = dstPM.height();
+
+        const char* srcBasePtr = (const char*)srcPM.addr();
+        char* dstBasePtr = (char*)dstPM.writable_addr();
+
+        const size_t srcRB = srcPM.rowBytes();
+        const size_t dstRB = dstPM.rowBytes();
+        const int srcWidth = srcPM.width();
+        const LinearLight* linear = fLinear.get();
+        auto downsampleRows = [&](int y0, int y1) {
+            // When averaging in linear light, the src rows are decoded into the front of
+            // scratch and the filtered row lands after them.
+            SkAutoTMalloc<uint64_t> scratch(linear ? (size_t)(srcRowsPerDst * srcWidth + width)
+                                                   : 0);
+            uint64_t* filtered = linear ? scratch.get() + srcRowsPerDst * srcWidth : nullptr;
+            for (int y = y0; y < y1; y++) {
+                const char* srcRow = srcBasePtr + srcRB * 2 * y;  // jump two rows
+                char* dstRow = dstBasePtr + dstRB * y;
+                if (!linear) {
+                    proc(dstRow, srcRow, srcRB, width);
+                    continue;
+                }
+                for (int r = 0; r < srcRowsPerDst; ++r) {
+                    linear->decode(scratch.get() + r * srcWidth,
+                                   (const uint32_t*)(srcRow + srcRB * r), srcWidth);
+                }
+                proc(filtered, scratch.get(), srcWidth * sizeof(uint64_t), width);
+                linear->encode((uint32_t*)dstRow, filtered, width);
+            }
+        };
+
+        int strips = 1;
+        if ((int64_t)width * height >= kMinParallelPixels) {
+            strips = SkTPin(height / kMinStripRows, 1, kMaxStrips);
+        }
+        if (strips == 1) {
+            downsampleRows(0, height);
+        } else {
+            SkTaskGroup().batch(strips, [&](int s) {
+                downsampleRows(height * s / strips, height * (s + 1) / strips);
+            });
+        }
+    }
+
+private:
+    template <typename F> void setProcs() {
+        fProc_1_2 = downsample_1_2<F>;
+        fProc_1_3 = downsample_1_3<F>;
+        fProc_2_1 = downsample_2_1<F>;
+        fProc_2_2 = downsample_2_2<F>;
+        fProc_2_3 = downsample_2_3<F>;
+        fProc_3_1 = downsample_3_1<F>;
+        fProc_3_2 = downsample_3_2<F>;
+        fProc_3_3 = downsample_3_3<F>;
+    }
+
+    FilterProc* fProc_1_2 = nullptr;
+    FilterProc* fProc_1_3 = nullptr;
+    FilterProc* fProc_2_1 = nullptr;
+    FilterProc* fProc_2_2 = nullptr;
+    FilterProc* fProc_2_3 = nullptr;
+    FilterProc* fProc_3_1 = nullptr;
+    FilterProc* fProc_3_2 = nullptr;
+    FilterProc* fProc_3_3 = nullptr;
+    std::unique_ptr<LinearLight> fLinear;
+};
+
+}  // namespace
+
+// Returns the number of bytes of pixels in all the levels below src, or 0 if there are none.
+static size_t levels_pixel_size(const SkPixmap& src, int countLevels) {
+    size_t size = 0;
+    for (int currentMipLevel = countLevels; currentMipLevel >= 0; currentMipLevel--) {
+        SkISize mipSize = SkMipmap::ComputeLevelSize(src.width(), src.height(), currentMipLevel);
+        size += SkColorTypeMinRowBytes(src.colorType(), mipSize.fWidth) * mipSize.fHeight;
+    }
+    return size;
+}
+
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
-
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
-
-    const SkColorType ct = src.colorType();
-    const SkAlphaType at = src.alphaType();
-
-    switch (ct) {
-        case kRGBA_8888_SkColorType:
-        case kBGRA_8888_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
-            break;
-        case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
-            break;
-        case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
-            break;
-        case kAlpha_8_SkColorType:
-        case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
-            break;
-        case kRGBA_F16Norm_SkColorType:
-        case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_RGBA_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
-            break;
-        case kR8G8_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_88>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_88>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_88>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_88>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_88>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_88>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_88>;
-            break;
-        case kR16G16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_1616>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_1616>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_1616>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1616>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1616>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_1616>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1616>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1616>;
-            break;
-        case kA16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_16>;
-            break;
-        case kRGBA_1010102_SkColorType:
-        case kBGRA_1010102_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_1010102>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_1010102>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_1010102>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1010102>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1010102>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_1010102>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1010102>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1010102>;
-            break;
-        case kA16_float_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_Alpha_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_Alpha_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_Alpha_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_Alpha_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_Alpha_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_Alpha_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_Alpha_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_Alpha_F16>;
-            break;
-        case kR16G16_float_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16F16>;
-            break;
-        case kR16G16B16A16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_16161616>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_16161616>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_16161616>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_16161616>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_16161616>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_16161616>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_16161616>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_16161616>;
-            break;
-
-        case kUnknown_SkColorType:
-        case kRGB_888x_SkColorType:     // TODO: use 8888?
-        case kRGB_101010x_SkColorType:  // TODO: use 1010102?
-        case kBGR_101010x_SkColorType:  // TODO: use 1010102?
-        case kRGBA_F32_SkColorType:
-            return nullptr;
+                          bool computeContents, Averaging averaging) {
+    Downsampler downsample;
+    if (!downsample.init(src, averaging)) {
+        return nullptr;
     }
 
     if (src.width() <= 1 && src.height() <= 1) {
         return nullptr;
     }
     // whip through our loop to compute the exact size needed
-    size_t size = 0;
     int countLevels = ComputeLevelCount(src.width(), src.height());
-    for (int currentMipLevel = countLevels; currentMipLevel >= 0; currentMipLevel--) {
-        SkISize mipSize = ComputeLevelSize(src.width(), src.height(), currentMipLevel);
-        size += SkColorTypeMinRowBytes(ct, mipSize.fWidth) * mipSize.fHeight;
-    }
+    size_t size = levels_pixel_size(src, countLevels);
 
     size_t storageSize = SkMipmap::AllocLevelsSize(countLevels, size);
     if (0 == storageSize) {
@@ -580,9 +684,6 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     Level* levels = mipmap->fLevels;
     uint8_t*    baseAddr = (uint8_t*)&levels[countLevels];
     uint8_t*    addr = baseAddr;
-    int         width = src.width();
-    int         height = src.height();
-    uint32_t    rowBytes;
     SkPixmap    srcPM(src);
 
     // Depending on architecture and other factors, the pixel data alignment may need to be as
@@ -590,61 +691,14 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     SkASSERT(SkIsAlign8((uintptr_t)addr));
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
-        width = std::max(1, width >> 1);
-        height = std::max(1, height >> 1);
-        rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
-
-        // We make the Info w/o any colorspace, since that storage is not under our control, and
-        // will not be deleted in a controlled fashion. When the caller is given the pixmap for
-        // a given level, we augment this pixmap with fCS (which we do manage).
-        new (&levels[i].fPixmap) SkPixmap(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
-        levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
-                                         SkIntToScalar(height) / src.height());
+        mipmap->initLevel(i, src, addr);
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-            }
+            downsample(srcPM, dstPM);
         }
         srcPM = dstPM;
-        addr += height * rowBytes;
+        addr += dstPM.height() * dstPM.rowBytes();
     }
     SkASSERT(addr == baseAddr + size);
 
@@ -652,6 +706,223 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     return mipmap;
 }
 
+void SkMipmap::initLevel(int index, const SkPixmap& src, void* addr) {
+    SkISize size = ComputeLevelSize(src.width(), src.height(), index);
+    uint32_t rowBytes = SkToU32(SkColorTypeMinRowBytes(src.colorType(), size.width()));
+
+    // We make the Info w/o any colorspace, since that storage is not under our control, and
+    // will not be deleted in a controlled fashion. When the caller is given the pixmap for
+    // a given level, we augment this pixmap with fCS (which we do manage).
+    new (&fLevels[index].fPixmap) SkPixmap(SkImageInfo::Make(size, src.colorType(),
+                                                             src.alphaType()),
+                                           addr, rowBytes);
+    fLevels[index].fScale  = SkSize::Make(SkIntToScalar(size.width())  / src.width(),
+                                          SkIntToScalar(size.height()) / src.height());
+}
+
+// The state of a mipmap whose levels are built on first use. A level that is not built (or
+// whose discardable memory was purged) has a null address in its pixmap.
+struct SkMipmap::LazyState {
+    SkMutex                                           fMutex;
+    Downsampler                                       fDownsample;
+    SkDiscardableFactoryProc                          fFactory = nullptr;
+    // Only held while something other than a cache owns the mipmap; see onDataChange().
+    SkBitmap                                          fBase;
+    // One of these holds the pixels of each built level, depending on fFactory.
+    std::vector<std::unique_ptr<SkDiscardableMemory>> fDiscardable;
+    std::vector<SkAutoFree>                           fMalloc;
+};
+
+SkMipmap::SkMipmap(void* malloc, size_t size) : INHERITED(malloc, size) {}
+SkMipmap::SkMipmap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+SkMipmap::~SkMipmap() = default;
+
+// Refs src's pixels, but not any mipmap attached to src, which may be the one holding dst.
+static void set_base(SkBitmap* dst, const SkBitmap& src) {
+    dst->setInfo(src.info(), src.rowBytes());
+    dst->setPixelRef(sk_ref_sp(src.pixelRef()), src.pixelRefOrigin().x(),
+                     src.pixelRefOrigin().y());
+}
+
+SkMipmap* SkMipmap::BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+    SkPixmap srcPM;
+    if (!src.peekPixels(&srcPM)) {
+        return nullptr;
+    }
+    auto lazy = std::make_unique<LazyState>();
+    if (!lazy->fDownsample.init(srcPM, Averaging::kEncoded)) {
+        return nullptr;
+    }
+    if (src.width() <= 1 && src.height() <= 1) {
+        return nullptr;
+    }
+
+    int countLevels = ComputeLevelCount(src.width(), src.height());
+    size_t storageSize = SkMipmap::AllocLevelsSize(countLevels,
+                                                   levels_pixel_size(srcPM, countLevels));
+    if (0 == storageSize) {
+        return nullptr;
+    }
+
+    // Only the Level structs are allocated up front. size() still reports what the levels
+    // take once all are built, so that a cache holding the mipmap budgets for them.
+    const size_t headerSize = AllocLevelsSize(countLevels, 0);
+    SkMipmap* mipmap;
+    if (fact) {
+        SkDiscardableMemory* dm = fact(headerSize);
+        if (nullptr == dm) {
+            return nullptr;
+        }
+        mipmap = new SkMipmap(storageSize, dm);
+    } else {
+        mipmap = new SkMipmap(sk_malloc_throw(headerSize), storageSize);
+    }
+    mipmap->fCS = sk_ref_sp(src.info().colorSpace());
+    mipmap->fCount = countLevels;
+    mipmap->fLevels = (Level*)mipmap->writable_data();
+    for (int i = 0; i < countLevels; ++i) {
+        mipmap->initLevel(i, srcPM, nullptr);
+    }
+
+    set_base(&lazy->fBase, src);
+    lazy->fFactory = fact;
+    if (fact) {
+        lazy->fDiscardable.resize(countLevels);
+    } else {
+        lazy->fMalloc.resize(countLevels);
+    }
+    mipmap->fLazy = std::move(lazy);
+    return mipmap;
+}
+
+bool SkMipmap::needsBase() const {
+    if (!fLazy) {
+        return false;
+    }
+    SkAutoMutexExclusive lock(fLazy->fMutex);
+    return !fLazy->fBase.pixelRef();
+}
+
+void SkMipmap::setBase(const SkBitmap& base) const {
+    if (!fLazy || !this->validForRootLevel(base.info()) || !base.pixelRef()) {
+        return;
+    }
+    SkAutoMutexExclusive lock(fLazy->fMutex);
+    set_base(&fLazy->fBase, base);
+}
+
+bool SkMipmap::buildLevel(int index) const {
+    if (!fLazy) {
+        return true;
+    }
+
+    // The lock is only held to find what to build from and to publish what was built. Building
+    // can run tasks on other threads, which may sample this mipmap themselves, and nobody else
+    // sampling it should have to wait for the whole build.
+    SkBitmap base;
+    SkPixmap srcPM;
+    std::vector<SkPixmap> dstPMs;
+    {
+        SkAutoMutexExclusive lock(fLazy->fMutex);
+        if (fLevels[index].fPixmap.addr()) {
+            return true;
+        }
+
+        // Start from the nearest level above that is still built, or from the base.
+        int above = index - 1;
+        while (above >= 0 && !fLevels[above].fPixmap.addr()) {
+            above--;
+        }
+        if (above >= 0) {
+            srcPM = fLevels[above].fPixmap;
+        } else {
+            base = fLazy->fBase;
+            if (!base.peekPixels(&srcPM)) {
+                return false;
+            }
+        }
+        for (int i = above + 1; i <= index; ++i) {
+            dstPMs.push_back(fLevels[i].fPixmap);
+        }
+    }
+
+    struct Built {
+        std::unique_ptr<SkDiscardableMemory> fDiscardable;
+        SkAutoFree                           fMalloc;
+    };
+    std::vector<Built> built(dstPMs.size());
+    for (size_t i = 0; i < dstPMs.size(); ++i) {
+        SkPixmap& dstPM = dstPMs[i];
+        const size_t bytes = dstPM.height() * dstPM.rowBytes();
+        void* addr;
+        if (fLazy->fFactory) {
+            built[i].fDiscardable.reset(fLazy->fFactory(bytes));
+            if (!built[i].fDiscardable) {
+                return false;
+            }
+            addr = built[i].fDiscardable->data();
+        } else {
+            built[i].fMalloc.reset(sk_malloc_throw(bytes));
+            addr = built[i].fMalloc.get();
+        }
+        // See the comment on SkMipmap::Level.
+        SkASSERT(SkIsAlign8((uintptr_t)addr));
+        dstPM.reset(dstPM.info(), addr, dstPM.rowBytes());
+        fLazy->fDownsample(srcPM, dstPM);
+        srcPM = dstPM;
+    }
+
+    // Levels another thread built in the meantime are kept, and ours dropped.
+    SkAutoMutexExclusive lock(fLazy->fMutex);
+    const int first = index + 1 - SkToInt(dstPMs.size());
+    for (size_t i = 0; i < dstPMs.size(); ++i) {
+        const int level = first + SkToInt(i);
+        if (fLevels[level].fPixmap.addr()) {
+            continue;
+        }
+        if (fLazy->fFactory) {
+            fLazy->fDiscardable[level] = std::move(built[i].fDiscardable);
+        } else {
+            fLazy->fMalloc[level] = std::move(built[i].fMalloc);
+        }
+        fLevels[level].fPixmap = dstPMs[i];
+    }
+    return true;
+}
+
+void SkMipmap::onDataChange(void*, void* newData) {
+    fLevels = (Level*)newData; // could be nullptr
+    if (!fLazy) {
+        return;
+    }
+
+    // Once only a cache owns us, let the levels' discardable memory be purged, and stop
+    // holding the base so it can go away with its image. Whoever finds us in the cache next
+    // gets back the levels that survived, and can setBase() to rebuild the rest.
+    SkAutoMutexExclusive lock(fLazy->fMutex);
+    if (!newData) {
+        fLazy->fBase.reset();
+    }
+    for (int i = 0; i < (int)fLazy->fDiscardable.size(); ++i) {
+        SkDiscardableMemory* dm = fLazy->fDiscardable[i].get();
+        if (!dm) {
+            continue;
+        }
+        if (!newData) {
+            // The Level structs may be unlocked already, so leave them alone.
+            dm->unlock();
+            continue;
+        }
+        SkPixmap& pm = fLevels[i].fPixmap;
+        if (dm->lock()) {
+            pm.reset(pm.info(), dm->data(), pm.rowBytes());
+        } else {
+            fLazy->fDiscardable[i].reset();
+            pm.reset(pm.info(), nullptr, pm.rowBytes());
+        }
+    }
+}
+
 int SkMipmap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -752,6 +1023,9 @@ bool SkMipmap::extractLevel(SkSize scaleSize, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
+    if (!this->buildLevel(level - 1)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
@@ -809,6 +1083,9 @@ bool SkMipmap::getLevel(int index, Level* levelPtr) const {
     if (index > fCount - 1) {
         return false;
     }
+    if (!this->buildLevel(index)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[index];
         // need to augment with our colorspace
@@ -15,6 +15,8 @@
 #include "src/core/SkCachedData.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <memory>
+
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
@@ -31,13 +33,29 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
  */
 class SkMipmap : public SkCachedData {
 public:
+    // How the color channels of each level are averaged. kLinearLight decodes 8888 pixels with
+    // their color space's transfer function, averages, and re-encodes, as a GPU does when
+    // sampling an sRGB texture; alpha is averaged as stored. It only differs from kEncoded for
+    // 8888 pixels whose color space (sRGB if none) is not linear.
+    enum class Averaging {
+        kEncoded,
+        kLinearLight,
+    };
+
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // Large levels are filled in strips on the default executor (see SkExecutor::SetDefault).
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, Averaging = Averaging::kEncoded);
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    // Allocate a mipmap whose levels are each built the first time getLevel() or extractLevel()
+    // asks for them (along with any levels above them that are not built yet). Each level gets
+    // its own memory, from the factory if there is one. The mipmap refs src's pixels while
+    // anything but a cache owns it.
+    static SkMipmap* BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc);
+
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipmap.
@@ -73,24 +91,38 @@ public:
 
     bool validForRootLevel(const SkImageInfo&) const;
 
+    // A lazy mipmap found in a cache may have dropped its base, and then can only return the
+    // levels that were built and not purged. needsBase() is true in that case, and setBase()
+    // gives it back the base pixels so that it can build the rest.
+    bool needsBase() const;
+    void setBase(const SkBitmap&) const;
+
     sk_sp<SkData> serialize() const;
     static bool Deserialize(SkMipmapBuilder*, const void* data, size_t size);
 
+    ~SkMipmap() override;
+
 protected:
-    void onDataChange(void* oldData, void* newData) override {
-        fLevels = (Level*)newData; // could be nullptr
-    }
+    void onDataChange(void* oldData, void* newData) override;
 
 private:
+    struct LazyState;
+
     sk_sp<SkColorSpace> fCS;
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
+    std::unique_ptr<LazyState> fLazy;   // null unless made by BuildLazy().
 
-    SkMipmap(void* malloc, size_t size) : INHERITED(malloc, size) {}
-    SkMipmap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+    SkMipmap(void* malloc, size_t size);
+    SkMipmap(size_t size, SkDiscardableMemory* dm);
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    // Sets up the Level struct of the given level below src, with its pixels at addr.
+    void initLevel(int index, const SkPixmap& src, void* addr);
+    // Builds the given level if it is lazy and not built yet. Returns false if it cannot.
+    bool buildLevel(int index) const;
+
     using INHERITED = SkCachedData;
 };
 
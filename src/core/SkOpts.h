@@ -13,7 +13,11 @@
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkXfermodePriv.h"
 
+class SkMatrix;
 struct SkBitmapProcState;
+struct SkPoint;
+struct SkPoint3;
+struct SkRect;
 namespace skvm { struct InterpreterInstruction; }
 
 namespace SkOpts {
@@ -56,6 +60,13 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // Batch SkMatrix kernels. src and dst may be the same array.
+    extern void (*map_affine_points)(const SkMatrix&, SkPoint dst[], const SkPoint src[], int);
+    extern void (*map_persp_points)(const SkMatrix&, SkPoint dst[], const SkPoint src[], int);
+    extern void (*map_homogeneous_points)(const SkMatrix&, SkPoint3 dst[], const SkPoint src[],
+                                          int);
+    extern void (*map_affine_rects)(const SkMatrix&, SkRect dst[], const SkRect src[], int);
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
@@ -10,6 +10,7 @@
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkMathPriv.h"
@@ -186,6 +187,63 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     return nullptr;
 }
 
+bool SkPicture::SkipStream(SkStream* stream) {
+    SkPictInfo info;
+    uint8_t trailingStreamByteAfterPictInfo;
+    // Custom data needs an fPictureProc to parse.
+    return StreamIsSKP(stream, &info) && stream->readU8(&trailingStreamByteAfterPictInfo) &&
+           trailingStreamByteAfterPictInfo == kPictureData_TrailingStreamByteAfterPictInfo &&
+           SkPictureData::SkipStream(stream, info);
+}
+
+sk_sp<SkPicture> SkPicture::MakeLazyFromData(sk_sp<SkData> data, int approxOpCount) {
+    // Only the header and the tags and sizes are read up front, so a picture that doesn't fit in
+    // its data fails now, and the cull rect lets canvases reject the rest without ever parsing it.
+    SkPictInfo info;
+    SkMemoryStream stream(data->data(), data->size());
+    if (!StreamIsSKP(&stream, &info) || !stream.rewind() || !SkipStream(&stream)) {
+        return nullptr;
+    }
+
+    class Lazy final : public SkPicture {
+    public:
+        Lazy(sk_sp<SkData> data, SkRect cull, int approxOpCount)
+            : fData(std::move(data))
+            , fDataSize(fData->size())
+            , fCull(cull)
+            , fApproxOpCount(approxOpCount) {}
+
+        void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+            if (const SkPicture* picture = this->picture()) {
+                picture->playback(canvas, callback);
+            }
+        }
+
+        // Neither of these parse the picture; the op count is the one the index recorded.
+        int approximateOpCount(bool) const override { return fApproxOpCount; }
+        size_t approximateBytesUsed() const override { return sizeof(*this) + fDataSize; }
+        SkRect cullRect()             const override { return fCull; }
+
+    private:
+        // A picture that fails to parse draws nothing.
+        const SkPicture* picture() const {
+            fOnce([this] {
+                SkMemoryStream stream(std::move(fData));
+                fPicture = SkPicture::MakeFromStream(&stream, nullptr, nullptr);
+            });
+            return fPicture.get();
+        }
+
+        mutable SkOnce           fOnce;
+        mutable sk_sp<SkData>    fData;      // Released once parsed.
+        mutable sk_sp<SkPicture> fPicture;
+        const size_t             fDataSize;
+        const SkRect             fCull;
+        const int                fApproxOpCount;
+    };
+    return sk_make_sp<Lazy>(std::move(data), info.fCullRect, approxOpCount);
+}
+
 sk_sp<SkPicture> SkPicturePriv::MakeFromBuffer(SkReadBuffer& buffer) {
     SkPictInfo info;
     if (!SkPicture::BufferIsSKP(&buffer, &info)) {
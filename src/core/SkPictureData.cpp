@@ -7,18 +7,23 @@
 
 #include "src/core/SkPictureData.h"
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageGenerator.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/SkTo.h"
-#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkFontDescriptor.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "src/core/SkVerticesPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <new>
+#include <vector>
 
 template <typename T> int SafeCount(const T* obj) {
     return obj ? obj->count() : 0;
@@ -245,11 +250,24 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
-    // Write sub-pictures by calling serialize again.
+    // Write sub-pictures by calling serialize again, after an index of their sizes and op counts
+    // so that readers can skip over them, or hold on to them unparsed.
     if (!fPictures.empty()) {
-        write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictures.count());
+        std::vector<sk_sp<SkData>> serialized;
+        serialized.reserve(fPictures.count());
         for (const auto& pic : fPictures) {
-            pic->serialize(stream, &procs, typefaceSet, /*textBlobsOnly=*/ false);
+            SkDynamicMemoryWStream picStream;
+            pic->serialize(&picStream, &procs, typefaceSet, /*textBlobsOnly=*/ false);
+            serialized.push_back(picStream.detachAsData());
+        }
+
+        write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictures.count());
+        for (int i = 0; i < fPictures.count(); i++) {
+            stream->write32(SkToU32(serialized[i]->size()));
+            stream->write32(SkToU32(fPictures[i]->approximateOpCount()));
+        }
+        for (const auto& data : serialized) {
+            stream->write(data->data(), data->size());
         }
     }
 
@@ -310,6 +328,22 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
         } break;
         case SK_PICT_TYPEFACE_TAG: {
             fTFPlayback.setCount(size);
+            if (procs.fExecutor && !procs.fTypefaceProc && size > 1) {
+                // Read the descriptors in order, then make the typefaces concurrently.
+                std::unique_ptr<SkFontDescriptor[]> descs(new SkFontDescriptor[size]);
+                std::unique_ptr<bool[]> ok(new bool[size]);
+                for (uint32_t i = 0; i < size; ++i) {
+                    ok[i] = SkFontDescriptor::Deserialize(stream, &descs[i]);
+                }
+                SkTaskGroup tasks(*procs.fExecutor);
+                tasks.batch(SkToInt(size), [&](int i) {
+                    sk_sp<SkTypeface> tf = ok[i] ? SkTypeface::MakeFromDescriptor(&descs[i])
+                                                 : nullptr;
+                    fTFPlayback[i] = tf ? std::move(tf) : SkTypeface::MakeDefault();
+                });
+                tasks.wait();
+                break;
+            }
             for (uint32_t i = 0; i < size; ++i) {
                 sk_sp<SkTypeface> tf;
                 if (procs.fTypefaceProc) {
@@ -329,21 +363,70 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             SkASSERT(fPictures.empty());
             fPictures.reserve_back(SkToInt(size));
 
+            if (fInfo.getVersion() < SkPicturePriv::kIndexedSubPictures_Version) {
+                for (uint32_t i = 0; i < size; i++) {
+                    auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                    if (!pic) {
+                        return false;
+                    }
+                    fPictures.push_back(std::move(pic));
+                }
+                break;
+            }
+
+            SkAutoTMalloc<uint32_t> index(2 * (size_t)size);
+            for (uint32_t i = 0; i < 2 * size; i++) {
+                if (!stream->readU32(&index[i])) { return false; }
+            }
+            std::vector<sk_sp<SkData>> serialized(size);
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                if (!(serialized[i] = SkData::MakeFromStream(stream, index[2*i]))) {
+                    return false;
+                }
+            }
+
+            // Custom procs (and their contexts) are only promised to live as long as this call,
+            // so pictures that need them are parsed now.
+            const bool lazy = !procs.fPictureProc && !procs.fImageProc && !procs.fTypefaceProc;
+            // Sub-pictures may parse on the executor's own threads, where waiting on it again
+            // could spin forever if it doesn't allow borrowing, so only the top level uses it.
+            SkDeserialProcs subProcs = procs;
+            subProcs.fExecutor = nullptr;
+            fPictures.push_back_n(SkToInt(size));
+            auto makePicture = [&](int i) {
+                const int opCount = SkToInt(index[2*i + 1]);
+                if (lazy && opCount > kMaxPictureOpsToUnrollInsteadOfRef) {
+                    // Every sub-picture carries the full typeface table, so it parses on its own.
+                    fPictures[i] = SkPicture::MakeLazyFromData(std::move(serialized[i]), opCount);
+                } else {
+                    SkMemoryStream picStream(std::move(serialized[i]));
+                    fPictures[i] = SkPicture::MakeFromStream(&picStream, &subProcs,
+                                                             topLevelTFPlayback);
+                }
+            };
+            if (procs.fExecutor && size > 1) {
+                SkTaskGroup tasks(*procs.fExecutor);
+                tasks.batch(SkToInt(size), makePicture);
+                tasks.wait();
+            } else {
+                for (uint32_t i = 0; i < size; i++) {
+                    makePicture(i);
+                }
+            }
+            for (const auto& pic : fPictures) {
                 if (!pic) {
                     return false;
                 }
-                fPictures.push_back(std::move(pic));
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            // The stream's copy is the only one: images' encoded data shares it.
+            sk_sp<SkData> storage = SkData::MakeFromStream(stream, size);
+            if (!storage) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(std::move(storage));
             buffer.setVersion(fInfo.getVersion());
 
             if (!fFactoryPlayback) {
@@ -406,6 +489,32 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Like new_array_from_buffer(create_image_from_buffer), but only the reading is done in order; the
+// images are decoded concurrently.
+static bool new_images_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
+                                   SkTArray<sk_sp<const SkImage>>& array, SkExecutor& executor) {
+    if (!buffer.validate(array.empty() && SkTFitsIn<int>(inCount))) {
+        return false;
+    }
+
+    std::vector<SkReadBuffer::EncodedImage> encoded;
+    for (uint32_t i = 0; i < inCount; ++i) {
+        encoded.emplace_back();
+        if (!buffer.readEncodedImage(&encoded.back())) {
+            return false;
+        }
+    }
+
+    array.push_back_n(SkToInt(inCount));
+    const SkDeserialProcs& procs = buffer.getDeserialProcs();
+    SkTaskGroup tasks(executor);
+    tasks.batch(SkToInt(inCount), [&](int i) {
+        array[i] = SkReadBuffer::DecodeImage(std::move(encoded[i]), procs);
+    });
+    tasks.wait();
+    return true;
+}
+
 void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
     switch (tag) {
         case SK_PICT_PAINT_BUFFER_TAG: {
@@ -441,17 +550,16 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             new_array_from_buffer(buffer, size, fVertices, SkVerticesPriv::Decode);
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            new_array_from_buffer(buffer, size, fImages, create_image_from_buffer);
+            if (SkExecutor* executor = buffer.getDeserialProcs().fExecutor;
+                    executor && !buffer.isVersionLT(SkPicturePriv::kSerializeMipmaps_Version)) {
+                new_images_from_buffer(buffer, size, fImages, *executor);
+            } else {
+                new_array_from_buffer(buffer, size, fImages, create_image_from_buffer);
+            }
             break;
         case SK_PICT_READER_TAG: {
-            // Preflight check that we can initialize all data from the buffer
-            // before allocating it.
-            if (!buffer.validateCanReadN<uint8_t>(size)) {
-                return;
-            }
-            auto data(SkData::MakeUninitialized(size));
-            if (!buffer.readByteArray(data->writable_data(), size) ||
-                !buffer.validate(nullptr == fOpData)) {
+            auto data = buffer.readByteArrayAsData();
+            if (!buffer.validate(data && data->size() == size && nullptr == fOpData)) {
                 return;
             }
             SkASSERT(nullptr == fOpData);
@@ -514,6 +622,61 @@ bool SkPictureData::parseStream(SkStream* stream,
     return true;
 }
 
+bool SkPictureData::SkipStream(SkStream* stream, const SkPictInfo& info) {
+    for (;;) {
+        uint32_t tag;
+        if (!stream->readU32(&tag)) { return false; }
+        if (SK_PICT_EOF_TAG == tag) {
+            break;
+        }
+
+        uint32_t size;
+        if (!stream->readU32(&size)) { return false; }
+        // Each case reads what parseStreamTag() would.
+        switch (tag) {
+            case SK_PICT_READER_TAG:
+            case SK_PICT_BUFFER_SIZE_TAG:
+                if (stream->skip(size) != size) { return false; }
+                break;
+            case SK_PICT_FACTORY_TAG: {
+                if (!stream->readU32(&size)) { return false; }
+                for (size_t i = 0; i < size; i++) {
+                    size_t len;
+                    if (!stream->readPackedUInt(&len) || stream->skip(len) != len) {
+                        return false;
+                    }
+                }
+            } break;
+            case SK_PICT_TYPEFACE_TAG:
+                for (uint32_t i = 0; i < size; ++i) {
+                    // A typeface that fails to deserialize is replaced by the default.
+                    SkFontDescriptor desc;
+                    (void)SkFontDescriptor::Deserialize(stream, &desc);
+                }
+                break;
+            case SK_PICT_PICTURE_TAG: {
+                if (info.getVersion() < SkPicturePriv::kIndexedSubPictures_Version) {
+                    for (uint32_t i = 0; i < size; i++) {
+                        if (!SkPicture::SkipStream(stream)) { return false; }
+                    }
+                    break;
+                }
+                SkAutoTMalloc<uint32_t> index(2 * (size_t)size);
+                for (uint32_t i = 0; i < 2 * size; i++) {
+                    if (!stream->readU32(&index[i])) { return false; }
+                }
+                for (uint32_t i = 0; i < size; i++) {
+                    sk_sp<SkData> serialized = SkData::MakeFromStream(stream, index[2*i]);
+                    if (!serialized) { return false; }
+                    SkMemoryStream picStream(std::move(serialized));
+                    if (!SkPicture::SkipStream(&picStream)) { return false; }
+                }
+            } break;
+        }
+    }
+    return true;
+}
+
 bool SkPictureData::parseBuffer(SkReadBuffer& buffer) {
     while (buffer.isValid()) {
         uint32_t tag = buffer.readUInt();
@@ -82,6 +82,9 @@ public:
                                            const SkDeserialProcs&,
                                            SkTypefacePlayback*);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
+    // Reads past what CreateFromStream() would, without making anything. Returns false if the
+    // tags and sizes don't fit in the stream.
+    static bool SkipStream(SkStream*, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
     void flatten(SkWriteBuffer&) const;
@@ -45,14 +45,27 @@ static const SkRect* get_rect_ptr(SkReadBuffer* reader, SkRect* storage) {
     }
 }
 
+// Reads an op's type and size, returning false if they aren't valid.
+static bool read_op(SkReadBuffer* reader, uint32_t* op, uint32_t* size) {
+    uint32_t bits = reader->readInt();
+    *op   = bits >> 24;
+    *size = bits & 0xffffff;
+    if (*size == 0xffffff) {
+        *size = reader->readInt();
+    }
+    return reader->validate(*size > 0 && *op > UNUSED && *op <= LAST_DRAWTYPE_ENUM);
+}
+
 void SkPicturePlayback::draw(SkCanvas* canvas,
                              SkPicture::AbortCallback* callback,
                              SkReadBuffer* buffer) {
     AutoResetOpID aroi(this);
     SkASSERT(0 == fCurOffset);
 
-    SkReadBuffer reader(fPictureData->opData()->bytes(),
-                        fPictureData->opData()->size());
+    // Sharing the op data lets annotations' data share it too.
+    SkReadBuffer reader(fPictureData->opData());
+    fBase = 0;
+    fOpDataSize = reader.size();
 
     // Record this, so we can concat w/ it if we encounter a setMatrix()
     SkMatrix initialMatrix = canvas->getTotalMatrix();
@@ -66,14 +79,8 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
 
         fCurOffset = reader.offset();
 
-        uint32_t bits = reader.readInt();
-        uint32_t op   = bits >> 24,
-                 size = bits & 0xffffff;
-        if (size == 0xffffff) {
-            size = reader.readInt();
-        }
-
-        if (!reader.validate(size > 0 && op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+        uint32_t op, size;
+        if (!read_op(&reader, &op, &size)) {
             return;
         }
 
@@ -86,10 +93,97 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
-static void validate_offsetToRestore(SkReadBuffer* reader, size_t offsetToRestore) {
+size_t SkPicturePlayback::drawPiece(SkCanvas* canvas, SkReadBuffer* reader, size_t base,
+                                    size_t opDataSize, const SkMatrix& initialMatrix) {
+    fBase = base;
+    fOpDataSize = opDataSize;
+    fSkipTo = 0;
+
+    // Ops cut off by the end of the last piece are corrupt; by the end of others, just early.
+    const bool last = base + reader->size() >= opDataSize;
+    while (!reader->eof()) {
+        const size_t start = reader->offset();
+        if (!last && reader->available() < 2 * sizeof(uint32_t)) {
+            return base + start;
+        }
+
+        uint32_t op, size;
+        if (!read_op(reader, &op, &size)) {
+            break;
+        }
+        // An op's size counts its first word. A big size takes a second, which it counts as 1.
+        const size_t extent = reader->offset() - start == sizeof(uint32_t) ? size : size + 3;
+        if (!last && extent > reader->size() - start) {
+            return base + start;
+        }
+
+        fCurOffset = base + start;
+        this->handleOp(reader, (DrawType)op, size, canvas, initialMatrix);
+        if (fResources) {
+            fResources->endOp();
+        }
+        if (fSkipTo) {
+            return fSkipTo;
+        }
+    }
+    return base + reader->offset();
+}
+
+static void validate_offsetToRestore(SkReadBuffer* reader, size_t base, size_t offsetToRestore) {
     if (offsetToRestore) {
-        reader->validate(SkIsAlign4(offsetToRestore) && offsetToRestore >= reader->offset());
+        reader->validate(SkIsAlign4(offsetToRestore) &&
+                         offsetToRestore >= base + reader->offset());
+    }
+}
+
+void SkPicturePlayback::skipToRestore(SkReadBuffer* reader, size_t offsetToRestore) {
+    const size_t end = fBase + reader->size();
+    if (offsetToRestore > end && reader->validate(offsetToRestore <= fOpDataSize)) {
+        // The rest of this piece is skipped; playing picks up again in a later one.
+        fSkipTo = offsetToRestore;
+        offsetToRestore = end;
     }
+    reader->skip(offsetToRestore - fBase - reader->offset());
+}
+
+const SkPaint* SkPicturePlayback::optionalPaint(SkReadBuffer* reader) const {
+    return fResources ? fResources->optionalPaint(reader) : fPictureData->optionalPaint(reader);
+}
+
+const SkPaint& SkPicturePlayback::requiredPaint(SkReadBuffer* reader) const {
+    if (!fResources) {
+        return fPictureData->requiredPaint(reader);
+    }
+    const SkPaint* paint = fResources->optionalPaint(reader);
+    if (reader->validate(paint != nullptr)) {
+        return *paint;
+    }
+    static const SkPaint& stub = *(new SkPaint);
+    return stub;
+}
+
+const SkPath& SkPicturePlayback::getPath(SkReadBuffer* reader) const {
+    return fResources ? fResources->getPath(reader) : fPictureData->getPath(reader);
+}
+
+const SkImage* SkPicturePlayback::getImage(SkReadBuffer* reader) const {
+    return fResources ? fResources->getImage(reader) : fPictureData->getImage(reader);
+}
+
+const SkPicture* SkPicturePlayback::getPicture(SkReadBuffer* reader) const {
+    return fResources ? fResources->getPicture(reader) : fPictureData->getPicture(reader);
+}
+
+SkDrawable* SkPicturePlayback::getDrawable(SkReadBuffer* reader) const {
+    return fResources ? fResources->getDrawable(reader) : fPictureData->getDrawable(reader);
+}
+
+const SkTextBlob* SkPicturePlayback::getTextBlob(SkReadBuffer* reader) const {
+    return fResources ? fResources->getTextBlob(reader) : fPictureData->getTextBlob(reader);
+}
+
+const SkVertices* SkPicturePlayback::getVertices(SkReadBuffer* reader) const {
+    return fResources ? fResources->getVertices(reader) : fPictureData->getVertices(reader);
 }
 
 void SkPicturePlayback::handleOp(SkReadBuffer* reader,
@@ -108,17 +202,17 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->flush();
             break;
         case CLIP_PATH: {
-            const SkPath& path = fPictureData->getPath(reader);
+            const SkPath& path = this->getPath(reader);
             uint32_t packed = reader->readInt();
             SkClipOp clipOp = ClipParams_unpackRegionOp(reader, packed);
             bool doAA = ClipParams_unpackDoAA(packed);
             size_t offsetToRestore = reader->readInt();
-            validate_offsetToRestore(reader, offsetToRestore);
+            validate_offsetToRestore(reader, fBase, offsetToRestore);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->clipPath(path, clipOp, doAA);
             if (canvas->isClipEmpty() && offsetToRestore) {
-                reader->skip(offsetToRestore - reader->offset());
+                this->skipToRestore(reader, offsetToRestore);
             }
         } break;
         case CLIP_REGION: {
@@ -127,12 +221,12 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             uint32_t packed = reader->readInt();
             SkClipOp clipOp = ClipParams_unpackRegionOp(reader, packed);
             size_t offsetToRestore = reader->readInt();
-            validate_offsetToRestore(reader, offsetToRestore);
+            validate_offsetToRestore(reader, fBase, offsetToRestore);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->clipRegion(region, clipOp);
             if (canvas->isClipEmpty() && offsetToRestore) {
-                reader->skip(offsetToRestore - reader->offset());
+                this->skipToRestore(reader, offsetToRestore);
             }
         } break;
         case CLIP_RECT: {
@@ -142,12 +236,12 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             SkClipOp clipOp = ClipParams_unpackRegionOp(reader, packed);
             bool doAA = ClipParams_unpackDoAA(packed);
             size_t offsetToRestore = reader->readInt();
-            validate_offsetToRestore(reader, offsetToRestore);
+            validate_offsetToRestore(reader, fBase, offsetToRestore);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->clipRect(rect, clipOp, doAA);
             if (canvas->isClipEmpty() && offsetToRestore) {
-                reader->skip(offsetToRestore - reader->offset());
+                this->skipToRestore(reader, offsetToRestore);
             }
         } break;
         case CLIP_RRECT: {
@@ -157,16 +251,16 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             SkClipOp clipOp = ClipParams_unpackRegionOp(reader, packed);
             bool doAA = ClipParams_unpackDoAA(packed);
             size_t offsetToRestore = reader->readInt();
-            validate_offsetToRestore(reader, offsetToRestore);
+            validate_offsetToRestore(reader, fBase, offsetToRestore);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->clipRRect(rrect, clipOp, doAA);
             if (canvas->isClipEmpty() && offsetToRestore) {
-                reader->skip(offsetToRestore - reader->offset());
+                this->skipToRestore(reader, offsetToRestore);
             }
         } break;
         case CLIP_SHADER_IN_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkClipOp clipOp = reader->checkRange(SkClipOp::kDifference, SkClipOp::kIntersect);
             BREAK_ON_READ_ERROR(reader);
 
@@ -200,7 +294,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawAnnotation(rect, key.c_str(), data.get());
         } break;
         case DRAW_ARC: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRect rect;
             reader->readRect(&rect);
             SkScalar startAngle = reader->readScalar();
@@ -211,8 +305,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawArc(rect, startAngle, sweepAngle, SkToBool(useCenter), paint);
         } break;
         case DRAW_ATLAS: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* atlas = fPictureData->getImage(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
+            const SkImage* atlas = this->getImage(reader);
             const uint32_t flags = reader->readUInt();
             const int count = reader->readUInt();
             const SkRSXform* xform = (const SkRSXform*)reader->skip(count, sizeof(SkRSXform));
@@ -244,7 +338,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             // skip handles padding the read out to a multiple of 4
         } break;
         case DRAW_DRAWABLE: {
-            auto* d = fPictureData->getDrawable(reader);
+            auto* d = this->getDrawable(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawDrawable(d);
@@ -252,13 +346,13 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
         case DRAW_DRAWABLE_MATRIX: {
             SkMatrix matrix;
             reader->readMatrix(&matrix);
-            SkDrawable* drawable = fPictureData->getDrawable(reader);
+            SkDrawable* drawable = this->getDrawable(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawDrawable(drawable, &matrix);
         } break;
         case DRAW_DRRECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRRect outer, inner;
             reader->readRRect(&outer);
             reader->readRRect(&inner);
@@ -290,7 +384,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             if (!reader->validate(cnt >= 0)) {
                 break;
             }
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
 
             SkCanvas::SrcRectConstraint constraint =
                     reader->checkRange(SkCanvas::kStrict_SrcRectConstraint,
@@ -306,7 +400,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             int maxMatrixIndex = -1;
             SkAutoTArray<SkCanvas::ImageSetEntry> set(cnt);
             for (int i = 0; i < cnt && reader->isValid(); ++i) {
-                set[i].fImage = sk_ref_sp(fPictureData->getImage(reader));
+                set[i].fImage = sk_ref_sp(this->getImage(reader));
                 reader->readRect(&set[i].fSrcRect);
                 reader->readRect(&set[i].fDstRect);
                 set[i].fMatrixIndex = reader->readInt();
@@ -350,8 +444,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                                     paint, constraint);
         } break;
         case DRAW_IMAGE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
+            const SkImage* image = this->getImage(reader);
             SkPoint loc;
             reader->readPoint(&loc);
             BREAK_ON_READ_ERROR(reader);
@@ -359,8 +453,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImage(image, loc.fX, loc.fY, paint);
         } break;
         case DRAW_IMAGE_LATTICE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
+            const SkImage* image = this->getImage(reader);
             SkCanvas::Lattice lattice;
             (void)SkCanvasPriv::ReadLattice(*reader, &lattice);
             const SkRect* dst = reader->skipT<SkRect>();
@@ -369,8 +463,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImageLattice(image, lattice, *dst, paint);
         } break;
         case DRAW_IMAGE_NINE: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
+            const SkImage* image = this->getImage(reader);
             SkIRect center;
             reader->readIRect(&center);
             SkRect dst;
@@ -380,8 +474,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawImageNine(image, center, dst, paint);
         } break;
         case DRAW_IMAGE_RECT: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
-            const SkImage* image = fPictureData->getImage(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
+            const SkImage* image = this->getImage(reader);
             SkRect storage;
             const SkRect* src = get_rect_ptr(reader, &storage);   // may be null
             SkRect dst;
@@ -398,7 +492,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->legacy_drawImageRect(image, src, dst, paint, constraint);
         } break;
         case DRAW_OVAL: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRect rect;
             reader->readRect(&rect);
             BREAK_ON_READ_ERROR(reader);
@@ -406,19 +500,19 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawOval(rect, paint);
         } break;
         case DRAW_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPaint(paint);
         } break;
         case DRAW_BEHIND_PAINT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             BREAK_ON_READ_ERROR(reader);
 
             SkCanvasPriv::DrawBehind(canvas, paint);
         } break;
         case DRAW_PATCH: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
 
             const SkPoint* cubics = (const SkPoint*)reader->skip(SkPatchUtils::kNumCtrlPts,
                                                                  sizeof(SkPoint));
@@ -444,29 +538,29 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPatch(cubics, colors, texCoords, bmode, paint);
         } break;
         case DRAW_PATH: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const auto& path = fPictureData->getPath(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
+            const auto& path = this->getPath(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPath(path, paint);
         } break;
         case DRAW_PICTURE: {
-            const auto* pic = fPictureData->getPicture(reader);
+            const auto* pic = this->getPicture(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPicture(pic);
         } break;
         case DRAW_PICTURE_MATRIX_PAINT: {
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
             SkMatrix matrix;
             reader->readMatrix(&matrix);
-            const SkPicture* pic = fPictureData->getPicture(reader);
+            const SkPicture* pic = this->getPicture(reader);
             BREAK_ON_READ_ERROR(reader);
 
             canvas->drawPicture(pic, &matrix, paint);
         } break;
         case DRAW_POINTS: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkCanvas::PointMode mode = reader->checkRange(SkCanvas::kPoints_PointMode,
                                                           SkCanvas::kPolygon_PointMode);
             size_t count = reader->readInt();
@@ -476,7 +570,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawPoints(mode, count, pts, paint);
         } break;
         case DRAW_RECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRect rect;
             reader->readRect(&rect);
             BREAK_ON_READ_ERROR(reader);
@@ -484,7 +578,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRect(rect, paint);
         } break;
         case DRAW_REGION: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRegion region;
             reader->readRegion(&region);
             BREAK_ON_READ_ERROR(reader);
@@ -492,7 +586,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRegion(region, paint);
         } break;
         case DRAW_RRECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
             SkRRect rrect;
             reader->readRRect(&rrect);
             BREAK_ON_READ_ERROR(reader);
@@ -500,7 +594,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawRRect(rrect, paint);
         } break;
         case DRAW_SHADOW_REC: {
-            const auto& path = fPictureData->getPath(reader);
+            const auto& path = this->getPath(reader);
             SkDrawShadowRec rec;
             reader->readPoint3(&rec.fZPlaneParams);
             reader->readPoint3(&rec.fLightPos);
@@ -513,8 +607,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->private_draw_shadow_rec(path, rec);
         } break;
         case DRAW_TEXT_BLOB: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const SkTextBlob* blob = fPictureData->getTextBlob(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
+            const SkTextBlob* blob = this->getTextBlob(reader);
             SkScalar x = reader->readScalar();
             SkScalar y = reader->readScalar();
             BREAK_ON_READ_ERROR(reader);
@@ -522,8 +616,8 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->drawTextBlob(blob, x, y, paint);
         } break;
         case DRAW_VERTICES_OBJECT: {
-            const SkPaint& paint = fPictureData->requiredPaint(reader);
-            const SkVertices* vertices = fPictureData->getVertices(reader);
+            const SkPaint& paint = this->requiredPaint(reader);
+            const SkVertices* vertices = this->getVertices(reader);
             const int boneCount = reader->readInt();
             (void)reader->skip(boneCount, sizeof(SkVertices_DeprecatedBone));
             SkBlendMode bmode = reader->read32LE(SkBlendMode::kLastMode);
@@ -562,7 +656,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
         case SAVE_LAYER_SAVEFLAGS_DEPRECATED: {
             SkRect storage;
             const SkRect* boundsPtr = get_rect_ptr(reader, &storage);
-            const SkPaint* paint = fPictureData->optionalPaint(reader);
+            const SkPaint* paint = this->optionalPaint(reader);
             auto flags = SkCanvasPriv::LegacySaveFlagsToSaveLayerFlags(reader->readInt());
             BREAK_ON_READ_ERROR(reader);
 
@@ -577,17 +671,17 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                 rec.fBounds = &bounds;
             }
             if (flatFlags & SAVELAYERREC_HAS_PAINT) {
-                rec.fPaint = &fPictureData->requiredPaint(reader);
+                rec.fPaint = &this->requiredPaint(reader);
             }
             if (flatFlags & SAVELAYERREC_HAS_BACKDROP) {
-                const SkPaint& paint = fPictureData->requiredPaint(reader);
+                const SkPaint& paint = this->requiredPaint(reader);
                 rec.fBackdrop = paint.getImageFilter();
             }
             if (flatFlags & SAVELAYERREC_HAS_FLAGS) {
                 rec.fSaveLayerFlags = reader->readInt();
             }
             if (flatFlags & SAVELAYERREC_HAS_CLIPMASK_OBSOLETE) {
-                (void)fPictureData->getImage(reader);
+                (void)this->getImage(reader);
             }
             if (flatFlags & SAVELAYERREC_HAS_CLIPMATRIX_OBSOLETE) {
                 SkMatrix clipMatrix_ignored;
@@ -12,19 +12,58 @@
 
 class SkBitmap;
 class SkCanvas;
+class SkDrawable;
+class SkImage;
 class SkPaint;
+class SkPath;
 class SkPictureData;
+class SkTextBlob;
+class SkVertices;
 
 // The basic picture playback class replays the provided picture into a canvas.
 class SkPicturePlayback final : SkNoncopyable {
 public:
+    // Where ops find their paints, paths, images and so on, when those aren't all held in an
+    // SkPictureData. Each call reads the op's index from the reader as SkPictureData's accessors
+    // do, and what it returns must stay valid until endOp() is called.
+    class Resources {
+    public:
+        virtual ~Resources() = default;
+
+        virtual const SkPaint*    optionalPaint(SkReadBuffer*) = 0;
+        virtual const SkPath&     getPath(SkReadBuffer*) = 0;
+        virtual const SkImage*    getImage(SkReadBuffer*) = 0;
+        virtual const SkPicture*  getPicture(SkReadBuffer*) = 0;
+        virtual SkDrawable*       getDrawable(SkReadBuffer*) = 0;
+        virtual const SkTextBlob* getTextBlob(SkReadBuffer*) = 0;
+        virtual const SkVertices* getVertices(SkReadBuffer*) = 0;
+
+        // Called after each op.
+        virtual void endOp() {}
+    };
+
     SkPicturePlayback(const SkPictureData* data)
         : fPictureData(data)
+        , fResources(nullptr)
+        , fCurOffset(0) {
+    }
+
+    // Plays ops with drawPiece(), finding what they use in resources.
+    SkPicturePlayback(Resources* resources)
+        : fPictureData(nullptr)
+        , fResources(resources)
         , fCurOffset(0) {
     }
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Plays the ops in reader, which holds the part of the op data starting at offset base out of
+    // opDataSize bytes, stopping before any op that runs past its end. Returns the offset of the
+    // next op to play, which may lie past reader if an empty clip skipped the ops up to a restore,
+    // or is base if the first op didn't fit. The reader is left invalid if an op was.
+    size_t drawPiece(SkCanvas*, SkReadBuffer* reader, size_t base, size_t opDataSize,
+                     const SkMatrix& initialMatrix);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
@@ -33,16 +72,35 @@ public:
 
 protected:
     const SkPictureData* fPictureData;
+    Resources*           fResources;
 
     // The offset of the current operation when within the draw method
     size_t fCurOffset;
 
+    // The offset in the op data of the reader's first byte, and the size of all the op data.
+    size_t fBase = 0;
+    size_t fOpDataSize = 0;
+    // Where an empty clip skipped to, if that's past the reader's end, or 0.
+    size_t fSkipTo = 0;
+
     void handleOp(SkReadBuffer* reader,
                   DrawType op,
                   uint32_t size,
                   SkCanvas* canvas,
                   const SkMatrix& initialMatrix);
 
+    // Skips the reader to offsetToRestore, an offset in the whole op data.
+    void skipToRestore(SkReadBuffer* reader, size_t offsetToRestore);
+
+    const SkPaint* optionalPaint(SkReadBuffer*) const;
+    const SkPaint& requiredPaint(SkReadBuffer*) const;
+    const SkPath& getPath(SkReadBuffer*) const;
+    const SkImage* getImage(SkReadBuffer*) const;
+    const SkPicture* getPicture(SkReadBuffer*) const;
+    SkDrawable* getDrawable(SkReadBuffer*) const;
+    const SkTextBlob* getTextBlob(SkReadBuffer*) const;
+    const SkVertices* getVertices(SkReadBuffer*) const;
+
     class AutoResetOpID {
     public:
         AutoResetOpID(SkPicturePlayback* playback) : fPlayback(playback) { }
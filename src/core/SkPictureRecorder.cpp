@@ -68,6 +68,7 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
 
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord.get());
+    fRecord->shrinkToFit();
 
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     std::unique_ptr<SkBigPicture::SnapshotArray> pictList{
@@ -129,6 +130,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable() {
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
     SkRecordOptimize(fRecord.get());
+    fRecord->shrinkToFit();
 
     if (fBBH) {
         SkAutoTMalloc<SkRect> bounds(fRecord->count());
@@ -24,6 +24,7 @@
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkPixmapPriv.h"
 #include "src/core/SkRasterClip.h"
+#include "src/core/SkResampler.h"
 #include "src/core/SkUtils.h"
 #include "src/image/SkReadPixelsRec.h"
 #include "src/shaders/SkImageShader.h"
@@ -261,6 +262,16 @@ bool SkPixmap::scalePixels(const SkPixmap& actualDst, SkFilterQuality quality) c
     return true;
 }
 
+bool SkPixmap::scalePixels(const SkPixmap& dst, ResampleFilter filter, bool linear) const {
+    if (this->width() <= 0 || this->height() <= 0 || dst.width() <= 0 || dst.height() <= 0) {
+        return false;
+    }
+    if (this->dimensions() == dst.dimensions()) {
+        return this->readPixels(dst);
+    }
+    return SkResampler(this->dimensions(), dst.dimensions(), filter).resample(*this, dst, linear);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkColor SkPixmap::getColor(int x, int y) const {
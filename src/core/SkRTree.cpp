@@ -7,14 +7,145 @@
 
 #include "src/core/SkRTree.h"
 
-SkRTree::SkRTree() : fCount(0) {}
+#include <algorithm>
+
+SkRTree::SkRTree(BulkLoad bulkLoad)
+        : fCount(0)
+        , fBulkLoad(bulkLoad)
+        , fInOrder(true)
+        , fLeavesIndexed(true)
+        , fRoot{SkRect::MakeEmpty(), -1} {}
+
+SkRect SkRTree::Node::bounds() const {
+    SkRect bounds = this->bounds(0);
+    for (int i = 1; i < fNumChildren; ++i) {
+        bounds.fLeft   = std::min(bounds.fLeft,   fLeft[i]);
+        bounds.fTop    = std::min(bounds.fTop,    fTop[i]);
+        bounds.fRight  = std::max(bounds.fRight,  fRight[i]);
+        bounds.fBottom = std::max(bounds.fBottom, fBottom[i]);
+    }
+    return bounds;
+}
+
+void SkRTree::Node::set(int i, const Branch& branch) {
+    fLeft[i]     = branch.fBounds.fLeft;
+    fTop[i]      = branch.fBounds.fTop;
+    fRight[i]    = branch.fBounds.fRight;
+    fBottom[i]   = branch.fBounds.fBottom;
+    fChildren[i] = branch.fIndex;
+}
+
+void SkRTree::Node::remove(int i) {
+    for (--fNumChildren; i < fNumChildren; ++i) {
+        this->set(i, {this->bounds(i + 1), fChildren[i + 1]});
+    }
+}
+
+int SkRTree::Node::find(int child) const {
+    for (int i = 0; i < fNumChildren; ++i) {
+        if (fChildren[i] == child) {
+            return i;
+        }
+    }
+    SkASSERT(false);
+    return -1;
+}
+
+static uint32_t interleave_with_zeros(uint32_t x) {
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+// The distance along a Hilbert curve filling a 65536x65536 grid to the cell (x,y). The usual loop
+// over bits of x and y branches on each of them, unpredictably; this works out the same rotations
+// and flips for all bits at once, as prefix scans.
+// See https://github.com/rawrunprotected/hilbert_curves.
+static uint32_t hilbert_distance(uint32_t x, uint32_t y) {
+    uint32_t A, B, C, D;
+    {
+        uint32_t a = x ^ y,
+                 b = 0xffff ^ a,
+                 c = 0xffff ^ (x | y),
+                 d = x & (y ^ 0xffff);
+        A = a | (b >> 1);
+        B = (a >> 1) ^ a;
+        C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+    }
+    for (int shift : {2, 4}) {
+        uint32_t a = A, b = B, c = C, d = D;
+        A = (a & (a >> shift)) ^ (b & (b >> shift));
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+        D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+    {
+        uint32_t a = A, b = B, c = C, d = D;
+        C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+        D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+    }
+    uint32_t a = C ^ (C >> 1),
+             b = D ^ (D >> 1);
+    uint32_t i0 = x ^ y,
+             i1 = b | (0xffff ^ (i0 | a));
+    return (interleave_with_zeros(i1) << 1) | interleave_with_zeros(i0);
+}
+
+void SkRTree::SortByHilbert(std::vector<Branch>* branches, const SkRect& total) {
+    // Centers are scaled to a 1024x1024 grid, plenty to tell even a million rects apart, and
+    // small enough to sort in two radix passes. Infinite or NaN centers go to the grid's edges.
+    static constexpr int kGridBits = 10;
+    static constexpr uint32_t kGridMax = (1 << kGridBits) - 1;
+    const float sx = kGridMax / total.width(),
+                sy = kGridMax / total.height();
+    auto grid = [](float v) -> uint32_t {
+        return (v > 0 ? (v < kGridMax ? (uint32_t)v : kGridMax) : 0) << (16 - kGridBits);
+    };
+    const size_t count = branches->size();
+    std::vector<uint32_t> keys(count);
+    for (size_t i = 0; i < count; i++) {
+        const SkRect& r = (*branches)[i].fBounds;
+        keys[i] = hilbert_distance(grid((r.centerX() - total.fLeft) * sx),
+                                   grid((r.centerY() - total.fTop)  * sy)) >> 2*(16 - kGridBits);
+    }
+
+    // The radix sort moves the branches along with their keys in a few streams, where sorting
+    // indices and then gathering the branches would miss the cache for each one. Being stable, it
+    // keeps branches with the same key in input order.
+    static constexpr int kRadixBits = kGridBits;
+    static constexpr uint32_t kRadixMask = (1 << kRadixBits) - 1;
+    std::vector<uint32_t> scratchKeys(count);
+    std::vector<Branch> scratch(count);
+    for (int shift = 0; shift < 2*kGridBits; shift += kRadixBits) {
+        size_t starts[kRadixMask + 2] = {};
+        for (uint32_t key : keys) {
+            starts[((key >> shift) & kRadixMask) + 1]++;
+        }
+        for (uint32_t i = 1; i < kRadixMask + 2; i++) {
+            starts[i] += starts[i - 1];
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t to = starts[(keys[i] >> shift) & kRadixMask]++;
+            scratchKeys[to] = keys[i];
+            scratch[to] = (*branches)[i];
+        }
+        keys.swap(scratchKeys);
+        branches->swap(scratch);
+    }
+}
 
 void SkRTree::insert(const SkRect boundsArray[], int N) {
     SkASSERT(0 == fCount);
+    fNodes.clear();
+    fFreeNodes.clear();
 
     std::vector<Branch> branches;
     branches.reserve(N);
 
+    SkRect total = SkRect::MakeEmpty();
     for (int i = 0; i < N; i++) {
         const SkRect& bounds = boundsArray[i];
         if (bounds.isEmpty()) {
@@ -23,19 +154,27 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch b;
         b.fBounds = bounds;
-        b.fOpIndex = i;
+        b.fIndex = i;
         branches.push_back(b);
+        total.join(bounds);
     }
 
     fCount = (int)branches.size();
+    fInOrder = fBulkLoad == BulkLoad::kInputOrder;
+    fLeavesIndexed = false;
+
+    if (fBulkLoad == BulkLoad::kHilbert && fCount > 1) {
+        SortByHilbert(&branches, total);
+    }
+
     if (fCount) {
         if (1 == fCount) {
             fNodes.reserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
+            int n = this->allocateNodeAtLevel(0);
+            fNodes[n].fNumChildren = 1;
+            fNodes[n].set(0, branches[0]);
+            fRoot.fIndex  = n;
+            fRoot.fBounds = branches[0].fBounds;
         } else {
             fNodes.reserve(CountNodes(fCount));
             fRoot = this->bulkLoad(&branches);
@@ -43,14 +182,24 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
     }
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
-    SkDEBUGCODE(Node* p = fNodes.data());
-    fNodes.push_back(Node{});
-    Node& out = fNodes.back();
-    SkASSERT(fNodes.data() == p);  // If this fails, we didn't reserve() enough.
+int SkRTree::allocateNodeAtLevel(uint16_t level) {
+    int n;
+    if (fFreeNodes.empty()) {
+        n = (int)fNodes.size();
+        fNodes.push_back(Node{});
+    } else {
+        n = fFreeNodes.back();
+        fFreeNodes.pop_back();
+    }
+    Node& out = fNodes[n];
+    out.fParent = -1;
     out.fNumChildren = 0;
     out.fLevel = level;
-    return &out;
+    return n;
+}
+
+void SkRTree::freeNode(int node) {
+    fFreeNodes.push_back(node);
 }
 
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
@@ -125,17 +274,18 @@ SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
                 remainder -= kMaxChildren - kMinChildren;
             }
         }
-        Node* n = allocateNodeAtLevel(level);
-        n->fNumChildren = 1;
-        n->fChildren[0] = (*branches)[currentBranch];
         Branch b;
+        b.fIndex = this->allocateNodeAtLevel(level);
         b.fBounds = (*branches)[currentBranch].fBounds;
-        b.fSubtree = n;
-        ++currentBranch;
-        for (int k = 1; k < incrementBy && currentBranch < (int)branches->size(); ++k) {
-            b.fBounds.join((*branches)[currentBranch].fBounds);
-            n->fChildren[k] = (*branches)[currentBranch];
-            ++n->fNumChildren;
+        Node& n = fNodes[b.fIndex];
+        for (int k = 0; k < incrementBy && currentBranch < (int)branches->size(); ++k) {
+            const Branch& child = (*branches)[currentBranch];
+            b.fBounds.join(child.fBounds);
+            n.set(k, child);
+            ++n.fNumChildren;
+            if (level > 0) {
+                fNodes[child.fIndex].fParent = b.fIndex;
+            }
             ++currentBranch;
         }
         (*branches)[newBranches] = b;
@@ -146,27 +296,302 @@ SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
 }
 
 void SkRTree::search(const SkRect& query, std::vector<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+    const size_t start = results->size();
+    this->search(query, [results](int index) { results->push_back(index); });
+    if (!fInOrder) {
+        std::sort(results->begin() + start, results->end());
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push_back(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::indexLeaves() {
+    if (fLeavesIndexed) {
+        return;
+    }
+    // Only a bulk load leaves this to do, and it leaves no free nodes.
+    SkASSERT(fFreeNodes.empty());
+    fLeafOf.clear();
+    for (int n = 0; n < (int)fNodes.size(); ++n) {
+        const Node& node = fNodes[n];
+        for (int i = 0; node.fLevel == 0 && i < node.fNumChildren; ++i) {
+            if (node.fChildren[i] >= (int)fLeafOf.size()) {
+                fLeafOf.resize(node.fChildren[i] + 1, -1);
+            }
+            fLeafOf[node.fChildren[i]] = n;
+        }
+    }
+    fLeavesIndexed = true;
+}
+
+void SkRTree::insert(int index, const SkRect& bounds) {
+    SkASSERT(index >= 0);
+    if (bounds.isEmpty()) {
+        return;
+    }
+    this->indexLeaves();
+    if (index >= (int)fLeafOf.size()) {
+        fLeafOf.resize(index + 1, -1);
+    }
+    SkASSERT(fLeafOf[index] < 0);
+
+    if (fCount == 0) {
+        fNodes.clear();
+        fFreeNodes.clear();
+        fInOrder = true;
+        fRoot = {bounds, this->allocateNodeAtLevel(0)};
+    } else {
+        fInOrder = false;
+    }
+    this->insertBranch({bounds, index}, 0);
+    fCount++;
+}
+
+void SkRTree::remove(int index) {
+    this->indexLeaves();
+    if (index < 0 || index >= (int)fLeafOf.size() || fLeafOf[index] < 0) {
+        return;
+    }
+    const int leaf = fLeafOf[index];
+    fLeafOf[index] = -1;
+    if (--fCount == 0) {
+        fNodes.clear();
+        fFreeNodes.clear();
+        fInOrder = true;
+        fRoot = {SkRect::MakeEmpty(), -1};
+        return;
+    }
+    this->removeChild(leaf, fNodes[leaf].find(index));
+}
+
+void SkRTree::update(int index, const SkRect& bounds) {
+    if (bounds.isEmpty()) {
+        this->remove(index);
+        return;
+    }
+    this->indexLeaves();
+    const int leaf = index < (int)fLeafOf.size() ? fLeafOf[index] : -1;
+    if (leaf < 0) {
+        this->insert(index, bounds);
+        return;
+    }
+
+    // Moves within the leaf's bounds stay put; anything else has to find a new leaf.
+    Node& node = fNodes[leaf];
+    if (node.bounds().contains(bounds)) {
+        node.set(node.find(index), {bounds, index});
+        this->updateBounds(leaf);
+    } else {
+        this->remove(index);
+        this->insert(index, bounds);
+    }
+}
+
+void SkRTree::insertBranch(const Branch& branch, int level) {
+    int n = fRoot.fIndex;
+    while (fNodes[n].fLevel > level) {
+        n = fNodes[n].fChildren[this->chooseSubtree(fNodes[n], branch.fBounds)];
+    }
+    SkASSERT(fNodes[n].fLevel == level);
+    this->addChild(n, branch);
+}
+
+int SkRTree::chooseSubtree(const Node& node, const SkRect& bounds) const {
+    // Pick the child whose area grows least to take bounds, then the smallest.
+    int best = 0;
+    float bestGrowth = SK_FloatInfinity,
+          bestArea   = SK_FloatInfinity;
+    for (int i = 0; i < node.fNumChildren; ++i) {
+        const float area = (node.fRight[i] - node.fLeft[i]) * (node.fBottom[i] - node.fTop[i]);
+        const float grown = (std::max(node.fRight[i],  bounds.fRight) -
+                             std::min(node.fLeft[i],   bounds.fLeft)) *
+                            (std::max(node.fBottom[i], bounds.fBottom) -
+                             std::min(node.fTop[i],    bounds.fTop));
+        const float growth = grown - area;
+        if (growth < bestGrowth || (growth == bestGrowth && area < bestArea)) {
+            best = i;
+            bestGrowth = growth;
+            bestArea = area;
+        }
+    }
+    return best;
+}
+
+void SkRTree::adopt(int node, int child) {
+    if (fNodes[node].fLevel == 0) {
+        fLeafOf[child] = node;
+    } else {
+        fNodes[child].fParent = node;
+    }
+}
+
+static float half_perimeters(const SkRect& a, const SkRect& b) {
+    return a.width() + a.height() + b.width() + b.height();
+}
+
+// Sorts branches so that the first and second halves make the best split: along whichever axis
+// gives the halves the smaller total perimeter, as R*-trees choose a split axis.
+void SkRTree::SplitInHalf(Branch branches[], int N) {
+    auto joined = [branches](int start, int end) {
+        SkRect bounds = branches[start].fBounds;
+        for (int i = start + 1; i < end; ++i) {
+            bounds.join(branches[i].fBounds);
+        }
+        return bounds;
+    };
+    // Sorting by both edges is a strict ordering even for infinite bounds, unlike by centers.
+    auto byY = [](const Branch& a, const Branch& b) {
+        return a.fBounds.fTop < b.fBounds.fTop ||
+              (a.fBounds.fTop == b.fBounds.fTop && a.fBounds.fBottom < b.fBounds.fBottom);
+    };
+    auto byX = [](const Branch& a, const Branch& b) {
+        return a.fBounds.fLeft < b.fBounds.fLeft ||
+              (a.fBounds.fLeft == b.fBounds.fLeft && a.fBounds.fRight < b.fBounds.fRight);
+    };
+    std::sort(branches, branches + N, byY);
+    const float splitY = half_perimeters(joined(0, N/2), joined(N/2, N));
+    std::sort(branches, branches + N, byX);
+    const float splitX = half_perimeters(joined(0, N/2), joined(N/2, N));
+    if (splitY < splitX) {
+        std::sort(branches, branches + N, byY);
+    }
+}
+
+void SkRTree::addChild(int n, const Branch& branch) {
+    {
+        Node& node = fNodes[n];
+        if (node.fNumChildren < kMaxChildren) {
+            node.set(node.fNumChildren++, branch);
+            this->adopt(n, branch.fIndex);
+            this->updateBounds(n);
+            return;
+        }
+    }
+
+    // The node is full, so we split it and its new child between it and a new sibling.
+    static constexpr int kSplit = kMaxChildren + 1;
+    static_assert(kSplit / 2 >= kMinChildren, "Splits must leave both nodes full enough.");
+    Branch branches[kSplit];
+    for (int i = 0; i < kMaxChildren; ++i) {
+        branches[i] = {fNodes[n].bounds(i), fNodes[n].fChildren[i]};
+    }
+    branches[kMaxChildren] = branch;
+    SplitInHalf(branches, kSplit);
+
+    const uint16_t level = fNodes[n].fLevel;
+    const int sibling = this->allocateNodeAtLevel(level);
+    fNodes[n].fNumChildren = 0;
+    for (int i = 0; i < kSplit; ++i) {
+        const int to = i < kSplit / 2 ? n : sibling;
+        Node& node = fNodes[to];
+        node.set(node.fNumChildren++, branches[i]);
+        this->adopt(to, branches[i].fIndex);
+    }
+
+    if (n == fRoot.fIndex) {
+        const int root = this->allocateNodeAtLevel(level + 1);
+        for (int child : {n, sibling}) {
+            Node& node = fNodes[root];
+            node.set(node.fNumChildren++, {fNodes[child].bounds(), child});
+            fNodes[child].fParent = root;
+        }
+        fRoot = {fNodes[root].bounds(), root};
+    } else {
+        // Adding the sibling to the parent grows the bounds above it to cover both halves.
+        Node& parent = fNodes[fNodes[n].fParent];
+        parent.set(parent.find(n), {fNodes[n].bounds(), n});
+        this->addChild(fNodes[n].fParent, {fNodes[sibling].bounds(), sibling});
+    }
+}
+
+void SkRTree::updateBounds(int n) {
+    for (int p = fNodes[n].fParent; p >= 0; n = p, p = fNodes[p].fParent) {
+        const SkRect bounds = fNodes[n].bounds();
+        Node& parent = fNodes[p];
+        const int slot = parent.find(n);
+        if (parent.bounds(slot) == bounds) {
+            return;
+        }
+        parent.set(slot, {bounds, n});
+    }
+    fRoot.fBounds = fNodes[n].bounds();
+}
+
+void SkRTree::removeChild(int n, int slot) {
+    fNodes[n].remove(slot);
+
+    // Underfull nodes are cut loose, and what's under them reinserted once the tree is whole.
+    int orphans[kMaxDepth];
+    int orphanCount = 0;
+    while (n != fRoot.fIndex && fNodes[n].fNumChildren < kMinChildren) {
+        const int parent = fNodes[n].fParent;
+        fNodes[parent].remove(fNodes[parent].find(n));
+        orphans[orphanCount++] = n;
+        n = parent;
+    }
+    this->updateBounds(n);
+
+    // Higher orphans go back first, so lower ones have somewhere at their level to go.
+    for (int i = orphanCount; i --> 0;) {
+        const Node orphan = fNodes[orphans[i]];
+        this->freeNode(orphans[i]);
+        for (int c = 0; c < orphan.fNumChildren; ++c) {
+            this->insertBranch({orphan.bounds(c), orphan.fChildren[c]}, orphan.fLevel);
+        }
+        fInOrder = false;
+    }
+
+    // A root with only one child can hand over to it.
+    while (fNodes[fRoot.fIndex].fLevel > 0 && fNodes[fRoot.fIndex].fNumChildren == 1) {
+        const int child = fNodes[fRoot.fIndex].fChildren[0];
+        this->freeNode(fRoot.fIndex);
+        fNodes[child].fParent = -1;
+        fRoot.fIndex = child;
+    }
+}
+
+bool SkRTree::isValid() const {
+    if (fCount == 0) {
+        return true;
+    }
+    const Node& root = fNodes[fRoot.fIndex];
+    if (root.fParent != -1 || fRoot.fBounds != root.bounds()) {
+        return false;
+    }
+
+    int entries = 0;
+    std::vector<int> stack = {fRoot.fIndex};
+    while (!stack.empty()) {
+        const int n = stack.back();
+        stack.pop_back();
+        const Node& node = fNodes[n];
+        if (node.fNumChildren > kMaxChildren ||
+            (n != fRoot.fIndex && node.fNumChildren < kMinChildren)) {
+            return false;
+        }
+        for (int i = 0; i < node.fNumChildren; ++i) {
+            const int c = node.fChildren[i];
+            if (node.fLevel == 0) {
+                entries++;
+                if (fLeavesIndexed && fLeafOf[c] != n) {
+                    return false;
+                }
+                continue;
+            }
+            const Node& child = fNodes[c];
+            if (child.fLevel + 1 != node.fLevel || child.fParent != n ||
+                child.bounds() != node.bounds(i)) {
+                return false;
             }
+            stack.push_back(c);
         }
     }
+    return entries == fCount;
 }
 
 size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
     byteCount += fNodes.capacity() * sizeof(Node);
+    byteCount += (fFreeNodes.capacity() + fLeafOf.capacity()) * sizeof(int);
 
     return byteCount;
 }
@@ -10,35 +10,69 @@
 
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkRect.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkMathPriv.h"
+
+#include <vector>
 
 /**
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
  *
- * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * It's usually created from a batch of bounding rectangles, with a bottom-up bulk load. By default
+ * that packs the rectangles in the order they're given, which suits pictures, whose draws tend to
+ * come in a reasonable x,y order. BulkLoad::kHilbert instead sorts them by the position of their
+ * centers along a Hilbert curve first, which costs a sort but makes for tighter nodes when the
+ * input has no useful order.
+ *
+ * Single rectangles can also be inserted, removed and updated afterwards, for scenes that change
+ * a little at a time. Inserts go down the subtree whose bounds grow least, and split full nodes
+ * in half along the axis that gives the smaller total perimeter. Removals reinsert the entries of
+ * nodes left with fewer than kMinChildren.
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * TODO: There also exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
  * For more details see:
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *
+ *  Kamel, I.; Faloutsos, C. (1993). "On packing R-trees"
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
-    SkRTree();
+    enum class BulkLoad {
+        kInputOrder,  // Pack rectangles in the order they're given.
+        kHilbert,     // Pack rectangles in the Hilbert curve order of their centers.
+    };
 
+    explicit SkRTree(BulkLoad = BulkLoad::kInputOrder);
+
+    // Bulk loads the tree, which must be empty. Rectangle i is found as index i.
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, std::vector<int>* results) const override;
     size_t bytesUsed() const override;
 
+    // Adds bounds under index, which must be non-negative and not already in the tree. Indices
+    // should be kept reasonably dense: the tree keeps a table from each index to its leaf.
+    // Empty bounds are ignored, as they are by the bulk load.
+    void insert(int index, const SkRect& bounds);
+    // Removes index from the tree, if it's there.
+    void remove(int index);
+    // Moves index to new bounds, inserting it if it isn't in the tree, or removing it if bounds
+    // is empty.
+    void update(int index, const SkRect& bounds);
+
+    // Calls fn(int index) for each index whose bounds intersect query. Indices come in ascending
+    // order only while the tree is as bulk loaded with BulkLoad::kInputOrder; the vector search()
+    // sorts its results when they may not.
+    template <typename Fn>
+    void search(const SkRect& query, Fn&& fn) const;
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[fRoot.fIndex].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -46,24 +80,47 @@ public:
     static const int kMinChildren = 6,
                      kMaxChildren = 11;
 
+    // Checks that every node's bounds are the union of its children's, that every node but the
+    // root has at least kMinChildren children, and that leaves are all at the same depth.
+    bool isValid() const;
+
 private:
-    struct Node;
+    // Child bounds are stored by edge, kLanes at a time, so a node is tested against a query a
+    // few children at a time.
+    static constexpr int kLanes = (kMaxChildren + 3) & ~3;
+    // Nodes have at least kMinChildren children, so even INT_MAX entries stay well under this.
+    static constexpr int kMaxDepth = 32;
+
+    using F4 = skvx::Vec<4, float>;
+    using I4 = skvx::Vec<4, int32_t>;
 
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
         SkRect fBounds;
+        int    fIndex;  // An index given by the caller for entries, or of a node in fNodes.
     };
 
     struct Node {
+        float    fLeft[kLanes], fTop[kLanes], fRight[kLanes], fBottom[kLanes];
+        int      fChildren[kLanes];  // Caller indices in leaves (level 0), else node indices.
+        int      fParent;            // -1 for the root.
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+
+        SkRect bounds(int i) const {
+            return {fLeft[i], fTop[i], fRight[i], fBottom[i]};
+        }
+        SkRect bounds() const;
+        void set(int i, const Branch&);
+        // Removes child i, keeping the rest in order.
+        void remove(int i);
+        int find(int child) const;
+
+        // Bit i is set if child i intersects the query, which must not be empty.
+        uint32_t intersecting(const F4& query) const;
     };
 
-    void search(Node* root, const SkRect& query, std::vector<int>* results) const;
+    // Sorts branches by the distance of their centers along a Hilbert curve over total.
+    static void SortByHilbert(std::vector<Branch>*, const SkRect& total);
 
     // Consumes the input array.
     Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
@@ -71,12 +128,86 @@ private:
     // How many times will bulkLoad() call allocateNodeAtLevel()?
     static int CountNodes(int branches);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    int allocateNodeAtLevel(uint16_t level);
+    void freeNode(int node);
+
+    // Adds branch to a node at level, splitting nodes on the way back up as needed.
+    void insertBranch(const Branch&, int level);
+    void addChild(int node, const Branch&);
+    int chooseSubtree(const Node&, const SkRect& bounds) const;
+    static void SplitInHalf(Branch[], int N);
+    // Makes node the parent of child, or child's leaf if node is a leaf.
+    void adopt(int node, int child);
+    // Refreshes the bounds each of node's ancestors keeps for it, as far up as they change.
+    void updateBounds(int node);
+    // Removes the entry at slot, then reinserts what's under any nodes that leaves underfull.
+    void removeChild(int node, int slot);
+
+    // Builds fLeafOf, which a bulk load leaves to the first incremental change.
+    void indexLeaves();
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
+    BulkLoad fBulkLoad;
+    // Whether a depth-first walk finds indices in ascending order.
+    bool fInOrder;
+    bool fLeavesIndexed;
     Branch fRoot;
     std::vector<Node> fNodes;
+    std::vector<int> fFreeNodes;
+    std::vector<int> fLeafOf;  // Caller index -> leaf node, or -1.
 };
 
+inline uint32_t SkRTree::Node::intersecting(const F4& query) const {
+    // With non-empty bounds on both sides, SkRect::Intersects() comes down to these four tests.
+    const F4 l = query[0], t = query[1], r = query[2], b = query[3];
+    uint32_t hits = 0;
+    for (int i = 0; i < kLanes; i += 4) {
+        I4 hit = (F4::Load(fLeft   + i) < r) &
+                 (F4::Load(fTop    + i) < b) &
+                 (l < F4::Load(fRight  + i)) &
+                 (t < F4::Load(fBottom + i));
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE1
+        hits |= (uint32_t)_mm_movemask_ps(skvx::bit_pun<__m128>(hit)) << i;
+#else
+        hit &= I4{1, 2, 4, 8};
+        hits |= (uint32_t)(hit[0] | hit[1] | hit[2] | hit[3]) << i;
+#endif
+    }
+    return hits & ((1u << fNumChildren) - 1);
+}
+
+template <typename Fn>
+void SkRTree::search(const SkRect& query, Fn&& fn) const {
+    if (fCount == 0 || !SkRect::Intersects(fRoot.fBounds, query)) {
+        return;
+    }
+    const F4 q = F4::Load(&query.fLeft);
+
+    // Each frame holds a node and the children of it left to visit.
+    struct Frame {
+        const Node* fNode;
+        uint32_t    fHits;
+    };
+    Frame stack[kMaxDepth];
+    int depth = 0;
+    stack[0] = {&fNodes[fRoot.fIndex], fNodes[fRoot.fIndex].intersecting(q)};
+    while (depth >= 0) {
+        Frame& frame = stack[depth];
+        if (frame.fNode->fLevel == 0) {
+            for (uint32_t hits = frame.fHits; hits; hits &= hits - 1) {
+                fn(frame.fNode->fChildren[SkCTZ(hits)]);
+            }
+            depth--;
+        } else if (frame.fHits) {
+            const Node* child = &fNodes[frame.fNode->fChildren[SkCTZ(frame.fHits)]];
+            frame.fHits &= frame.fHits - 1;
+            SkASSERT(depth + 1 < kMaxDepth);
+            stack[++depth] = {child, child->intersecting(q)};
+        } else {
+            depth--;
+        }
+    }
+}
+
 #endif
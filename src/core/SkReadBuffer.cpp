@@ -11,7 +11,6 @@
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
-#include "src/core/SkAutoMalloc.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkReadBuffer.h"
@@ -41,6 +40,17 @@ void SkReadBuffer::setMemory(const void* data, size_t size) {
         fBase = fCurr = (const char*)data;
         fStop = fBase + size;
     }
+    fData = nullptr;
+}
+
+void SkReadBuffer::setMemory(sk_sp<SkData> data) {
+    if (!this->validate(data != nullptr)) {
+        return;
+    }
+    this->setMemory(data->data(), data->size());
+    if (!fError) {
+        fData = std::move(data);
+    }
 }
 
 void SkReadBuffer::setInvalid() {
@@ -263,6 +273,39 @@ bool SkReadBuffer::readScalarArray(SkScalar* values, size_t size) {
     return this->readArray(values, size, sizeof(SkScalar));
 }
 
+template <typename T> SkSpan<const T> SkReadBuffer::readArrayView() {
+    static_assert(alignof(T) <= 4, "The buffer only promises 4-byte alignment.");
+    const uint32_t count = this->readUInt();
+    if (const T* array = this->skipT<T>(count)) {
+        return {array, count};
+    }
+    return {};
+}
+
+SkSpan<const uint8_t> SkReadBuffer::readByteArrayView() {
+    return this->readArrayView<uint8_t>();
+}
+
+SkSpan<const SkColor> SkReadBuffer::readColorArrayView() {
+    return this->readArrayView<SkColor>();
+}
+
+SkSpan<const SkColor4f> SkReadBuffer::readColor4fArrayView() {
+    return this->readArrayView<SkColor4f>();
+}
+
+SkSpan<const int32_t> SkReadBuffer::readIntArrayView() {
+    return this->readArrayView<int32_t>();
+}
+
+SkSpan<const SkPoint> SkReadBuffer::readPointArrayView() {
+    return this->readArrayView<SkPoint>();
+}
+
+SkSpan<const SkScalar> SkReadBuffer::readScalarArrayView() {
+    return this->readArrayView<SkScalar>();
+}
+
 const void* SkReadBuffer::skipByteArray(size_t* size) {
     const uint32_t count = this->readUInt();
     const void* buf = this->skip(count);
@@ -273,16 +316,20 @@ const void* SkReadBuffer::skipByteArray(size_t* size) {
 }
 
 sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
-    size_t numBytes = this->getArrayCount();
-    if (!this->validate(this->isAvailable(numBytes))) {
+    size_t numBytes;
+    const void* bytes = this->skipByteArray(&numBytes);
+    if (!bytes) {
         return nullptr;
     }
+    return this->dataAt(bytes, numBytes);
+}
 
-    SkAutoMalloc buffer(numBytes);
-    if (!this->readByteArray(buffer.get(), numBytes)) {
-        return nullptr;
+sk_sp<SkData> SkReadBuffer::dataAt(const void* addr, size_t size) const {
+    if (fData) {
+        // The subset refs fData, so it stays valid however long it outlives this buffer.
+        return SkData::MakeSubset(fData.get(), (const char*)addr - fBase, size);
     }
-    return SkData::MakeFromMalloc(buffer.release(), numBytes);
+    return SkData::MakeWithCopy(addr, size);
 }
 
 uint32_t SkReadBuffer::getArrayCount() {
@@ -331,18 +378,13 @@ sk_sp<SkImage> SkReadBuffer::readImage_preV78() {
         return nullptr;
     }
 
-    // Preflight check to make sure there's enough stuff in the buffer before
-    // we allocate the memory. This helps the fuzzer avoid OOM when it creates
-    // bad/corrupt input.
-    if (!this->validateCanReadN<uint8_t>(size)) {
-        return nullptr;
-    }
-
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
-        this->validate(false);
+    // Nothing is allocated until skip() has checked the buffer really holds size bytes, so
+    // corrupt sizes can't run the fuzzer out of memory.
+    const void* bytes = this->skip(size);
+    if (!this->validate(bytes != nullptr)) {
         return nullptr;
     }
+    sk_sp<SkData> data = this->dataAt(bytes, size);
 
     sk_sp<SkImage> image;
     if (fProcs.fImageProc) {
@@ -370,47 +412,58 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
         return this->readImage_preV78();
     }
 
-    uint32_t flags = this->read32();
+    EncodedImage encoded;
+    if (!this->readEncodedImage(&encoded)) {
+        return nullptr;
+    }
+    return DecodeImage(std::move(encoded), fProcs);
+}
+
+bool SkReadBuffer::readEncodedImage(EncodedImage* encoded) {
+    SkASSERT(!this->isVersionLT(SkPicturePriv::kSerializeMipmaps_Version));
 
-    sk_sp<SkImage> image;
-    {
-        sk_sp<SkData> data = this->readByteArrayAsData();
-        if (!data) {
+    encoded->fFlags = this->read32();
+    encoded->fEncoded = this->readByteArrayAsData();
+    if (!encoded->fEncoded) {
+        this->validate(false);
+        return false;
+    }
+    if (encoded->fFlags & SkWriteBufferImageFlags::kHasSubsetRect) {
+        this->readIRect(&encoded->fSubset);
+    }
+    if (encoded->fFlags & SkWriteBufferImageFlags::kHasMipmap) {
+        encoded->fMipmap = this->readByteArrayAsData();
+        if (!encoded->fMipmap) {
             this->validate(false);
-            return nullptr;
-        }
-        if (fProcs.fImageProc) {
-            image = fProcs.fImageProc(data->data(), data->size(), fProcs.fImageCtx);
-        }
-        if (!image) {
-            image = SkImage::MakeFromEncoded(std::move(data));
+            return false;
         }
     }
+    return this->isValid();
+}
 
-    if (flags & SkWriteBufferImageFlags::kHasSubsetRect) {
-        SkIRect subset;
-        this->readIRect(&subset);
-        if (image) {
-            image = image->makeSubset(subset);
-        }
+sk_sp<SkImage> SkReadBuffer::DecodeImage(EncodedImage encoded, const SkDeserialProcs& procs) {
+    sk_sp<SkImage> image;
+    if (procs.fImageProc) {
+        image = procs.fImageProc(encoded.fEncoded->data(), encoded.fEncoded->size(),
+                                 procs.fImageCtx);
+    }
+    if (!image) {
+        image = SkImage::MakeFromEncoded(std::move(encoded.fEncoded));
     }
 
-    if (flags & SkWriteBufferImageFlags::kHasMipmap) {
-        sk_sp<SkData> data = this->readByteArrayAsData();
-        if (!data) {
-            this->validate(false);
-            return nullptr;
-        }
-        if (image) {
-            SkMipmapBuilder builder(image->imageInfo());
-            if (SkMipmap::Deserialize(&builder, data->data(), data->size())) {
-                // TODO: need to make lazy images support mips
-                if (auto ri = image->makeRasterImage()) {
-                    image = ri;
-                }
-                image = builder.attachTo(image);
-                SkASSERT(image);    // withMipmaps should never return null
+    if (image && (encoded.fFlags & SkWriteBufferImageFlags::kHasSubsetRect)) {
+        image = image->makeSubset(encoded.fSubset);
+    }
+
+    if (image && (encoded.fFlags & SkWriteBufferImageFlags::kHasMipmap)) {
+        SkMipmapBuilder builder(image->imageInfo());
+        if (SkMipmap::Deserialize(&builder, encoded.fMipmap->data(), encoded.fMipmap->size())) {
+            // TODO: need to make lazy images support mips
+            if (auto ri = image->makeRasterImage()) {
+                image = ri;
             }
+            image = builder.attachTo(image);
+            SkASSERT(image);    // withMipmaps should never return null
         }
     }
     return image ? image : MakeEmptyImage(1, 1);
@@ -21,6 +21,7 @@
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkPaintPriv.h"
 #include "src/core/SkPicturePriv.h"
+#include "src/core/SkSpan.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/shaders/SkShaderBase.h"
 
@@ -33,8 +34,16 @@ public:
     SkReadBuffer(const void* data, size_t size) {
         this->setMemory(data, size);
     }
+    explicit SkReadBuffer(sk_sp<SkData> data) {
+        this->setMemory(std::move(data));
+    }
 
     void setMemory(const void*, size_t);
+    /**
+     *  Reads from data, keeping a ref on it. Byte arrays read as SkData then share data's memory
+     *  rather than copying it, so the buffer's SkData may be a mapped file, say.
+     */
+    void setMemory(sk_sp<SkData> data);
 
     /**
      *  Returns true IFF the version is older than the specified version.
@@ -86,6 +95,9 @@ public:
     uint8_t peekByte();
 
     void readString(SkString* string);
+    // Returns the string in the buffer, which is NUL terminated after length characters, or null
+    // if the string isn't valid.
+    const char* readString(size_t* length);
 
     // common data structures
     void readColor4f(SkColor4f* color);
@@ -127,8 +139,19 @@ public:
     bool readPointArray(SkPoint* points, size_t size);
     bool readScalarArray(SkScalar* values, size_t size);
 
+    // Views of the arrays above, in place in the buffer: no copies, and nothing to size up front.
+    // The views last as long as the buffer's memory. If the data is corrupt they are empty and
+    // the buffer is invalid.
+    SkSpan<const uint8_t>   readByteArrayView();
+    SkSpan<const SkColor>   readColorArrayView();
+    SkSpan<const SkColor4f> readColor4fArrayView();
+    SkSpan<const int32_t>   readIntArrayView();
+    SkSpan<const SkPoint>   readPointArrayView();
+    SkSpan<const SkScalar>  readScalarArrayView();
+
     const void* skipByteArray(size_t* size);
 
+    // If the buffer was set from an SkData, this shares its memory; otherwise it copies.
     sk_sp<SkData> readByteArrayAsData();
 
     // helpers to get info about arrays and binary data
@@ -140,6 +163,19 @@ public:
     sk_sp<SkImage> readImage();
     sk_sp<SkTypeface> readTypeface();
 
+    // readImage() in two steps, for callers that decode several images concurrently:
+    // readEncodedImage() only copies an image's bytes out of the buffer, returning false if the
+    // data is corrupt, and DecodeImage() makes the image from them without touching the buffer.
+    // Only for buffers at kSerializeMipmaps_Version or later.
+    struct EncodedImage {
+        uint32_t      fFlags = 0;
+        sk_sp<SkData> fEncoded;
+        SkIRect       fSubset = SkIRect::MakeEmpty();
+        sk_sp<SkData> fMipmap;
+    };
+    bool readEncodedImage(EncodedImage*);
+    static sk_sp<SkImage> DecodeImage(EncodedImage, const SkDeserialProcs&);
+
     void setTypefaceArray(sk_sp<SkTypeface> array[], int count) {
         fTFArray = array;
         fTFCount = count;
@@ -197,10 +233,11 @@ public:
     SkFilterQuality checkFilterQuality();
 
 private:
-    const char* readString(size_t* length);
-
     void setInvalid();
     bool readArray(void* value, size_t size, size_t elementSize);
+    template <typename T> SkSpan<const T> readArrayView();
+    // Makes data of size bytes at addr, somewhere in the buffer.
+    sk_sp<SkData> dataAt(const void* addr, size_t size) const;
     bool isAvailable(size_t size) const { return size <= this->available(); }
 
     sk_sp<SkImage> readImage_preV78();
@@ -209,6 +246,7 @@ private:
     const char* fCurr = nullptr;  // current position within buffer
     const char* fStop = nullptr;  // end of buffer
     const char* fBase = nullptr;  // beginning of buffer
+    sk_sp<SkData> fData;          // holds the buffer, if set from an SkData
 
     // Only used if we do not have an fFactoryArray.
     SkTHashMap<uint32_t, SkFlattenable::Factory> fFlattenableDict;
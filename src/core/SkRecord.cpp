@@ -35,3 +35,10 @@ void SkRecord::defrag() {
                                    [](Record op) { return op.type() == SkRecords::NoOp_Type; });
     fCount = noops - fRecords.get();
 }
+
+void SkRecord::shrinkToFit() {
+    if (fCount > 0 && fCount < fReserved) {
+        fReserved = fCount;
+        fRecords.realloc(fReserved);
+    }
+}
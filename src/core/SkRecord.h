@@ -55,11 +55,7 @@ public:
     // Here T can be any class, not just those from SkRecords.  Throws on failure.
     template <typename T>
     T* alloc(size_t count = 1) {
-        struct RawBytes {
-            alignas(T) char data[sizeof(T)];
-        };
-        fApproxBytesAllocated += count * sizeof(T) + alignof(T);
-        return (T*)fAlloc.makeArrayDefault<RawBytes>(count);
+        return this->allocFrom<T>(&fAlloc, count);
     }
 
     // Add a new command of type T to the end of this SkRecord.
@@ -93,21 +89,28 @@ public:
     // May change count() and the indices of ops, but preserves their order.
     void defrag();
 
+    // Free the unused space at the end of the command array, once no more will be appended.
+    void shrinkToFit();
+
 private:
     // An SkRecord is structured as an array of pointers into a big chunk of memory where
     // records representing each canvas draw call are stored:
     //
-    // fRecords:  [*][*][*]...
-    //             |  |  |
-    //             |  |  |
-    //             |  |  +---------------------------------------+
-    //             |  +-----------------+                        |
-    //             |                    |                        |
-    //             v                    v                        v
-    //   fAlloc:  [SkRecords::DrawRect][SkRecords::DrawPosTextH][SkRecords::DrawRect]...
+    //      fRecords:  [*][*][*]...
+    //                  |  |  |
+    //                  |  |  |
+    //                  |  |  +---------------------------------------+
+    //                  |  +-----------------+                        |
+    //                  |                    |                        |
+    //                  v                    v                        v
+    // fCommandAlloc:  [SkRecords::DrawRect][SkRecords::DrawPosTextH][SkRecords::DrawRect]...
     //
     // We store the types of each of the pointers alongside the pointer.
     // The cost to append a T to this structure is 8 + sizeof(T) bytes.
+    //
+    // Everything else that commands point to (arrays, strings, optional paints...) is allocated
+    // from fAlloc, so the commands themselves sit back to back in recording order, and playback
+    // reads them front to back.
 
     // A mutator that can be used with replace to destroy canvas commands.
     struct Destroyer {
@@ -122,7 +125,18 @@ private:
     }
 
     template <typename T>
-    std::enable_if_t<!std::is_empty<T>::value, T*> allocCommand() { return this->alloc<T>(); }
+    std::enable_if_t<!std::is_empty<T>::value, T*> allocCommand() {
+        return this->allocFrom<T>(&fCommandAlloc, 1);
+    }
+
+    template <typename T>
+    T* allocFrom(SkArenaAlloc* arena, size_t count) {
+        struct RawBytes {
+            alignas(T) char data[sizeof(T)];
+        };
+        fApproxBytesAllocated += count * sizeof(T) + alignof(T);
+        return (T*)arena->makeArrayDefault<RawBytes>(count);
+    }
 
     void grow();
 
@@ -172,9 +186,10 @@ private:
         fReserved{0};
     SkAutoTMalloc<Record> fRecords;
 
-    // fAlloc needs to be a data structure which can append variable length data in contiguous
-    // chunks, returning a stable handle to that data for later retrieval.
+    // fAlloc and fCommandAlloc need to be data structures which can append variable length data
+    // in contiguous chunks, returning a stable handle to that data for later retrieval.
     SkArenaAlloc fAlloc{256};
+    SkArenaAlloc fCommandAlloc{256};
     size_t       fApproxBytesAllocated{0};
 };
 
@@ -7,11 +7,18 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/core/SkM44.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkShader.h"
 #include "include/private/SkTDArray.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
 
+#include <vector>
+
 using namespace SkRecords;
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -286,6 +293,360 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+static constexpr SkRect kUnbounded = SkRect::MakeLTRB(SK_ScalarMin, SK_ScalarMin,
+                                                      SK_ScalarMax, SK_ScalarMax);
+
+// Follows the matrix through an SkRecord, along with an upper bound on the clip in the record's
+// device space.  Feed it every command in order, as a visitor.
+class DeviceStateTracker {
+public:
+    struct State {
+        SkMatrix matrix = SkMatrix::I();
+        bool     matrixIsKnown = true;  // False under a Concat44 that an SkMatrix can't express.
+        SkRect   clipBounds = kUnbounded;
+        bool     clippedAA = false;     // Set once any clip may cover some pixels partially.
+    };
+    const State& state() const { return fState; }
+
+    // Maps rect to device space if the matrix keeps it a rect, returning false if not.
+    bool mapRect(const SkRect& rect, SkRect* device) const {
+        if (!fState.matrixIsKnown || !fState.matrix.rectStaysRect()) {
+            return false;
+        }
+        *device = fState.matrix.mapRect(rect);
+        return true;
+    }
+
+    // Would intersecting the clip with this device space rrect leave it unchanged?
+    bool clipIsWithin(const SkRRect& device, bool aa) const {
+        // Non-AA clips cover whole pixels whose centers are inside them, so if every clip so far
+        // is non-AA, a non-AA clip around them all is a no-op at any scale.  Antialiased edges
+        // spread half a playback pixel, which is any amount of our space once scaled down.
+        return !aa && !fState.clippedAA && device.contains(fState.clipBounds);
+    }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&)       { fSaves.push_back(fState); }
+    void operator()(const SaveLayer&)  { fSaves.push_back(fState); }
+    void operator()(const SaveBehind&) { fSaves.push_back(fState); }
+    void operator()(const Restore& op) {
+        if (!fSaves.empty()) {
+            fState = fSaves.back();
+            fSaves.pop_back();
+        }
+        fState.matrix = op.matrix;
+    }
+
+    void operator()(const SetMatrix& op) {
+        fState.matrix = op.matrix;
+        fState.matrixIsKnown = true;
+    }
+    void operator()(const Concat& op)    { fState.matrix.preConcat(op.matrix); }
+    void operator()(const Scale& op)     { fState.matrix.preScale(op.sx, op.sy); }
+    void operator()(const Translate& op) { fState.matrix.preTranslate(op.dx, op.dy); }
+    void operator()(const Concat44& op) {
+        // Only a 4x4 that leaves z alone composes like its 3x3.
+        const SkMatrix m = op.matrix.asM33();
+        fState.matrix.preConcat(m);
+        fState.matrixIsKnown &= SkM44(m) == op.matrix;
+    }
+
+    void operator()(const ClipRect& op)  { this->clip(op.rect, op.opAA.op(), op.opAA.aa()); }
+    void operator()(const ClipRRect& op) {
+        this->clip(op.rrect.getBounds(), op.opAA.op(), op.opAA.aa());
+    }
+    void operator()(const ClipPath& op) {
+        this->clip(op.path.getBounds(), op.opAA.op(), op.opAA.aa());
+    }
+    // Regions are already in the playback canvas's device space, so they don't shrink our bounds,
+    // but they can still grow them.
+    void operator()(const ClipRegion& op) { this->forgetBoundsIfGrown(op.op); }
+    void operator()(const ClipShader&) { fState.clippedAA = true; }
+
+private:
+    void clip(const SkRect& localBounds, SkClipOp op, bool aa) {
+        fState.clippedAA |= aa;
+        SkRect device;
+        if (op == SkClipOp::kIntersect && fState.matrixIsKnown) {
+            fState.matrix.mapRect(&device, localBounds);
+            if (!fState.clipBounds.intersect(device)) {
+                fState.clipBounds.setEmpty();
+            }
+        }
+        this->forgetBoundsIfGrown(op);
+    }
+
+    // Only intersect and difference can't grow the clip.  The deprecated ops, like replace and
+    // union, can grow it past any bound we had.
+    void forgetBoundsIfGrown(SkClipOp op) {
+        if (op != SkClipOp::kIntersect && op != SkClipOp::kDifference) {
+            fState.clipBounds = kUnbounded;
+        }
+    }
+
+    State              fState;
+    std::vector<State> fSaves;
+};
+
+// Noops intersecting clips that contain the clip that's already in place.
+struct SubsumedClipNooper {
+    DeviceStateTracker fTracker;
+
+    template <typename T> bool operator()(const T& op) {
+        fTracker(op);
+        return false;
+    }
+
+    bool operator()(const ClipRect& op) {
+        SkRect device;
+        if (op.opAA.op() == SkClipOp::kIntersect && fTracker.mapRect(op.rect, &device) &&
+            fTracker.clipIsWithin(SkRRect::MakeRect(device), op.opAA.aa())) {
+            return true;
+        }
+        fTracker(op);
+        return false;
+    }
+
+    bool operator()(const ClipRRect& op) {
+        SkRRect device;
+        if (op.opAA.op() == SkClipOp::kIntersect && fTracker.state().matrixIsKnown &&
+            op.rrect.transform(fTracker.state().matrix, &device) &&
+            fTracker.clipIsWithin(device, op.opAA.aa())) {
+            return true;
+        }
+        fTracker(op);
+        return false;
+    }
+};
+
+void SkRecordNoopSubsumedClips(SkRecord* record) {
+    SubsumedClipNooper pass;
+    for (int i = 0; i < record->count(); i++) {
+        if (record->visit(i, pass)) {
+            record->replace<NoOp>(i);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Does drawing with this paint leave every pixel it covers opaque, whatever was there before?
+static bool is_opaque_fill(const SkPaint& paint) {
+    if (paint.getStyle() != SkPaint::kFill_Style || paint.getPathEffect() ||
+        paint.getMaskFilter() || paint.getColorFilter() || paint.getImageFilter()) {
+        return false;
+    }
+    if (paint.getAlphaf() != 1 || (paint.getShader() && !paint.getShader()->isOpaque())) {
+        return false;
+    }
+    return paint.getBlendMode() == SkBlendMode::kSrcOver ||
+           paint.getBlendMode() == SkBlendMode::kSrc;
+}
+
+// Noops draws that a later opaque DrawRect or DrawPaint paints right over.  Only draws in the same
+// run of draws count, so the two share their matrix, clip and layer, and nothing in between can
+// read the pixels back out.
+struct OccludedDrawNooper {
+    // Past this many, the oldest draws of a run stop being candidates, keeping this linear.
+    static constexpr int kMaxCandidates = 64;
+
+    OccludedDrawNooper(SkRecord* record, const SkRect bounds[])
+        : fRecord(record), fBounds(bounds) {}
+
+    void run() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->visit(fIndex, *this);
+        }
+    }
+
+    void operator()(const NoOp&) {}
+
+    void operator()(const DrawRect& op) {
+        SkRect device;
+        if (this->canOcclude(op.paint) && fTracker.mapRect(op.rect, &device)) {
+            this->occlude([&](const SkRect& bounds) {
+                // Bounds are in the same device space, but the draw touches every pixel they do.
+                return device.contains(SkRect::Make(bounds.roundOut()));
+            });
+        }
+        this->addCandidate();
+    }
+
+    void operator()(const DrawPaint& op) {
+        if (this->canOcclude(op.paint)) {
+            this->occlude([](const SkRect&) { return true; });
+        }
+        this->addCandidate();
+    }
+
+    // These draw other content that may read back the pixels under them, e.g. with a backdrop.
+    void operator()(const DrawPicture&)  { fCandidates.clear(); }
+    void operator()(const DrawDrawable&) { fCandidates.clear(); }
+    void operator()(const DrawBehind&)   { fCandidates.clear(); }
+
+    template <typename T>
+    std::enable_if_t<(T::kTags & kDraw_Tag), void> operator()(const T&) {
+        this->addCandidate();
+    }
+
+    // Anything that doesn't draw changes state or has some other effect, and ends the run.
+    template <typename T>
+    std::enable_if_t<!(T::kTags & kDraw_Tag), void> operator()(const T& op) {
+        fTracker(op);
+        fCandidates.clear();
+    }
+
+private:
+    // An antialiased clip or paint only partly covers the pixels along its edge, so even an
+    // opaque draw leaves some of what's under it showing there.  Edges that fall between our
+    // pixels won't once playback scales.
+    bool canOcclude(const SkPaint& paint) const {
+        return is_opaque_fill(paint) && !paint.isAntiAlias() && !fTracker.state().clippedAA;
+    }
+
+    template <typename Fn>
+    void occlude(Fn&& covers) {
+        int kept = 0;
+        for (int candidate : fCandidates) {
+            if (covers(fBounds[candidate])) {
+                fRecord->replace<NoOp>(candidate);
+            } else {
+                fCandidates[kept++] = candidate;
+            }
+        }
+        fCandidates.resize(kept);
+    }
+
+    void addCandidate() {
+        if (fCandidates.size() == kMaxCandidates) {
+            fCandidates.erase(fCandidates.begin());
+        }
+        fCandidates.push_back(fIndex);
+    }
+
+    SkRecord*          fRecord;
+    const SkRect*      fBounds;
+    int                fIndex = 0;
+    DeviceStateTracker fTracker;
+    std::vector<int>   fCandidates;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    // Bounds are only compared with what occludes them, so they need no cull.
+    SkAutoTMalloc<SkRect> bounds(record->count());
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record->count());
+    SkRecordFillBounds(kUnbounded, *record, bounds, meta);
+
+    OccludedDrawNooper pass(record, bounds);
+    pass.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Can this paint draw an image as part of a DrawEdgeAAImageSet?
+static bool can_draw_image_set(const SkPaint* paint) {
+    // An image filter would filter the whole set at once, not each image.
+    return !paint || (paint->getStyle() == SkPaint::kFill_Style && !paint->getPathEffect() &&
+                      !paint->getShader() && !paint->getMaskFilter() && !paint->getImageFilter());
+}
+
+// Replaces runs of DrawImage and DrawImageRect with the same paint by one DrawEdgeAAImageSet,
+// which draws each image as if it used the paint on its own.
+struct ImageDrawMerger {
+    explicit ImageDrawMerger(SkRecord* record) : fRecord(record) {}
+
+    void run() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->visit(fIndex, *this);
+        }
+        this->flush();
+    }
+
+    void operator()(const NoOp&) {}
+
+    void operator()(const DrawImage& op) {
+        const SkRect src = SkRect::Make(op.image->bounds());
+        // Sampling the whole image is the same under either constraint.
+        this->add(op.paint, op.image.get(), src, src.makeOffset(op.left, op.top), nullptr);
+    }
+
+    void operator()(const DrawImageRect& op) {
+        const SkRect src = op.src ? *op.src : SkRect::Make(op.image->bounds());
+        this->add(op.paint, op.image.get(), src, op.dst, &op.constraint);
+    }
+
+    template <typename T> void operator()(const T&) { this->flush(); }
+
+private:
+    struct Entry {
+        int            index;
+        const SkImage* image;
+        SkRect         src, dst;
+    };
+
+    void add(const SkPaint* paint, const SkImage* image, const SkRect& src, const SkRect& dst,
+             const SkCanvas::SrcRectConstraint* constraint) {
+        // Image sets don't clip src to the image, nor sort rects, as drawImageRect() does.
+        if (!can_draw_image_set(paint) || src.isEmpty() || dst.isEmpty() ||
+            !SkRect::Make(image->bounds()).contains(src)) {
+            this->flush();
+            return;
+        }
+        const bool samePaint = fPaint ? paint && *paint == *fPaint : !paint;
+        if (!samePaint || (constraint && fConstraint && *constraint != *fConstraint)) {
+            this->flush();
+        }
+        if (fRun.empty()) {
+            fPaint = paint;
+        }
+        if (constraint) {
+            fConstraint = constraint;
+        }
+        fRun.push_back({fIndex, image, src, dst});
+    }
+
+    void flush() {
+        const int count = SkToInt(fRun.size());
+        if (count > 1) {
+            const unsigned aa = fPaint && fPaint->isAntiAlias() ? SkCanvas::kAll_QuadAAFlags
+                                                                : SkCanvas::kNone_QuadAAFlags;
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(count);
+            for (int i = 0; i < count; i++) {
+                set[i] = SkCanvas::ImageSetEntry(sk_ref_sp(fRun[i].image), fRun[i].src,
+                                                 fRun[i].dst, 1.0f, aa);
+            }
+            SkPaint* paint = fPaint ? new (fRecord->alloc<SkPaint>()) SkPaint(*fPaint) : nullptr;
+            const SkCanvas::SrcRectConstraint constraint =
+                    fConstraint ? *fConstraint : SkCanvas::kStrict_SrcRectConstraint;
+
+            // The set holds its own refs on the images, and copies of everything else we need.
+            for (int i = 1; i < count; i++) {
+                fRecord->replace<NoOp>(fRun[i].index);
+            }
+            new (fRecord->replace<DrawEdgeAAImageSet>(fRun[0].index))
+                    DrawEdgeAAImageSet{paint, std::move(set), count, nullptr, nullptr, constraint};
+        }
+        fRun.clear();
+        fPaint = nullptr;
+        fConstraint = nullptr;
+    }
+
+    SkRecord*                          fRecord;
+    int                                fIndex = 0;
+    std::vector<Entry>                 fRun;
+    // These point into the first commands of the run, which stay put until it's flushed.
+    const SkPaint*                     fPaint = nullptr;
+    const SkCanvas::SrcRectConstraint* fConstraint = nullptr;
+};
+
+void SkRecordMergeImageDraws(SkRecord* record) {
+    ImageDrawMerger pass(record);
+    pass.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -309,12 +670,18 @@ void SkRecordOptimize(SkRecord* record) {
 
 void SkRecordOptimize2(SkRecord* record) {
     multiple_set_matrices(record);
+    SkRecordNoopSubsumedClips(record);
     SkRecordNoopSaveRestores(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
     SkRecordNoopSaveLayerDrawRestores(record);
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    // With the Saves and SaveLayers above gone, runs of draws are longer for these two.
+    SkRecordNoopOccludedDraws(record);
+    SkRecordMergeImageDraws(record);
+    // Occlusion may have emptied out some Save blocks.
+    SkRecordNoopSaveRestores(record);
 
     record->defrag();
 }
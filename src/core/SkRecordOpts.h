@@ -26,7 +26,19 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
-// Experimental optimizers
+// Turns intersecting non-antialiased ClipRects and ClipRRects that contain the non-antialiased clip
+// already in place into no-ops.
+void SkRecordNoopSubsumedClips(SkRecord*);
+
+// Turns draws that a later opaque, non-antialiased DrawRect or DrawPaint in the same run of draws
+// covers completely into no-ops, unless an antialiased clip is in place.  Coverage is judged in the record's own
+// pixels, so pixels along the occluder's edge may differ when played back scaled down.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawImage and DrawImageRect that share a paint into single DrawEdgeAAImageSets.
+void SkRecordMergeImageDraws(SkRecord*);
+
+// Experimental optimizers, including the three above.
 void SkRecordOptimize2(SkRecord*);
 
 #endif//SkRecordOpts_DEFINED
@@ -18,10 +18,12 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/SkChecksum.h"
 #include "include/private/SkTHash.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkDraw.h"
 #include "src/core/SkEnumerate.h"
 #include "src/core/SkGlyphRun.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkScalerCache.h"
 #include "src/core/SkSpan.h"
 #include "src/core/SkStrikeCache.h"
@@ -29,6 +31,7 @@
 #include "src/core/SkTLazy.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/core/SkTypeface_remote.h"
+#include "src/effects/SkPackBits.h"
 
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrContextOptions.h"
@@ -186,6 +189,64 @@ bool SkFuzzDeserializeSkDescriptor(sk_sp<SkData> bytes, SkAutoDescriptor* ad) {
 // Paths use a SkWriter32 which requires 4 byte alignment.
 static const size_t kPathAlignment  = 4u;
 
+// The images of a strike's mask glyphs are sent together, in one block after the glyphs, and
+// packed if that makes it smaller. Masks are mostly runs of 0 and 0xFF, so usually it does.
+static const size_t kImageBlockAlignment = 8u;
+// SkPackBits expands a run of at most 128 bytes from 2 bytes.
+static const size_t kMaxPackRatio = 64u;
+
+static bool has_wire_image(const SkGlyph& glyph) {
+    return !glyph.isEmpty() && SkStrikeForGPU::FitsInAtlas(glyph);
+}
+
+// Returns where glyph's image goes in the image block, and grows the block to hold it.
+static size_t add_to_image_block(const SkGlyph& glyph, size_t* blockSize) {
+    size_t offset = pad(*blockSize, glyph.formatAlignment());
+    *blockSize = offset + glyph.imageSize();
+    return offset;
+}
+
+// -- SentPathTable --------------------------------------------------------------------------------
+// The glyph paths sent to the client, by content. Strikes that differ only in things like gamma
+// or contrast have the same outlines, so each path is sent once, and after that by its index.
+// The client keeps the paths it's sent in the same order.
+class SentPathTable {
+public:
+    static constexpr int32_t kNoPath = -1;
+    // Past this many paths, both sides start over at the next batch, to bound their memory.
+    static constexpr size_t kMaxPaths = 4096;
+
+    // Returns the index of the path serialized in bytes. If the client doesn't have it yet,
+    // sets *isNew; the path must be sent, and the client gives it that index.
+    int32_t find(sk_sp<SkData> bytes, bool* isNew) {
+        uint32_t hash = SkOpts::hash_fn(bytes->data(), bytes->size(), 0);
+        int32_t* index = fIndexForHash.find(hash);
+        if (index && fPaths[*index]->equals(bytes.get())) {
+            *isNew = false;
+            return *index;
+        }
+        int32_t newIndex = SkToS32(fPaths.size());
+        fPaths.push_back(std::move(bytes));
+        fIndexForHash.set(hash, newIndex);
+        *isNew = true;
+        return newIndex;
+    }
+
+    // Forgets all the paths if there are too many, returning whether the client should too.
+    bool resetIfFull() {
+        if (fPaths.size() < kMaxPaths) {
+            return false;
+        }
+        fPaths.clear();
+        fIndexForHash.reset();
+        return true;
+    }
+
+private:
+    std::vector<sk_sp<SkData>> fPaths;
+    SkTHashMap<uint32_t, int32_t> fIndexForHash;
+};
+
 // -- StrikeSpec -----------------------------------------------------------------------------------
 struct StrikeSpec {
     StrikeSpec() = default;
@@ -249,7 +310,7 @@ public:
                  SkDiscardableHandleId discardableHandleId);
     ~RemoteStrike() override = default;
 
-    void writePendingGlyphs(Serializer* serializer);
+    void writePendingGlyphs(Serializer* serializer, SentPathTable* sentPaths);
     SkDiscardableHandleId discardableHandleId() const { return fDiscardableHandleId; }
 
     const SkDescriptor& getDescriptor() const override {
@@ -325,7 +386,8 @@ private:
         }
     };
 
-    void writeGlyphPath(const SkGlyph& glyph, Serializer* serializer) const;
+    void writeGlyphPath(const SkGlyph& glyph, Serializer* serializer,
+                        SentPathTable* sentPaths) const;
     void ensureScalerContext();
 
     const int fNumberOfGlyphs;
@@ -388,7 +450,7 @@ static void writeGlyph(const SkGlyph& glyph, Serializer* serializer) {
     serializer->write<uint8_t>(glyph.maskFormat());
 }
 
-void RemoteStrike::writePendingGlyphs(Serializer* serializer) {
+void RemoteStrike::writePendingGlyphs(Serializer* serializer, SentPathTable* sentPaths) {
     SkASSERT(this->hasPendingGlyphs());
 
     // Write the desc.
@@ -404,16 +466,38 @@ void RemoteStrike::writePendingGlyphs(Serializer* serializer) {
         fHaveSentFontMetrics = true;
     }
 
-    // Write mask glyphs
+    // Write mask glyphs, then their images.
     serializer->emplace<uint64_t>(fMasksToSend.size());
+    std::vector<size_t> imageOffsets;
+    size_t imagesSize = 0;
     for (SkGlyph& glyph : fMasksToSend) {
         SkASSERT(SkMask::IsValidFormat(glyph.fMaskFormat));
 
         writeGlyph(glyph, serializer);
-        auto imageSize = glyph.imageSize();
-        if (imageSize > 0 && FitsInAtlas(glyph)) {
-            glyph.fImage = serializer->allocate(imageSize, glyph.formatAlignment());
-            fContext->getImage(glyph);
+        imageOffsets.push_back(has_wire_image(glyph) ? add_to_image_block(glyph, &imagesSize) : 0);
+    }
+    serializer->write<uint64_t>(imagesSize);
+    if (imagesSize > 0) {
+        SkAutoTMalloc<uint8_t> images(imagesSize);
+        for (size_t i = 0; i < fMasksToSend.size(); i++) {
+            SkGlyph& glyph = fMasksToSend[i];
+            if (has_wire_image(glyph)) {
+                glyph.fImage = images.get() + imageOffsets[i];
+                fContext->getImage(glyph);
+            }
+        }
+        const size_t maxPackedSize = SkPackBits::ComputeMaxSize8(imagesSize);
+        SkAutoTMalloc<uint8_t> packed(maxPackedSize);
+        size_t packedSize = SkPackBits::Pack8(images.get(), imagesSize,
+                                              packed.get(), maxPackedSize);
+        if (packedSize < imagesSize) {
+            serializer->write<uint64_t>(packedSize);
+            memcpy(serializer->allocate(packedSize, 1), packed.get(), packedSize);
+        } else {
+            // Sent as is, with 0 for the packed size.
+            serializer->write<uint64_t>(0u);
+            memcpy(serializer->allocate(imagesSize, kImageBlockAlignment), images.get(),
+                   imagesSize);
         }
     }
     fMasksToSend.clear();
@@ -424,7 +508,7 @@ void RemoteStrike::writePendingGlyphs(Serializer* serializer) {
         SkASSERT(SkMask::IsValidFormat(glyph.fMaskFormat));
 
         writeGlyph(glyph, serializer);
-        writeGlyphPath(glyph, serializer);
+        writeGlyphPath(glyph, serializer, sentPaths);
     }
     fPathsToSend.clear();
     fPathAlloc.reset();
@@ -448,22 +532,24 @@ void RemoteStrike::setTypefaceAndEffects(
 }
 
 void RemoteStrike::writeGlyphPath(
-        const SkGlyph& glyph, Serializer* serializer) const {
-    if (glyph.isColor() || glyph.isEmpty()) {
-        serializer->write<uint64_t>(0u);
-        return;
-    }
-
-    const SkPath* path = glyph.path();
+        const SkGlyph& glyph, Serializer* serializer, SentPathTable* sentPaths) const {
+    const SkPath* path = glyph.isColor() || glyph.isEmpty() ? nullptr : glyph.path();
 
     if (path == nullptr) {
-        serializer->write<uint64_t>(0u);
+        serializer->write<int32_t>(SentPathTable::kNoPath);
         return;
     }
 
     size_t pathSize = path->writeToMemory(nullptr);
-    serializer->write<uint64_t>(pathSize);
-    path->writeToMemory(serializer->allocate(pathSize, kPathAlignment));
+    sk_sp<SkData> bytes = SkData::MakeUninitialized(pathSize);
+    path->writeToMemory(bytes->writable_data());
+
+    bool isNew;
+    serializer->write<int32_t>(sentPaths->find(bytes, &isNew));
+    if (isNew) {
+        serializer->write<uint64_t>(pathSize);
+        memcpy(serializer->allocate(pathSize, kPathAlignment), bytes->data(), pathSize);
+    }
 }
 
 template <typename Rejector>
@@ -634,6 +720,8 @@ private:
     // State cached until the next serialization.
     SkTHashSet<RemoteStrike*> fRemoteStrikesToSend;
     std::vector<WireTypeface> fTypefacesToSend;
+
+    SentPathTable fSentPaths;
 };
 
 SkStrikeServerImpl::SkStrikeServerImpl(SkStrikeServer::DiscardableHandleManager* dhm)
@@ -683,12 +771,13 @@ void SkStrikeServerImpl::writeStrikeData(std::vector<uint8_t>* memory) {
     }
     fTypefacesToSend.clear();
 
+    serializer.emplace<bool>(fSentPaths.resetIfFull());
     serializer.emplace<uint64_t>(SkTo<uint64_t>(strikesToSend));
     fRemoteStrikesToSend.foreach (
 #ifdef SK_DEBUG
             [&](RemoteStrike* strike) {
                 if (strike->hasPendingGlyphs()) {
-                    strike->writePendingGlyphs(&serializer);
+                    strike->writePendingGlyphs(&serializer, &fSentPaths);
                     strike->resetScalerContext();
                 }
                 auto it = fDescToRemoteStrike.find(&strike->getDescriptor());
@@ -697,9 +786,9 @@ void SkStrikeServerImpl::writeStrikeData(std::vector<uint8_t>* memory) {
             }
 
 #else
-            [&serializer](RemoteStrike* strike) {
+            [&](RemoteStrike* strike) {
                 if (strike->hasPendingGlyphs()) {
-                    strike->writePendingGlyphs(&serializer);
+                    strike->writePendingGlyphs(&serializer, &fSentPaths);
                     strike->resetScalerContext();
                 }
             }
@@ -932,6 +1021,8 @@ private:
     sk_sp<SkTypeface> addTypeface(const WireTypeface& wire);
 
     SkTHashMap<SkFontID, sk_sp<SkTypeface>> fRemoteFontIdToTypeface;
+    // The paths the server has sent, in order; see SentPathTable.
+    std::vector<SkPath> fPaths;
     sk_sp<SkStrikeClient::DiscardableHandleManager> fDiscardableHandleManager;
     SkStrikeCache* const fStrikeCache;
     const bool fIsLogging;
@@ -994,6 +1085,16 @@ bool SkStrikeClientImpl::readStrikeData(const volatile void* memory, size_t memo
         addTypeface(wire);
     }
 
+    bool resetPaths;
+    if (!deserializer.read<bool>(&resetPaths)) READ_FAILURE
+    if (resetPaths) {
+        fPaths.clear();
+    }
+    // The server starts over before a batch once it has sent kMaxPaths, so within a batch we can
+    // only hold more than that by the paths the batch itself brings. Don't let a bad stream that
+    // never resets grow the table without bound.
+    if (fPaths.size() >= SentPathTable::kMaxPaths) READ_FAILURE
+
     if (!deserializer.read<uint64_t>(&strikeCount)) READ_FAILURE
 
     for (size_t i = 0; i < strikeCount; ++i) {
@@ -1040,18 +1141,50 @@ bool SkStrikeClientImpl::readStrikeData(const volatile void* memory, size_t memo
         }
 
         if (!deserializer.read<uint64_t>(&glyphImagesCount)) READ_FAILURE
+        std::vector<SkGlyph> glyphs;
+        std::vector<size_t> imageOffsets;
+        size_t imagesSize = 0;
         for (size_t j = 0; j < glyphImagesCount; j++) {
             SkTLazy<SkGlyph> glyph;
             if (!ReadGlyph(glyph, &deserializer)) READ_FAILURE
+            imageOffsets.push_back(has_wire_image(*glyph)
+                                           ? add_to_image_block(*glyph, &imagesSize)
+                                           : 0);
+            glyphs.push_back(*glyph);
+        }
 
-            if (!glyph->isEmpty() && SkStrikeForGPU::FitsInAtlas(*glyph)) {
-                const volatile void* image =
-                        deserializer.read(glyph->imageSize(), glyph->formatAlignment());
-                if (!image) READ_FAILURE
-                glyph->fImage = (void*)image;
+        uint64_t wireImagesSize = 0u;
+        if (!deserializer.read<uint64_t>(&wireImagesSize)) READ_FAILURE
+        if (wireImagesSize != imagesSize) READ_FAILURE
+        const uint8_t* images = nullptr;
+        SkAutoTMalloc<uint8_t> unpacked;
+        if (imagesSize > 0) {
+            uint64_t packedSize = 0u;
+            if (!deserializer.read<uint64_t>(&packedSize)) READ_FAILURE
+            if (packedSize == 0) {
+                auto* block = deserializer.read(imagesSize, kImageBlockAlignment);
+                if (!block) READ_FAILURE
+                images = const_cast<const uint8_t*>(static_cast<const volatile uint8_t*>(block));
+            } else {
+                // Don't let a small message make us allocate more than it could unpack to.
+                if (imagesSize / kMaxPackRatio > packedSize) READ_FAILURE
+                auto* packed = deserializer.read(packedSize, 1);
+                if (!packed) READ_FAILURE
+                unpacked.reset(imagesSize);
+                int unpackedSize = SkPackBits::Unpack8(
+                        const_cast<const uint8_t*>(static_cast<const volatile uint8_t*>(packed)),
+                        packedSize, unpacked.get(), imagesSize);
+                if ((size_t)unpackedSize != imagesSize) READ_FAILURE
+                images = unpacked.get();
             }
+        }
 
-            strike->mergeGlyphAndImage(glyph->getPackedID(), *glyph);
+        for (size_t j = 0; j < glyphs.size(); j++) {
+            SkGlyph& glyph = glyphs[j];
+            if (has_wire_image(glyph)) {
+                glyph.fImage = (void*)(images + imageOffsets[j]);
+            }
+            strike->mergeGlyphAndImage(glyph.getPackedID(), glyph);
         }
 
         if (!deserializer.read<uint64_t>(&glyphPathsCount)) READ_FAILURE
@@ -1062,15 +1195,22 @@ bool SkStrikeClientImpl::readStrikeData(const volatile void* memory, size_t memo
             SkGlyph* allocatedGlyph = strike->mergeGlyphAndImage(glyph->getPackedID(), *glyph);
 
             SkPath* pathPtr = nullptr;
-            SkPath path;
-            uint64_t pathSize = 0u;
-            if (!deserializer.read<uint64_t>(&pathSize)) READ_FAILURE
+            int32_t pathIndex = SentPathTable::kNoPath;
+            if (!deserializer.read<int32_t>(&pathIndex)) READ_FAILURE
 
-            if (pathSize > 0) {
+            if (pathIndex == SkToS32(fPaths.size())) {
+                // A path we haven't had before.
+                uint64_t pathSize = 0u;
+                if (!deserializer.read<uint64_t>(&pathSize)) READ_FAILURE
                 auto* pathData = deserializer.read(pathSize, kPathAlignment);
                 if (!pathData) READ_FAILURE
+                SkPath path;
                 if (!path.readFromMemory(const_cast<const void*>(pathData), pathSize)) READ_FAILURE
-                pathPtr = &path;
+                fPaths.push_back(std::move(path));
+                pathPtr = &fPaths.back();
+            } else if (pathIndex != SentPathTable::kNoPath) {
+                if (pathIndex < 0 || pathIndex >= SkToS32(fPaths.size())) READ_FAILURE
+                pathPtr = &fPaths[pathIndex];
             }
 
             strike->mergePath(allocatedGlyph, pathPtr);
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkResampler.h"
+
+#include "include/core/SkColorSpace.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+using F4 = skvx::Vec<4, float>;
+
+// dst rows are filled in strips of this many. Each strip converts and horizontally filters the
+// src rows it needs (rows under the filter at a strip's edges are done by both strips), which
+// bounds the scratch memory no matter how large the pixmaps are.
+static constexpr int     kStripRows         = 64;
+// With at least this many dst pixels, the strips run on the default executor.
+static constexpr int64_t kMinParallelPixels = 256 * 256;
+
+static float filter_radius(SkPixmap::ResampleFilter filter) {
+    switch (filter) {
+        case SkPixmap::ResampleFilter::kTriangle:   return 1;
+        case SkPixmap::ResampleFilter::kMitchell:   return 2;
+        case SkPixmap::ResampleFilter::kCatmullRom: return 2;
+        case SkPixmap::ResampleFilter::kLanczos3:   return 3;
+    }
+    SkUNREACHABLE;
+}
+
+// See "Reconstruction Filters in Computer Graphics", Mitchell and Netravali, 1988.
+static float cubic(float x, float B, float C) {
+    x = std::abs(x);
+    if (x < 1) {
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) * (1 / 6.0f);
+    }
+    if (x < 2) {
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C))
+               * (1 / 6.0f);
+    }
+    return 0;
+}
+
+static float filter_weight(SkPixmap::ResampleFilter filter, float x) {
+    switch (filter) {
+        case SkPixmap::ResampleFilter::kTriangle:
+            return std::max(0.0f, 1 - std::abs(x));
+        case SkPixmap::ResampleFilter::kMitchell:
+            return cubic(x, 1 / 3.0f, 1 / 3.0f);
+        case SkPixmap::ResampleFilter::kCatmullRom:
+            return cubic(x, 0, 1 / 2.0f);
+        case SkPixmap::ResampleFilter::kLanczos3: {
+            if (x == 0) {
+                return 1;
+            }
+            if (std::abs(x) >= 3) {
+                return 0;
+            }
+            const float px = SK_FloatPI * x;
+            return 3 * std::sin(px) * std::sin(px / 3) / (px * px);
+        }
+    }
+    SkUNREACHABLE;
+}
+
+SkResampler::Axis SkResampler::MakeAxis(int srcLength, int dstLength,
+                                        SkPixmap::ResampleFilter filter) {
+    const float scale = (float)dstLength / srcLength;
+    // When shrinking, stretch the filter over the src pixels that map to one dst pixel.
+    const float stretch = std::max(1.0f, 1 / scale);
+    const float radius = filter_radius(filter) * stretch;
+
+    Axis axis;
+    axis.fTaps = std::min(srcLength, (int)std::floor(2 * radius) + 1);
+    axis.fFirst.resize(dstLength);
+    axis.fWeights.resize((size_t)dstLength * axis.fTaps);
+    for (int i = 0; i < dstLength; ++i) {
+        // The center of dst pixel i, in src pixels whose centers are at integers.
+        const float center = (i + 0.5f) / scale - 0.5f;
+        const int lo = std::max(0, (int)std::ceil(center - radius)),
+                  hi = std::min(srcLength - 1, (int)std::floor(center + radius));
+        const int first = std::max(0, std::min(lo, srcLength - axis.fTaps));
+        float* weights = &axis.fWeights[(size_t)i * axis.fTaps];
+
+        float sum = 0;
+        for (int k = 0; k < axis.fTaps; ++k) {
+            const int j = first + k;
+            weights[k] = (j >= lo && j <= hi) ? filter_weight(filter, (j - center) / stretch) : 0;
+            sum += weights[k];
+        }
+        if (sum != 0) {
+            for (int k = 0; k < axis.fTaps; ++k) {
+                weights[k] /= sum;
+            }
+        } else {
+            // Only possible if every tap lands on a zero of the filter; take the nearest pixel.
+            int nearest = SkTPin((int)std::lround(center), first, first + axis.fTaps - 1);
+            weights[nearest - first] = 1;
+        }
+        axis.fFirst[i] = first;
+    }
+    return axis;
+}
+
+SkResampler::SkResampler(SkISize srcSize, SkISize dstSize, SkPixmap::ResampleFilter filter)
+    : fSrcSize(srcSize)
+    , fDstSize(dstSize) {
+    if (!srcSize.isEmpty() && !dstSize.isEmpty()) {
+        fX = MakeAxis(srcSize.width(),  dstSize.width(),  filter);
+        fY = MakeAxis(srcSize.height(), dstSize.height(), filter);
+    }
+}
+
+bool SkResampler::resample(const SkPixmap& src, const SkPixmap& dst, bool linear) const {
+    if (src.dimensions() != fSrcSize || dst.dimensions() != fDstSize || fSrcSize.isEmpty() ||
+        fDstSize.isEmpty() || !src.addr() || !dst.addr()) {
+        return false;
+    }
+
+    // Like SkPixmap::readPixels(), a src without a color space has no linear gamma to speak of.
+    sk_sp<SkColorSpace> workCS = src.refColorSpace();
+    if (linear && workCS && !workCS->gammaIsLinear()) {
+        workCS = workCS->makeLinearGamma();
+    }
+    const SkImageInfo srcRowInfo = SkImageInfo::Make(fSrcSize.width(), 1, kRGBA_F32_SkColorType,
+                                                     kPremul_SkAlphaType, workCS),
+                      dstRowInfo = srcRowInfo.makeWH(fDstSize.width(), 1);
+    const int srcWidth = fSrcSize.width(),
+              dstWidth = fDstSize.width(),
+              dstHeight = fDstSize.height();
+
+    std::atomic<bool> ok{true};
+    auto fillRows = [&](int y0, int y1) {
+        // The src rows under the filter for dst rows [y0, y1), filtered horizontally.
+        const int firstRow = fY.fFirst[y0],
+                  rowCount = fY.fFirst[y1 - 1] + fY.fTaps - firstRow;
+        SkAutoTMalloc<float> srcRow(4 * (size_t)srcWidth),
+                             rows(4 * (size_t)dstWidth * rowCount),
+                             dstRow(4 * (size_t)dstWidth);
+
+        for (int r = 0; r < rowCount; ++r) {
+            SkPixmap from, to(srcRowInfo, srcRow.get(), srcRowInfo.minRowBytes());
+            if (!src.extractSubset(&from, SkIRect::MakeXYWH(0, firstRow + r, srcWidth, 1)) ||
+                !from.readPixels(to)) {
+                ok = false;
+                return;
+            }
+            float* out = rows.get() + 4 * (size_t)dstWidth * r;
+            for (int x = 0; x < dstWidth; ++x) {
+                const float* in = srcRow.get() + 4 * fX.fFirst[x];
+                const float* w = &fX.fWeights[(size_t)x * fX.fTaps];
+                F4 sum = 0;
+                for (int k = 0; k < fX.fTaps; ++k) {
+                    sum += w[k] * F4::Load(in + 4 * k);
+                }
+                sum.store(out + 4 * x);
+            }
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            const float* in = rows.get() + 4 * (size_t)dstWidth * (fY.fFirst[y] - firstRow);
+            const float* w = &fY.fWeights[(size_t)y * fY.fTaps];
+            float* acc = dstRow.get();
+            std::fill(acc, acc + 4 * dstWidth, 0.0f);
+            for (int k = 0; k < fY.fTaps; ++k, in += 4 * dstWidth) {
+                if (w[k] == 0) {
+                    continue;
+                }
+                for (int i = 0; i < 4 * dstWidth; i += 4) {
+                    (F4::Load(acc + i) + w[k] * F4::Load(in + i)).store(acc + i);
+                }
+            }
+            // Negative lobes can overshoot; keep the result a valid premultiplied color.
+            for (int i = 0; i < 4 * dstWidth; i += 4) {
+                F4 px = F4::Load(acc + i);
+                float a = SkTPin(px[3], 0.0f, 1.0f);
+                px = skvx::min(skvx::max(px, 0.0f), a);
+                px[3] = a;
+                px.store(acc + i);
+            }
+            SkPixmap from(dstRowInfo, dstRow.get(), dstRowInfo.minRowBytes()), to;
+            if (!dst.extractSubset(&to, SkIRect::MakeXYWH(0, y, dstWidth, 1)) ||
+                !from.readPixels(to)) {
+                ok = false;
+                return;
+            }
+        }
+    };
+
+    const int strips = (dstHeight + kStripRows - 1) / kStripRows;
+    auto fillStrip = [&](int s) {
+        fillRows(s * kStripRows, std::min(dstHeight, (s + 1) * kStripRows));
+    };
+    if (strips > 1 && (int64_t)dstWidth * dstHeight >= kMinParallelPixels) {
+        SkTaskGroup().batch(strips, fillStrip);
+    } else {
+        for (int s = 0; s < strips; ++s) {
+            fillStrip(s);
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResampler_DEFINED
+#define SkResampler_DEFINED
+
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSize.h"
+
+#include <vector>
+
+/**
+ *  Scales whole pixmaps with a separable filter, as SkPixmap::scalePixels() does for a
+ *  ResampleFilter. The filter weights for each row and column are computed once, when the
+ *  SkResampler is made, so one SkResampler can scale any number of pixmaps of the same size.
+ *
+ *  Pixels are filtered as premultiplied floats, horizontally and then vertically. Each dst pixel
+ *  is a weighted sum of the src pixels under the filter, which is widened by the scale when
+ *  shrinking so that every src pixel contributes. Taps that would fall outside src are dropped
+ *  and the rest renormalized.
+ */
+class SkResampler {
+public:
+    SkResampler(SkISize srcSize, SkISize dstSize, SkPixmap::ResampleFilter);
+
+    /**
+     *  Scales src to fill dst, converting to dst's color type, alpha type and color space as
+     *  SkPixmap::readPixels() does. If linear is true and src has a color space, filtering
+     *  happens in that color space's linear gamma. Large dsts are filled in strips of rows on
+     *  the default executor (see SkExecutor::SetDefault).
+     *
+     *  Returns false if src or dst is not the size this was made for, or dst has no pixels.
+     */
+    bool resample(const SkPixmap& src, const SkPixmap& dst, bool linear = false) const;
+
+private:
+    // The filter taps of every dst pixel along one axis. Each dst pixel i reads the fTaps src
+    // pixels starting at fFirst[i], weighted by fWeights[i * fTaps ...]; weights for src pixels
+    // outside the filter are zero.
+    struct Axis {
+        int                fTaps;
+        std::vector<int>   fFirst;
+        std::vector<float> fWeights;
+    };
+
+    static Axis MakeAxis(int srcLength, int dstLength, SkPixmap::ResampleFilter);
+
+    SkISize fSrcSize,
+            fDstSize;
+    Axis    fX,
+            fY;
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkSpecialSurfacePool.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/private/SkMalloc.h"
+#include "include/private/SkOnce.h"
+#include "src/core/SkSpecialSurface.h"
+#include "src/core/SkSurfacePriv.h"
+
+#include <cstring>
+#include <iterator>
+
+SkSpecialSurfacePool::SkSpecialSurfacePool(size_t budget) : fBudget(budget) {}
+
+SkSpecialSurfacePool::~SkSpecialSurfacePool() {
+    // Every lent block holds a ref on the pool, so only idle blocks can be left.
+    SkAutoMutexExclusive lock(fMutex);
+    SkASSERT(fInUse.count() == 0);
+    this->evict(0);
+}
+
+SkSpecialSurfacePool* SkSpecialSurfacePool::Get() {
+    static SkOnce once;
+    static SkSpecialSurfacePool* pool;
+
+    once([]{ pool = new SkSpecialSurfacePool(); });
+    return pool;
+}
+
+size_t SkSpecialSurfacePool::BucketBytes(size_t bytes) {
+    // Round up to a multiple of an eighth of the next power of two: four buckets per doubling,
+    // and a block never more than a quarter bigger than what it was asked for.
+    size_t step = 4096;
+    while (step * 8 < bytes) {
+        step <<= 1;
+    }
+    return (bytes + step - 1) / step * step;
+}
+
+sk_sp<SkSpecialSurface> SkSpecialSurfacePool::makeRaster(const SkImageInfo& info,
+                                                         const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+    const size_t rowBytes = info.minRowBytes(),
+                 bytes = info.computeByteSize(rowBytes);
+    if (SkImageInfo::ByteSizeOverflowed(bytes)) {
+        return nullptr;
+    }
+    const size_t blockBytes = BucketBytes(bytes);
+
+    void* addr = nullptr;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        for (auto block = fIdle.rbegin(); block != fIdle.rend(); ++block) {
+            if (block->fBytes == blockBytes) {
+                addr = block->fAddr;
+                fIdle.erase(std::next(block).base());
+                fIdleBytes -= blockBytes;
+                fReuses++;
+                break;
+            }
+        }
+        if (!addr) {
+            fAllocations++;
+        }
+    }
+    if (addr) {
+        // SkSpecialSurface::MakeRaster() surfaces start out cleared; some filters count on that.
+        memset(addr, 0, bytes);
+    } else if (!(addr = sk_calloc_canfail(blockBytes))) {
+        return nullptr;
+    }
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        fInUse.set(addr, blockBytes);
+        fInUseBytes += blockBytes;
+    }
+
+    // The block comes back through ReleaseProc() once the pixel ref dies, which may be long after
+    // the surface, if an image snapshot of it is kept.
+    SkBitmap bitmap;
+    if (!bitmap.installPixels(info, addr, rowBytes, ReleaseProc, SkRef(this))) {
+        return nullptr;
+    }
+    return SkSpecialSurface::MakeFromBitmap(SkIRect::MakeSize(info.dimensions()), bitmap, props);
+}
+
+void SkSpecialSurfacePool::ReleaseProc(void* addr, void* pool) {
+    static_cast<SkSpecialSurfacePool*>(pool)->release(addr);
+    static_cast<SkSpecialSurfacePool*>(pool)->unref();
+}
+
+void SkSpecialSurfacePool::release(void* addr) {
+    SkAutoMutexExclusive lock(fMutex);
+    const size_t* blockBytes = fInUse.find(addr);
+    SkASSERT(blockBytes);
+    const size_t bytes = *blockBytes;
+    fInUse.remove(addr);
+    fInUseBytes -= bytes;
+
+    fIdle.push_back({addr, bytes});
+    fIdleBytes += bytes;
+    this->evict(fBudget);
+}
+
+void SkSpecialSurfacePool::evict(size_t budget) {
+    size_t evicted = 0;
+    while (fIdleBytes > budget) {
+        const Block& oldest = fIdle[evicted++];
+        sk_free(oldest.fAddr);
+        fIdleBytes -= oldest.fBytes;
+    }
+    fIdle.erase(fIdle.begin(), fIdle.begin() + evicted);
+}
+
+SkSpecialSurfacePool::Stats SkSpecialSurfacePool::stats() const {
+    SkAutoMutexExclusive lock(fMutex);
+    Stats stats;
+    stats.fAllocations = fAllocations;
+    stats.fReuses = fReuses;
+    stats.fIdleBytes = fIdleBytes;
+    stats.fInUseBytes = fInUseBytes;
+    return stats;
+}
+
+size_t SkSpecialSurfacePool::budget() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fBudget;
+}
+
+void SkSpecialSurfacePool::setBudget(size_t budget) {
+    SkAutoMutexExclusive lock(fMutex);
+    fBudget = budget;
+    this->evict(fBudget);
+}
+
+void SkSpecialSurfacePool::purge() {
+    SkAutoMutexExclusive lock(fMutex);
+    this->evict(0);
+}
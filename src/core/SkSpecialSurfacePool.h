@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSpecialSurfacePool_DEFINED
+#define SkSpecialSurfacePool_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTHash.h"
+
+#include <vector>
+
+class SkSpecialSurface;
+class SkSurfaceProps;
+struct SkImageInfo;
+
+/**
+ *  Recycles the pixel memory of raster SkSpecialSurfaces, so that image filters drawing the same
+ *  shapes of intermediates frame after frame don't send each one back through malloc.
+ *
+ *  Blocks are sized in buckets, a quarter of a power of two apart, and a request is served by any
+ *  idle block of its bucket. When the last image or surface using a block goes away, the block
+ *  goes idle and stays in the pool, until the idle blocks exceed the budget and the least
+ *  recently used are freed.
+ *
+ *  Thread safe.
+ */
+class SkSpecialSurfacePool : public SkRefCnt {
+public:
+    static constexpr size_t kDefaultBudget = 16 * 1024 * 1024;
+
+    explicit SkSpecialSurfacePool(size_t budget = kDefaultBudget);
+    ~SkSpecialSurfacePool() override;
+
+    // The pool that image filters use for their raster intermediates.
+    static SkSpecialSurfacePool* Get();
+
+    // As SkSpecialSurface::MakeRaster(), with the pixels (cleared to zero) from an idle block when
+    // there is one.
+    sk_sp<SkSpecialSurface> makeRaster(const SkImageInfo&, const SkSurfaceProps* = nullptr);
+
+    struct Stats {
+        int    fAllocations = 0;  // blocks allocated because none were idle
+        int    fReuses = 0;       // requests served by an idle block
+        size_t fIdleBytes = 0;
+        size_t fInUseBytes = 0;
+    };
+    Stats stats() const;
+
+    // Idle blocks beyond the budget are freed, oldest first. A budget of 0 disables pooling.
+    size_t budget() const;
+    void setBudget(size_t);
+
+    // Frees every idle block.
+    void purge();
+
+private:
+    struct Block {
+        void*  fAddr;
+        size_t fBytes;
+    };
+
+    static size_t BucketBytes(size_t bytes);
+    static void ReleaseProc(void* addr, void* pool);
+
+    void release(void* addr);
+    void evict(size_t budget) SK_REQUIRES(fMutex);
+
+    mutable SkMutex           fMutex;
+    size_t                    fBudget      SK_GUARDED_BY(fMutex);
+    // Idle blocks, least recently released first.
+    std::vector<Block>        fIdle        SK_GUARDED_BY(fMutex);
+    size_t                    fIdleBytes   SK_GUARDED_BY(fMutex) = 0;
+    // Blocks lent out, and their sizes.
+    SkTHashMap<void*, size_t> fInUse       SK_GUARDED_BY(fMutex);
+    size_t                    fInUseBytes  SK_GUARDED_BY(fMutex) = 0;
+    int                       fAllocations SK_GUARDED_BY(fMutex) = 0;
+    int                       fReuses      SK_GUARDED_BY(fMutex) = 0;
+};
+
+#endif
@@ -205,15 +205,18 @@ sk_sp<SkTypeface> SkTypeface::MakeDeserialize(SkStream* stream) {
     if (!SkFontDescriptor::Deserialize(stream, &desc)) {
         return nullptr;
     }
+    return MakeFromDescriptor(&desc);
+}
 
-    if (desc.hasStream()) {
-        if (auto tf = SkCustomTypefaceBuilder::Deserialize(desc.dupStream().get())) {
+sk_sp<SkTypeface> SkTypeface::MakeFromDescriptor(SkFontDescriptor* desc) {
+    if (desc->hasStream()) {
+        if (auto tf = SkCustomTypefaceBuilder::Deserialize(desc->dupStream().get())) {
             return tf;
         }
     }
 
     // Have to check for old data format first.
-    std::unique_ptr<SkFontData> data = desc.maybeAsSkFontData();
+    std::unique_ptr<SkFontData> data = desc->maybeAsSkFontData();
     if (data) {
         // Should only get here with old skps.
         sk_sp<SkFontMgr> defaultFm = SkFontMgr::RefDefault();
@@ -223,18 +226,19 @@ sk_sp<SkTypeface> SkTypeface::MakeDeserialize(SkStream* stream) {
         }
     }
 
-    if (desc.hasStream()) {
+    if (desc->hasStream()) {
         SkFontArguments args;
-        args.setCollectionIndex(desc.getCollectionIndex());
-        args.setVariationDesignPosition({desc.getVariation(), desc.getVariationCoordinateCount()});
+        args.setCollectionIndex(desc->getCollectionIndex());
+        args.setVariationDesignPosition({desc->getVariation(),
+                                         desc->getVariationCoordinateCount()});
         sk_sp<SkFontMgr> defaultFm = SkFontMgr::RefDefault();
-        sk_sp<SkTypeface> typeface = defaultFm->makeFromStream(desc.detachStream(), args);
+        sk_sp<SkTypeface> typeface = defaultFm->makeFromStream(desc->detachStream(), args);
         if (typeface) {
             return typeface;
         }
     }
 
-    return SkTypeface::MakeFromName(desc.getFamilyName(), desc.getStyle());
+    return SkTypeface::MakeFromName(desc->getFamilyName(), desc->getStyle());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -20,6 +20,8 @@
 #include "src/core/SkVM.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+
 static const uint8_t kIdentityTable[] = {
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
     0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
@@ -105,6 +107,50 @@ public:
         return true;
     }
 
+    bool onAsComponentTables(const uint8_t* tables[4]) const override {
+        const uint8_t* ptr = fStorage;
+        for (int i = 0; i < 4; ++i) {
+            tables[i] = nullptr;
+            if (fFlags & (1 << i)) {
+                tables[i] = ptr;
+                ptr += 256;
+            }
+        }
+        return true;
+    }
+
+    sk_sp<SkColorFilter> onMakeComposed(const SkColorFilterBase& inner) const override {
+        const uint8_t *outerTables[4], *innerTables[4];
+        if (!inner.asComponentTables(innerTables)) {
+            return nullptr;
+        }
+        this->asComponentTables(outerTables);
+
+        // Where the inner alpha can become 0, premultiplying between the two tables zeroes the
+        // color we would look up next. That only goes unseen if our alpha maps 0 to 0.
+        const uint8_t* innerA = innerTables[0] ? innerTables[0] : kIdentityTable;
+        const uint8_t* outerA = outerTables[0] ? outerTables[0] : kIdentityTable;
+        if (outerA[0] != 0 && std::find(innerA, innerA + 256, 0) != innerA + 256) {
+            return nullptr;
+        }
+
+        uint8_t folded[4][256];
+        const uint8_t* foldedTables[4];
+        for (int c = 0; c < 4; ++c) {
+            foldedTables[c] = nullptr;
+            if (innerTables[c] || outerTables[c]) {
+                const uint8_t* in  = innerTables[c] ? innerTables[c] : kIdentityTable;
+                const uint8_t* out = outerTables[c] ? outerTables[c] : kIdentityTable;
+                for (int i = 0; i < 256; ++i) {
+                    folded[c][i] = out[in[i]];
+                }
+                foldedTables[c] = folded[c];
+            }
+        }
+        return SkTableColorFilter::MakeARGB(foldedTables[0], foldedTables[1],
+                                            foldedTables[2], foldedTables[3]);
+    }
+
     skvm::Color onProgram(skvm::Builder* p, skvm::Color c,
                           SkColorSpace* dstCS,
                           skvm::Uniforms* uniforms, SkArenaAlloc*) const override {
@@ -22,6 +22,7 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -428,6 +429,39 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, ctx.surfaceProps());
 }
 
+// Large images are blurred in strips on the default executor: strips of rows for the horizontal
+// pass, then strips of columns for the vertical one. Column strips start on 16 pixel (64 byte)
+// boundaries, so neighboring strips write to at most one common cache line per row.
+static constexpr int     kMinStripSize      = 64;
+static constexpr int     kMaxStrips         = 16;
+static constexpr int     kColumnAlignment   = 16;
+static constexpr int64_t kMinParallelPixels = 256 * 256;
+
+static int strip_count(int count, int64_t pixels) {
+    if (pixels < kMinParallelPixels) {
+        return 1;
+    }
+    return SkTPin(count / kMinStripSize, 1, kMaxStrips);
+}
+
+// Calls fn(begin, end, strip) over [0, count) split into 'strips' pieces, each of whose starts is
+// a multiple of 'alignment'.
+template <typename Fn>
+static void for_each_strip(int count, int strips, int alignment, Fn&& fn) {
+    if (strips <= 1) {
+        fn(0, count, 0);
+        return;
+    }
+    int units = (count + alignment - 1) / alignment;
+    SkTaskGroup().batch(strips, [&](int i) {
+        int begin = SkToInt((int64_t)units * i / strips) * alignment,
+            end   = std::min(SkToInt((int64_t)units * (i + 1) / strips) * alignment, count);
+        if (begin < end) {
+            fn(begin, end, i);
+        }
+    });
+}
+
 // TODO: Implement CPU backend for different fTileMode.
 static sk_sp<SkSpecialImage> cpu_blur(
         const SkImageFilter_Base::Context& ctx,
@@ -472,10 +506,14 @@ static sk_sp<SkSpecialImage> cpu_blur(
     auto bufferSizeW = calculate_buffer(windowW),
          bufferSizeH = calculate_buffer(windowH);
 
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
+    const int64_t dstPixels = (int64_t)dstW * dstH;
+    const int stripsW = strip_count(srcH, dstPixels),
+              stripsH = strip_count(dstW, dstPixels);
+
+    // Each strip has its own buffer. The amount 1024 is enough for one buffer up to 10 sigma.
     SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
+    const int bufferSize = std::max(bufferSizeW, bufferSizeH);
+    Sk4u* buffers = alloc.makeArrayDefault<Sk4u>(bufferSize * std::max(stripsW, stripsH));
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -517,19 +555,26 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        blur_one_direction(
-                buffer, windowW,
-                srcBounds.left(), srcBounds.right(), dstBounds.right(),
-                static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
-                intermediateSrc, 1, intermediateRowBytesAsPixels);
+        for_each_strip(srcH, stripsW, 1, [&](int begin, int end, int strip) {
+            blur_one_direction(
+                    buffers + strip * bufferSize, windowW,
+                    srcBounds.left(), srcBounds.right(), dstBounds.right(),
+                    src.getAddr32(0, begin), 1, src.rowBytesAsPixels(), end - begin,
+                    intermediateSrc + begin * intermediateRowBytesAsPixels,
+                    1, intermediateRowBytesAsPixels);
+        });
     }
 
     if (windowH > 1) {
-        blur_one_direction(
-                buffer, windowH,
-                srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
-                intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
-                intermediateDst, dst.rowBytesAsPixels(), 1);
+        // Each column is blurred in place independently of the others.
+        for_each_strip(intermediateWidth, stripsH, kColumnAlignment,
+                       [&](int begin, int end, int strip) {
+            blur_one_direction(
+                    buffers + strip * bufferSize, windowH,
+                    srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
+                    intermediateSrc + begin, intermediateRowBytesAsPixels, 1, end - begin,
+                    intermediateDst + begin, dst.rowBytesAsPixels(), 1);
+        });
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
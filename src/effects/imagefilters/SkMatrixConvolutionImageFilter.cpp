@@ -12,6 +12,7 @@
 #include "include/core/SkTileMode.h"
 #include "include/core/SkUnPreMultiply.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkNx.h"
 #include "include/private/SkTPin.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -19,6 +20,8 @@
 #include "src/core/SkWriteBuffer.h"
 #include "src/gpu/SkGr.h"
 
+#include <memory>
+
 #if SK_SUPPORT_GPU
 #include "src/gpu/GrRecordingContextPriv.h"
 #include "src/gpu/GrTextureProxy.h"
@@ -46,6 +49,7 @@ public:
         SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
         SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
         SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
+        this->factorKernel();
     }
 
     ~SkMatrixConvolutionImageFilterImpl() override {
@@ -73,12 +77,26 @@ private:
     SkTileMode  fTileMode;
     bool        fConvolveAlpha;
 
+    // When the kernel is the outer product of a column and a row, those two vectors. The raster
+    // path then convolves each source row with fRowKernel and sums the rows weighted by
+    // fColumnKernel, taking width + height taps per pixel instead of width * height.
+    std::unique_ptr<SkScalar[]> fRowKernel;
+    std::unique_ptr<SkScalar[]> fColumnKernel;
+
+    void factorKernel();
+
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
                       SkIVector& offset,
                       const SkIRect& rect,
                       const SkIRect& bounds) const;
+    template <class PixelFetcher, bool convolveAlpha>
+    void filterPixelsByRow(const SkBitmap& src,
+                           SkBitmap* result,
+                           SkIVector& offset,
+                           const SkIRect& rect,
+                           const SkIRect& bounds) const;
     template <class PixelFetcher>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
@@ -258,6 +276,62 @@ void SkMatrixConvolutionImageFilterImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeBool(fConvolveAlpha);
 }
 
+void SkMatrixConvolutionImageFilterImpl::factorKernel() {
+    const int width = fKernelSize.fWidth, height = fKernelSize.fHeight;
+    if (sk_64_mul(width, height) <= width + height) {
+        return;
+    }
+
+    // Factor around the largest tap, so every other tap is divided by something well away from 0.
+    int pivot = 0;
+    SkScalar maxTap = 0;
+    for (int i = 0; i < width * height; ++i) {
+        if (!SkScalarIsFinite(fKernel[i])) {
+            return;
+        }
+        if (SkScalarAbs(fKernel[i]) > maxTap) {
+            maxTap = SkScalarAbs(fKernel[i]);
+            pivot = i;
+        }
+    }
+    if (maxTap == 0) {
+        return;
+    }
+    const int pivotX = pivot % width, pivotY = pivot / width;
+
+    std::unique_ptr<SkScalar[]> row(new SkScalar[width]), column(new SkScalar[height]);
+    for (int cx = 0; cx < width; ++cx) {
+        row[cx] = fKernel[pivotY * width + cx] / fKernel[pivot];
+    }
+    for (int cy = 0; cy < height; ++cy) {
+        column[cy] = fKernel[cy * width + pivotX];
+    }
+    // Kernels built as a product of two float vectors are only rank 1 up to rounding.
+    const SkScalar tolerance = maxTap * 1e-6f;
+    for (int cy = 0; cy < height; ++cy) {
+        for (int cx = 0; cx < width; ++cx) {
+            if (SkScalarAbs(column[cy] * row[cx] - fKernel[cy * width + cx]) > tolerance) {
+                return;
+            }
+        }
+    }
+    fRowKernel = std::move(row);
+    fColumnKernel = std::move(column);
+}
+
+// Unpacks an SkPMColor into floats, one lane per byte in memory order.
+static inline Sk4f to_4f(SkPMColor c) {
+    return SkNx_cast<float>(Sk4b::Load(&c));
+}
+
+static constexpr int kA = SK_A32_SHIFT / 8,
+                     kR = SK_R32_SHIFT / 8,
+                     kG = SK_G32_SHIFT / 8,
+                     kB = SK_B32_SHIFT / 8;
+
+// Beyond this many floats of row storage, fall back to fetching every tap of every pixel.
+static constexpr int64_t kMaxRowStorage = 4 * 1024 * 1024;
+
 template<class PixelFetcher, bool convolveAlpha>
 void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
                                                       SkBitmap* result,
@@ -268,6 +342,12 @@ void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
     if (!rect.intersect(bounds)) {
         return;
     }
+    const int rowWidth = fRowKernel ? rect.width() : rect.width() + fKernelSize.fWidth - 1;
+    if (sk_64_mul(rowWidth, fKernelSize.fHeight) * 4 <= kMaxRowStorage) {
+        this->filterPixelsByRow<PixelFetcher, convolveAlpha>(src, result, offset, rect, bounds);
+        return;
+    }
+
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
@@ -303,6 +383,81 @@ void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
     }
 }
 
+// Each source row is fetched and converted to floats once, into a ring of the kernel's height in
+// rows, rather than once per tap that reads it. All four channels are then accumulated together.
+// With a factored kernel the ring holds source rows already convolved with fRowKernel.
+template<class PixelFetcher, bool convolveAlpha>
+void SkMatrixConvolutionImageFilterImpl::filterPixelsByRow(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           SkIVector& offset,
+                                                           const SkIRect& rect,
+                                                           const SkIRect& bounds) const {
+    const int kernelWidth = fKernelSize.fWidth,
+              kernelHeight = fKernelSize.fHeight;
+    const int width = rect.width(),
+              srcWidth = width + kernelWidth - 1,
+              srcLeft = rect.fLeft - fKernelOffset.fX,
+              srcTop = rect.fTop - fKernelOffset.fY;
+    const bool factored = fRowKernel != nullptr;
+    const int rowWidth = factored ? width : srcWidth;
+
+    std::unique_ptr<Sk4f[]> rows(new Sk4f[rowWidth * kernelHeight]);
+    std::unique_ptr<Sk4f[]> srcRow(factored ? new Sk4f[srcWidth] : nullptr);
+    auto rowAt = [&](int srcY) { return rows.get() + (srcY - srcTop) % kernelHeight * rowWidth; };
+    auto loadRow = [&](int srcY) {
+        Sk4f* row = factored ? srcRow.get() : rowAt(srcY);
+        for (int i = 0; i < srcWidth; ++i) {
+            row[i] = to_4f(PixelFetcher::fetch(src, srcLeft + i, srcY, bounds));
+        }
+        if (factored) {
+            Sk4f* dst = rowAt(srcY);
+            for (int x = 0; x < width; ++x) {
+                Sk4f sum = 0;
+                for (int cx = 0; cx < kernelWidth; ++cx) {
+                    sum += row[x + cx] * fRowKernel[cx];
+                }
+                dst[x] = sum;
+            }
+        }
+    };
+
+    for (int srcY = srcTop; srcY < srcTop + kernelHeight - 1; ++srcY) {
+        loadRow(srcY);
+    }
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        const int windowTop = y - fKernelOffset.fY;
+        loadRow(windowTop + kernelHeight - 1);
+
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+        for (int x = 0; x < width; ++x) {
+            Sk4f sum = 0;
+            for (int cy = 0; cy < kernelHeight; ++cy) {
+                const Sk4f* row = rowAt(windowTop + cy);
+                if (factored) {
+                    sum += row[x] * fColumnKernel[cy];
+                } else {
+                    const SkScalar* k = fKernel + cy * kernelWidth;
+                    for (int cx = 0; cx < kernelWidth; ++cx) {
+                        sum += row[x + cx] * k[cx];
+                    }
+                }
+            }
+            // Pinning before the cast keeps huge and NaN sums in range, as SkScalarFloorToInt does.
+            Sk4i v = SkNx_cast<int>(Sk4f::Min(Sk4f::Max(sum * fGain + fBias, 0), 255).floor());
+            int a = convolveAlpha ? SkTPin(v[kA], 0, 255) : 255;
+            int r = SkTPin(v[kR], 0, a);
+            int g = SkTPin(v[kG], 0, a);
+            int b = SkTPin(v[kB], 0, a);
+            if (!convolveAlpha) {
+                a = SkGetPackedA32(PixelFetcher::fetch(src, rect.fLeft + x, y, bounds));
+                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
+            } else {
+                *dptr++ = SkPackARGB32(a, r, g, b);
+            }
+        }
+    }
+}
+
 template<class PixelFetcher>
 void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
                                                       SkBitmap* result,
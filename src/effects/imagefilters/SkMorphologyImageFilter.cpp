@@ -10,11 +10,14 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkRect.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <memory>
+
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrRecordingContext.h"
 #include "src/gpu/GrDirectContextPriv.h"
@@ -616,6 +619,80 @@ namespace {
         }
     }
 #endif
+
+    // van Herk/Gil-Werman: split each line into blocks of 2 * radius + 1 pixels and take running
+    // extremes forward and backward within each block. Every window of that size is the suffix
+    // of one block followed by a prefix of the next, so each output pixel is a single min or max
+    // of two precomputed values, no matter the radius. Four lines are processed side by side,
+    // one pixel of each per vector.
+    template<MorphType type, MorphDirection direction>
+    static void morph_vhgw(const SkPMColor* src, SkPMColor* dst,
+                           int radius, int width, int height, int srcStride, int dstStride) {
+        using Pixels = skvx::Vec<16, uint8_t>;
+        static constexpr int kLines = 4;
+        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
+        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
+        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
+        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
+        radius = std::min(radius, width - 1);
+        const int window = 2 * radius + 1;
+        // Lines are padded by radius on both ends with the identity of min or max, which stands
+        // in for the window being cut short at the ends, as it is in morph().
+        const int padded = width + 2 * radius;
+        const Pixels identity(type == MorphType::kDilate ? 0 : 0xFF);
+        auto extreme = [](const Pixels& a, const Pixels& b) {
+            return type == MorphType::kDilate ? skvx::max(a, b) : skvx::min(a, b);
+        };
+
+        std::unique_ptr<Pixels[]> forward(new Pixels[padded]), backward(new Pixels[padded]);
+        for (int line = 0; line < height; line += kLines) {
+            const int lines = std::min(kLines, height - line);
+            const SkPMColor* lineSrc = src + line * srcStrideY;
+            SkPMColor* lineDst = dst + line * dstStrideY;
+
+            for (int i = 0; i < radius; ++i) {
+                backward[i] = backward[radius + width + i] = identity;
+            }
+            for (int x = 0; x < width; ++x) {
+                const SkPMColor* p = lineSrc + x * srcStrideX;
+                if (direction == MorphDirection::kY && lines == kLines) {
+                    backward[radius + x] = Pixels::Load(p);
+                } else {
+                    SkPMColor pixels[kLines];
+                    for (int k = 0; k < kLines; ++k) {
+                        pixels[k] = p[std::min(k, lines - 1) * srcStrideY];
+                    }
+                    backward[radius + x] = Pixels::Load(pixels);
+                }
+            }
+
+            for (int start = 0; start < padded; start += window) {
+                const int end = std::min(start + window, padded);
+                Pixels running = identity;
+                for (int i = start; i < end; ++i) {
+                    forward[i] = running = extreme(running, backward[i]);
+                }
+                running = identity;
+                for (int i = end - 1; i >= start; --i) {
+                    backward[i] = running = extreme(running, backward[i]);
+                }
+            }
+
+            for (int x = 0; x < width; ++x) {
+                Pixels result = extreme(backward[x], forward[x + 2 * radius]);
+                SkPMColor* p = lineDst + x * dstStrideX;
+                if (direction == MorphDirection::kY && lines == kLines) {
+                    result.store(p);
+                } else {
+                    SkPMColor pixels[kLines];
+                    result.store(pixels);
+                    for (int k = 0; k < lines; ++k) {
+                        p[k * dstStrideY] = pixels[k];
+                    }
+                }
+            }
+        }
+    }
 }  // namespace
 
 sk_sp<SkSpecialImage> SkMorphologyImageFilterImpl::onFilterImage(const Context& ctx,
@@ -638,10 +715,12 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilterImpl::onFilterImage(const Context&
 
     // Width (or height) must fit in a signed 32-bit int to avoid UBSAN issues (crbug.com/1018190)
     // Further, we limit the radius to something much smaller, to avoid extremely slow draw calls:
-    // (crbug.com/1123035):
+    // (crbug.com/1123035). The GPU path samples the whole window per pixel; the raster path costs
+    // the same per pixel at any radius, so it accepts larger ones.
     constexpr int kMaxRadius = 100; // (std::numeric_limits<int>::max() - 1) / 2;
+    constexpr int kMaxRasterRadius = 256;
 
-    if (width < 0 || height < 0 || width > kMaxRadius || height > kMaxRadius) {
+    if (width < 0 || height < 0 || width > kMaxRasterRadius || height > kMaxRasterRadius) {
         return nullptr;
     }
 
@@ -656,6 +735,9 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilterImpl::onFilterImage(const Context&
 
 #if SK_SUPPORT_GPU
     if (ctx.gpuBacked()) {
+        if (width > kMaxRadius || height > kMaxRadius) {
+            return nullptr;
+        }
         auto context = ctx.getContext();
 
         // Ensure the input is in the destination color space. Typically applyCropRect will have
@@ -693,12 +775,18 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilterImpl::onFilterImage(const Context&
 
     SkMorphologyImageFilterImpl::Proc procX, procY;
 
+    // Past a small radius, the constant cost per pixel of morph_vhgw() beats scanning the window.
+    constexpr int kMinVHGWRadius = 2;
     if (MorphType::kDilate == fType) {
-        procX = &morph<MorphType::kDilate, MorphDirection::kX>;
-        procY = &morph<MorphType::kDilate, MorphDirection::kY>;
+        procX = width >= kMinVHGWRadius ? &morph_vhgw<MorphType::kDilate, MorphDirection::kX>
+                                        : &morph<MorphType::kDilate, MorphDirection::kX>;
+        procY = height >= kMinVHGWRadius ? &morph_vhgw<MorphType::kDilate, MorphDirection::kY>
+                                         : &morph<MorphType::kDilate, MorphDirection::kY>;
     } else {
-        procX = &morph<MorphType::kErode,  MorphDirection::kX>;
-        procY = &morph<MorphType::kErode,  MorphDirection::kY>;
+        procX = width >= kMinVHGWRadius ? &morph_vhgw<MorphType::kErode, MorphDirection::kX>
+                                        : &morph<MorphType::kErode, MorphDirection::kX>;
+        procY = height >= kMinVHGWRadius ? &morph_vhgw<MorphType::kErode, MorphDirection::kY>
+                                         : &morph<MorphType::kErode, MorphDirection::kY>;
     }
 
     if (width > 0 && height > 0) {
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrEagerDynamicVertexAllocator_DEFINED
+#define GrEagerDynamicVertexAllocator_DEFINED
+
+#include "src/gpu/GrEagerVertexAllocator.h"
+#include "src/gpu/ops/GrMeshDrawOp.h"
+
+// GrEagerVertexAllocator implementation that uses GrMeshDrawOp::Target::makeVertexSpace and
+// GrMeshDrawOp::Target::putBackVertices.
+class GrEagerDynamicVertexAllocator : public GrEagerVertexAllocator {
+public:
+    GrEagerDynamicVertexAllocator(GrMeshDrawOp::Target* target,
+                                   sk_sp<const GrBuffer>* vertexBuffer, int* baseVertex)
+            : fTarget(target)
+            , fVertexBuffer(vertexBuffer)
+            , fBaseVertex(baseVertex) {
+    }
+
+#ifdef SK_DEBUG
+    ~GrEagerDynamicVertexAllocator() override {
+        SkASSERT(!fLockCount);
+    }
+#endif
+
+    // Un-shadow GrEagerVertexAllocator::lock<T>.
+    using GrEagerVertexAllocator::lock;
+
+    // Mark "final" as a hint for the compiler to not use the vtable.
+    void* lock(size_t stride, int eagerCount) final {
+        SkASSERT(!fLockCount);
+        SkASSERT(eagerCount);
+        if (void* data = fTarget->makeVertexSpace(stride, eagerCount, fVertexBuffer, fBaseVertex)) {
+            fLockStride = stride;
+            fLockCount = eagerCount;
+            return data;
+        }
+        fVertexBuffer->reset();
+        *fBaseVertex = 0;
+        return nullptr;
+    }
+
+    // Mark "final" as a hint for the compiler to not use the vtable.
+    void unlock(int actualCount) final {
+        SkASSERT(fLockCount);
+        SkASSERT(actualCount <= fLockCount);
+        fTarget->putBackVertices(fLockCount - actualCount, fLockStride);
+        if (!actualCount) {
+            fVertexBuffer->reset();
+            *fBaseVertex = 0;
+        }
+        fLockCount = 0;
+    }
+
+private:
+    GrMeshDrawOp::Target* const fTarget;
+    sk_sp<const GrBuffer>* const fVertexBuffer;
+    int* const fBaseVertex;
+
+    size_t fLockStride;
+    int fLockCount = 0;
+};
+
+#endif
@@ -2460,12 +2460,20 @@ namespace GrTriangulator {
 
 int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
                     GrEagerVertexAllocator* vertexAllocator, Mode mode, int* numCountedCurves) {
+    SkArenaAlloc alloc(kArenaChunkSize);
+    return PathToTriangles(path, tolerance, clipBounds, vertexAllocator, mode, numCountedCurves,
+                           &alloc);
+}
+
+int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                    GrEagerVertexAllocator* vertexAllocator, Mode mode, int* numCountedCurves,
+                    SkArenaAlloc* arena) {
     int contourCnt = get_contour_count(path, tolerance);
     if (contourCnt <= 0) {
         *numCountedCurves = 0;
         return 0;
     }
-    SkArenaAlloc alloc(kArenaChunkSize);
+    SkArenaAlloc& alloc = *arena;
     VertexList outerMesh;
     Poly* polys = path_to_polys(path, tolerance, clipBounds, contourCnt, alloc, mode,
                                 numCountedCurves, &outerMesh);
@@ -13,6 +13,7 @@
 #include "src/gpu/GrColor.h"
 
 class GrEagerVertexAllocator;
+class SkArenaAlloc;
 class SkPath;
 struct SkRect;
 
@@ -57,6 +58,11 @@ constexpr size_t GetVertexStride(Mode mode) {
 
 int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
                     GrEagerVertexAllocator*, Mode, int* numCountedCurves);
+
+// As above, but the triangulator's working memory comes from 'alloc' rather than a temporary
+// arena, so a caller triangulating many paths can reset and reuse one arena between calls.
+int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                    GrEagerVertexAllocator*, Mode, int* numCountedCurves, SkArenaAlloc* alloc);
 }  // namespace GrTriangulator
 
 #endif
@@ -7,7 +7,7 @@
 
 #include "src/gpu/tessellate/GrPathTessellateOp.h"
 
-#include "src/gpu/GrEagerVertexAllocator.h"
+#include "src/gpu/GrEagerDynamicVertexAllocator.h"
 #include "src/gpu/GrGpu.h"
 #include "src/gpu/GrOpFlushState.h"
 #include "src/gpu/GrRecordingContextPriv.h"
@@ -23,6 +23,7 @@
 #include "src/core/SkMipmap.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkSpecialSurfacePool.h"
 #include "src/image/SkImage_Base.h"
 #include "src/image/SkReadPixelsRec.h"
 #include "src/image/SkRescaleAndReadPixels.h"
@@ -384,24 +385,25 @@ sk_sp<SkImage> SkImage::MakeFromPicture(sk_sp<SkPicture> picture, const SkISize&
                                                                std::move(colorSpace)));
 }
 
-sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkImageFilter* filter,
-                                       const SkIRect& subset, const SkIRect& clipBounds,
-                                       SkIRect* outSubset, SkIPoint* offset) const {
+static sk_sp<SkImage> make_with_filter(const SkImage* image, GrRecordingContext* rContext,
+                                       const SkImageFilter* filter, const SkIRect& subset,
+                                       const SkIRect& clipBounds, SkIRect* outSubset,
+                                       SkIPoint* offset, int tileSize, SkExecutor* executor) {
 
-    if (!filter || !outSubset || !offset || !this->bounds().contains(subset)) {
+    if (!filter || !outSubset || !offset || !image->bounds().contains(subset)) {
         return nullptr;
     }
     sk_sp<SkSpecialImage> srcSpecialImage;
 #if SK_SUPPORT_GPU
-    auto myContext = as_IB(this)->context();
+    auto myContext = as_IB(image)->context();
     if (myContext && !myContext->priv().matches(rContext)) {
         return nullptr;
     }
     srcSpecialImage = SkSpecialImage::MakeFromImage(rContext, subset,
-                                                    sk_ref_sp(const_cast<SkImage*>(this)));
+                                                    sk_ref_sp(const_cast<SkImage*>(image)));
 #else
     srcSpecialImage = SkSpecialImage::MakeFromImage(nullptr, subset,
-                                                    sk_ref_sp(const_cast<SkImage*>(this)));
+                                                    sk_ref_sp(const_cast<SkImage*>(image)));
 #endif
     if (!srcSpecialImage) {
         return nullptr;
@@ -416,10 +418,11 @@ sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkIma
     // the clip bounds (since it is assumed to already be in image space).
     SkImageFilter_Base::Context context(SkMatrix::Translate(-subset.x(), -subset.y()),
                                         clipBounds.makeOffset(-subset.topLeft()),
-                                        cache.get(), fInfo.colorType(), fInfo.colorSpace(),
-                                        srcSpecialImage.get());
+                                        cache.get(), image->colorType(), image->colorSpace(),
+                                        srcSpecialImage.get(), SkSpecialSurfacePool::Get());
 
-    sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(context).imageAndOffset(offset);
+    sk_sp<SkSpecialImage> result =
+            as_IFB(filter)->filterImageTiled(context, tileSize, executor).imageAndOffset(offset);
     if (!result) {
         return nullptr;
     }
@@ -446,6 +449,24 @@ sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkIma
     return result->asImage();
 }
 
+sk_sp<SkImage> SkImage::makeWithFilter(GrRecordingContext* rContext, const SkImageFilter* filter,
+                                       const SkIRect& subset, const SkIRect& clipBounds,
+                                       SkIRect* outSubset, SkIPoint* offset) const {
+    return make_with_filter(this, rContext, filter, subset, clipBounds, outSubset, offset,
+                            /*tileSize=*/0, /*executor=*/nullptr);
+}
+
+sk_sp<SkImage> SkImage::makeWithFilter(const SkImageFilter* filter, const SkIRect& subset,
+                                       const SkIRect& clipBounds, SkIRect* outSubset,
+                                       SkIPoint* offset, int tileSize,
+                                       SkExecutor* executor) const {
+    if (tileSize <= 0) {
+        return nullptr;
+    }
+    return make_with_filter(this, nullptr, filter, subset, clipBounds, outSubset, offset,
+                            tileSize, executor);
+}
+
 bool SkImage::isLazyGenerated() const {
     return as_IB(this)->onIsLazyGenerated();
 }
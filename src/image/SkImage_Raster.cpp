@@ -129,7 +129,7 @@ public:
         if (mips) {
             img->fBitmap.fMips = std::move(mips);
         } else {
-            img->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr));
+            img->fBitmap.fMips.reset(SkMipmap::BuildLazy(fBitmap, nullptr));
         }
         return sk_sp<SkImage>(img);
     }
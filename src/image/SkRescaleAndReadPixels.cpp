@@ -10,9 +10,25 @@
 #include "include/core/SkPaint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSurface.h"
+#include "src/core/SkResampler.h"
 
 #include <cmath>
 
+namespace {
+class Result : public SkImage::AsyncReadResult {
+public:
+    Result(std::unique_ptr<const char[]> data, size_t rowBytes)
+            : fData(std::move(data)), fRowBytes(rowBytes) {}
+    int count() const override { return 1; }
+    const void* data(int i) const override { return fData.get(); }
+    size_t rowBytes(int i) const override { return fRowBytes; }
+
+private:
+    std::unique_ptr<const char[]> fData;
+    size_t fRowBytes;
+};
+}  // namespace
+
 void SkRescaleAndReadPixels(SkBitmap bmp,
                             const SkImageInfo& resultInfo,
                             const SkIRect& srcRect,
@@ -23,6 +39,25 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
     int srcW = srcRect.width();
     int srcH = srcRect.height();
 
+    // Bicubic draws can't filter when downscaling, so for high quality resample the whole
+    // rect at once with a separable Mitchell filter instead of in bilerp steps.
+    SkPixmap srcPixmap;
+    if (rescaleQuality == kHigh_SkFilterQuality && srcRect.size() != resultInfo.dimensions() &&
+        bmp.pixmap().extractSubset(&srcPixmap, srcRect)) {
+        size_t rowBytes = resultInfo.minRowBytes();
+        std::unique_ptr<char[]> data(new char[resultInfo.height() * rowBytes]);
+        SkPixmap pm(resultInfo, data.get(), rowBytes);
+        SkResampler resampler(srcRect.size(), resultInfo.dimensions(),
+                              SkPixmap::ResampleFilter::kMitchell);
+        if (resampler.resample(srcPixmap, pm,
+                               rescaleGamma == SkSurface::RescaleGamma::kLinear)) {
+            callback(context, std::make_unique<Result>(std::move(data), rowBytes));
+        } else {
+            callback(context, nullptr);
+        }
+        return;
+    }
+
     float sx = (float)resultInfo.width() / srcW;
     float sy = (float)resultInfo.height() / srcH;
     // How many bilerp/bicubic steps to do in X and Y. + means upscaling, - means downscaling.
@@ -120,18 +155,6 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
     std::unique_ptr<char[]> data(new char[resultInfo.height() * rowBytes]);
     SkPixmap pm(resultInfo, data.get(), rowBytes);
     if (srcImage->readPixels(nullptr, pm, srcX, srcY)) {
-        class Result : public SkImage::AsyncReadResult {
-        public:
-            Result(std::unique_ptr<const char[]> data, size_t rowBytes)
-                    : fData(std::move(data)), fRowBytes(rowBytes) {}
-            int count() const override { return 1; }
-            const void* data(int i) const override { return fData.get(); }
-            size_t rowBytes(int i) const override { return fRowBytes; }
-
-        private:
-            std::unique_ptr<const char[]> fData;
-            size_t fRowBytes;
-        };
         callback(context, std::make_unique<Result>(std::move(data), rowBytes));
     } else {
         callback(context, nullptr);
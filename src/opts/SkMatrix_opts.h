@@ -0,0 +1,178 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_DEFINED
+#define SkMatrix_opts_DEFINED
+
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPoint3.h"
+#include "include/core/SkRect.h"
+#include "include/private/SkVx.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SK_OPTS_NS {
+namespace matrix {
+
+    // Points are processed as interleaved x,y pairs, eight at a time. skvx splits the vector
+    // into whatever the target supports natively: one zmm on SKX, two ymm on HSW, four xmm
+    // on SSE or NEON. Leftovers go through the same code via a padded copy, so a point maps
+    // to the same value no matter where it falls in the array.
+    using F = skvx::Vec<16, float>;
+    static constexpr int kPointsPerStep = 8;
+
+    static F splat2(float a, float b) {
+        F v;
+        for (int i = 0; i < 16; i += 2) {
+            v[i] = a;
+            v[i + 1] = b;
+        }
+        return v;
+    }
+
+    static F swap_xy(const F& v) {
+        return skvx::shuffle<1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14>(v);
+    }
+
+    static F even_lanes(const F& v) {
+        return skvx::shuffle<0,0,2,2,4,4,6,6,8,8,10,10,12,12,14,14>(v);
+    }
+
+    struct AffineStep {
+        F scale, skew, trans;
+
+        explicit AffineStep(const SkMatrix& m)
+            : scale(splat2(m.getScaleX(), m.getScaleY()))
+            , skew (splat2(m.getSkewX(),  m.getSkewY()))
+            , trans(splat2(m.getTranslateX(), m.getTranslateY())) {}
+
+        // { x0 y0 x1 y1 ... } -> { x0*sx + y0*kx + tx, y0*sy + x0*ky + ty, ... }
+        F operator()(const F& xy) const { return xy * scale + swap_xy(xy) * skew + trans; }
+    };
+
+    struct PerspStep {
+        AffineStep affine;
+        F persp, perspSwapped, persp2;
+
+        explicit PerspStep(const SkMatrix& m)
+            : affine(m)
+            , persp(splat2(m.getPerspX(), m.getPerspY()))
+            , perspSwapped(splat2(m.getPerspY(), m.getPerspX()))
+            , persp2(m.get(SkMatrix::kMPersp2)) {}
+
+        // Only the even lanes, x*p0 + y*p1 + p2, are meaningful; callers broadcast them.
+        F w(const F& xy) const { return xy * persp + swap_xy(xy) * perspSwapped + persp2; }
+    };
+
+    // Runs step on count points in chunks of kPointsPerStep, writing dst from the mapped
+    // interleaved lanes. src and dst may be the same array.
+    template <typename Step>
+    static void map_points_in_steps(SkPoint dst[], const SkPoint src[], int count,
+                                    const Step& step) {
+        while (count >= kPointsPerStep) {
+            step(F::Load(src)).store(dst);
+            src   += kPointsPerStep;
+            dst   += kPointsPerStep;
+            count -= kPointsPerStep;
+        }
+        if (count > 0) {
+            SkPoint tmp[kPointsPerStep] = {};
+            memcpy(tmp, src, count * sizeof(SkPoint));
+            step(F::Load(tmp)).store(tmp);
+            memcpy(dst, tmp, count * sizeof(SkPoint));
+        }
+    }
+
+}  // namespace matrix
+
+    /*not static*/ inline void map_affine_points(const SkMatrix& m, SkPoint dst[],
+                                                 const SkPoint src[], int count) {
+        matrix::map_points_in_steps(dst, src, count, matrix::AffineStep(m));
+    }
+
+    /*not static*/ inline void map_persp_points(const SkMatrix& m, SkPoint dst[],
+                                                const SkPoint src[], int count) {
+        using matrix::F;
+        matrix::PerspStep persp(m);
+        matrix::map_points_in_steps(dst, src, count, [&persp](const F& xy) {
+            F w = matrix::even_lanes(persp.w(xy));
+            // Like Persp_pts, a point at w == 0 maps to the origin rather than to infinity.
+            F invW = skvx::if_then_else(w != 0, 1 / w, F(0));
+            return persp.affine(xy) * invW;
+        });
+    }
+
+    /*not static*/ inline void map_homogeneous_points(const SkMatrix& m, SkPoint3 dst[],
+                                                      const SkPoint src[], int count) {
+        using matrix::F;
+        using matrix::kPointsPerStep;
+        matrix::PerspStep persp(m);
+        const bool hasPerspective = m.hasPerspective();
+        SkPoint tmp[kPointsPerStep] = {};
+        while (count > 0) {
+            int n = std::min(count, kPointsPerStep);
+            const SkPoint* from = src;
+            if (n < kPointsPerStep) {
+                memcpy(tmp, src, n * sizeof(SkPoint));
+                from = tmp;
+            }
+            F xy = F::Load(from);
+            F mapped = persp.affine(xy);
+            F w = hasPerspective ? persp.w(xy) : F(1);
+            for (int i = 0; i < n; ++i) {
+                dst[i] = { mapped[2*i], mapped[2*i + 1], w[2*i] };
+            }
+            src   += n;
+            dst   += n;
+            count -= n;
+        }
+    }
+
+    // Maps the four corners of each rect by an affine matrix and stores their bounds. Each rect
+    // is four lanes {l t r b}: mapping those as two points gives corners (l,t) and (r,b), and
+    // mapping {r t l b} gives (r,t) and (l,b). Like SkRect::setBoundsNoCheck(), a rect with any
+    // non-finite corner maps to all NaN. src and dst may be the same array.
+    /*not static*/ inline void map_affine_rects(const SkMatrix& m, SkRect dst[],
+                                                const SkRect src[], int count) {
+        using matrix::F;
+        static constexpr int kRectsPerStep = 4;
+        matrix::AffineStep affine(m);
+        const skvx::Vec<16, int> takeMax = {0,0,~0,~0, 0,0,~0,~0, 0,0,~0,~0, 0,0,~0,~0};
+
+        auto step = [&](const F& ltrb) {
+            F a = affine(ltrb),
+              b = affine(skvx::shuffle<2,1,0,3,6,5,4,7,10,9,8,11,14,13,12,15>(ltrb));
+            F lo = skvx::min(a, b),
+              hi = skvx::max(a, b);
+            lo = skvx::min(lo, skvx::shuffle<2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13>(lo));
+            hi = skvx::max(hi, skvx::shuffle<2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13>(hi));
+            // 0 where all four corners of the rect are finite, NaN otherwise.
+            F nonFinite = a * 0 + b * 0;
+            nonFinite += skvx::shuffle<2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13>(nonFinite);
+            nonFinite += skvx::shuffle<1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14>(nonFinite);
+            return skvx::if_then_else(nonFinite == 0, skvx::if_then_else(takeMax, hi, lo),
+                                      F(SK_ScalarNaN));
+        };
+
+        while (count >= kRectsPerStep) {
+            step(F::Load(src)).store(dst);
+            src   += kRectsPerStep;
+            dst   += kRectsPerStep;
+            count -= kRectsPerStep;
+        }
+        if (count > 0) {
+            SkRect tmp[kRectsPerStep] = {};
+            memcpy(tmp, src, count * sizeof(SkRect));
+            step(F::Load(tmp)).store(tmp);
+            memcpy(dst, tmp, count * sizeof(SkRect));
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMatrix_opts_DEFINED
@@ -8,10 +8,16 @@
 #include "src/core/SkOpts.h"
 
 #define SK_OPTS_NS skx
+#include "src/opts/SkMatrix_opts.h"
 #include "src/opts/SkVM_opts.h"
 
 namespace SkOpts {
     void Init_skx() {
+        map_affine_points      = SK_OPTS_NS::map_affine_points;
+        map_persp_points       = SK_OPTS_NS::map_persp_points;
+        map_homogeneous_points = SK_OPTS_NS::map_homogeneous_points;
+        map_affine_rects       = SK_OPTS_NS::map_affine_rects;
+
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     }
 }  // namespace SkOpts
@@ -282,6 +282,7 @@ bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coinc
             }
             int pts = 0;
             SkIntersections ts { SkDEBUGCODE(test->globalState()) };
+            ts.setTSectScratch(test->globalState()->tSectScratch());
             bool swap = false;
             SkDQuad quad1, quad2;
             SkDConic conic1, conic2;
@@ -13,10 +13,13 @@
 #include "src/pathops/SkPathOpsPoint.h"
 #include "src/pathops/SkPathOpsQuad.h"
 
+class SkOpScratchArena;
+
 class SkIntersections {
 public:
     SkIntersections(SkDEBUGCODE(SkOpGlobalState* globalState = nullptr))
-        : fSwap(0)
+        : fTSectScratch(nullptr)
+        , fSwap(0)
 #ifdef SK_DEBUG
         SkDEBUGPARAMS(fDebugGlobalState(globalState))
         , fDepth(0)
@@ -204,6 +207,12 @@ public:
         fMax = max;
     }
 
+    // If set, curve/curve intersections allocate their SkTSect spans here instead of on the
+    // heap, and rewind it once done.
+    void setTSectScratch(SkOpScratchArena* tSectScratch) {
+        fTSectScratch = tSectScratch;
+    }
+
     void swap() {
         fSwap ^= true;
     }
@@ -315,6 +324,7 @@ private:
     SkDPoint fPt[13];  // FIXME: since scans store points as SkPoint, this should also
     SkDPoint fPt2[2];  // used by nearly same to store alternate intersection point
     double fT[2][13];
+    SkOpScratchArena* fTSectScratch;
     uint16_t fIsCoincident[2];  // bit set for each curve's coincident T
     bool fNearlySame[2];  // true if end points nearly match
     unsigned char fUsed;
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "include/pathops/SkPathOps.h"
+#include "src/pathops/SkOpScratch.h"
+
+SkOpScratchArena::SkOpScratchArena(size_t initialSize)
+    : fSize(initialSize)
+    , fInitialSize(initialSize)
+    , fGrowCount(0) {
+    fBlock.reset(new char[fSize]);
+    fArena.init(fBlock.get(), fSize, fSize);
+}
+
+void SkOpScratchArena::rewind() {
+    size_t spilled = fArena->heapBytesAllocated();
+    fArena.reset();
+    if (spilled) {
+        fSize += spilled;
+        fBlock.reset(new char[fSize]);
+        ++fGrowCount;
+    }
+    fArena.init(fBlock.get(), fSize, fSize);
+}
+
+void SkOpScratchArena::reset() {
+    fArena.reset();
+    fSize = fInitialSize;
+    fGrowCount = 0;
+    fBlock.reset(new char[fSize]);
+    fArena.init(fBlock.get(), fSize, fSize);
+}
+
+SkOpScratch::SkOpScratch()
+    : fContours(4096)
+    , fTSect(1024)
+    , fOpCount(0) {
+}
+
+SkOpContext::SkOpContext() : fScratch(new SkOpScratch) {}
+
+SkOpContext::~SkOpContext() = default;
+
+SkOpContext::Stats SkOpContext::stats() const {
+    Stats stats;
+    stats.fOpCount = fScratch->fOpCount;
+    stats.fArenaGrowths = fScratch->fContours.growCount() + fScratch->fTSect.growCount();
+    stats.fBytesReserved = fScratch->fContours.bytesReserved() + fScratch->fTSect.bytesReserved();
+    return stats;
+}
+
+void SkOpContext::reset() {
+    fScratch->fContours.reset();
+    fScratch->fTSect.reset();
+    fScratch->fOpCount = 0;
+}
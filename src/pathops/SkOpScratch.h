@@ -0,0 +1,52 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkOpScratch_DEFINED
+#define SkOpScratch_DEFINED
+
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkTLazy.h"
+
+#include <memory>
+
+// An arena over a block that outlives it. Rewinding destroys everything allocated since the
+// last rewind but keeps the block; if that use spilled onto the heap, the block is enlarged to
+// cover the spill so that the next use of the same size is carved entirely out of the block.
+class SkOpScratchArena {
+public:
+    explicit SkOpScratchArena(size_t initialSize);
+
+    SkArenaAlloc* get() { return fArena.get(); }
+
+    void rewind();
+
+    // Frees the block and starts over at the initial size.
+    void reset();
+
+    size_t bytesReserved() const { return fSize; }
+    int growCount() const { return fGrowCount; }
+
+private:
+    std::unique_ptr<char[]> fBlock;
+    size_t fSize;
+    const size_t fInitialSize;
+    int fGrowCount;
+    SkTLazy<SkArenaAlloc> fArena;
+};
+
+// The scratch state behind SkOpContext.
+class SkOpScratch {
+public:
+    SkOpScratch();
+
+    // Holds the contours, segments, spans, angles and coincidences of one op.
+    SkOpScratchArena fContours;
+    // Holds the spans of the two SkTSects intersecting one pair of curves.
+    SkOpScratchArena fTSect;
+    int fOpCount;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/pathops/SkPathOps.h"
+#include "src/core/SkRTree.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+// Combines paths[0..count) in place as a balanced tree of pairwise ops, leaving the product in
+// paths[0]. Each level halves the operand count, so intermediate results stay small and the
+// pairs within a level are independent of one another.
+static bool reduce_pairwise(SkPath paths[], int count, SkPathOp op, SkExecutor* executor) {
+    if (count == 1) {
+        return Simplify(paths[0], &paths[0]);
+    }
+    while (count > 1) {
+        int pairs = count >> 1;
+        std::atomic<bool> failed{false};
+        auto combine = [&](int i) {
+            // Each pair writes only its own first operand, so pairs never touch one another.
+            if (!Op(paths[2 * i], paths[2 * i + 1], op, &paths[2 * i])) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+        if (executor && pairs > 1) {
+            SkTaskGroup(*executor).batch(pairs, combine);
+        } else {
+            for (int i = 0; i < pairs; ++i) {
+                combine(i);
+            }
+        }
+        if (failed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        // Now that every pair is done, pack the results to the front for the next level.
+        for (int i = 1; i < pairs; ++i) {
+            paths[i] = std::move(paths[2 * i]);
+        }
+        if (count & 1) {
+            paths[pairs] = std::move(paths[count - 1]);
+        }
+        count = pairs + (count & 1);
+    }
+    return true;
+}
+
+// Grow the query by one ulp on each side so that operands which merely share an edge end up in
+// the same cluster; their union should merge the shared edge rather than leave two contours.
+static SkRect touch_bounds(const SkRect& r) {
+    return { std::nextafter(r.fLeft, -SK_ScalarInfinity),
+             std::nextafter(r.fTop, -SK_ScalarInfinity),
+             std::nextafter(r.fRight, SK_ScalarInfinity),
+             std::nextafter(r.fBottom, SK_ScalarInfinity) };
+}
+
+static int find_root(std::vector<int>* parents, int index) {
+    std::vector<int>& parent = *parents;
+    while (parent[index] != index) {
+        parent[index] = parent[parent[index]];
+        index = parent[index];
+    }
+    return index;
+}
+
+static bool bulk_union(const SkPath paths[], int count, SkPath* result, SkExecutor* executor) {
+    std::vector<const SkPath*> operands;
+    std::vector<SkRect> bounds;
+    operands.reserve(count);
+    bounds.reserve(count);
+    for (int index = 0; index < count; ++index) {
+        if (!paths[index].isEmpty()) {
+            operands.push_back(&paths[index]);
+            bounds.push_back(paths[index].getBounds());
+        }
+    }
+    int operandCount = SkToInt(operands.size());
+    if (!operandCount) {
+        result->reset();
+        return true;
+    }
+
+    // Cluster operands whose bounds overlap, transitively. Clusters can then be resolved
+    // independently since their products cannot intersect.
+    std::vector<int> parents(operandCount);
+    for (int index = 0; index < operandCount; ++index) {
+        parents[index] = index;
+    }
+    SkRTree rtree;
+    rtree.insert(bounds.data(), operandCount);
+    std::vector<int> hits;
+    for (int index = 0; index < operandCount; ++index) {
+        hits.clear();
+        rtree.search(touch_bounds(bounds[index]), &hits);
+        int root = find_root(&parents, index);
+        for (int hit : hits) {
+            int hitRoot = find_root(&parents, hit);
+            if (hitRoot != root) {
+                parents[std::max(root, hitRoot)] = std::min(root, hitRoot);
+                root = std::min(root, hitRoot);
+            }
+        }
+    }
+
+    struct Cluster {
+        std::vector<SkPath> fPaths;
+        SkRect fBounds = SkRect::MakeEmpty();
+    };
+    std::vector<int> clusterOf(operandCount, -1);
+    std::vector<Cluster> clusters;
+    for (int index = 0; index < operandCount; ++index) {
+        int root = find_root(&parents, index);
+        if (clusterOf[root] < 0) {
+            clusterOf[root] = SkToInt(clusters.size());
+            clusters.emplace_back();
+        }
+        Cluster& cluster = clusters[clusterOf[root]];
+        cluster.fPaths.push_back(*operands[index]);
+        cluster.fBounds.join(bounds[index]);
+    }
+
+    int clusterCount = SkToInt(clusters.size());
+    std::atomic<bool> failed{false};
+    if (clusterCount == 1) {
+        // A single cluster can still use the executor for the pairs of each level.
+        Cluster& cluster = clusters[0];
+        if (!reduce_pairwise(cluster.fPaths.data(), SkToInt(cluster.fPaths.size()),
+                             kUnion_SkPathOp, executor)) {
+            return false;
+        }
+    } else {
+        auto resolveCluster = [&](int index) {
+            Cluster& cluster = clusters[index];
+            if (!reduce_pairwise(cluster.fPaths.data(), SkToInt(cluster.fPaths.size()),
+                                 kUnion_SkPathOp, nullptr)) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+        if (executor) {
+            SkTaskGroup(*executor).batch(clusterCount, resolveCluster);
+        } else {
+            for (int index = 0; index < clusterCount; ++index) {
+                resolveCluster(index);
+            }
+        }
+        if (failed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+
+    // Sweep the cluster products left to right, top to bottom, so the output is deterministic
+    // regardless of the order in which the executor finished them. The products do not
+    // overlap, so appending them preserves the even-odd fill of each.
+    std::sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.fBounds.fLeft < b.fBounds.fLeft ||
+               (a.fBounds.fLeft == b.fBounds.fLeft && a.fBounds.fTop < b.fBounds.fTop);
+    });
+    SkPath sum;
+    for (const Cluster& cluster : clusters) {
+        sum.addPath(cluster.fPaths[0]);
+    }
+    sum.setFillType(SkPathFillType::kEvenOdd);
+    *result = std::move(sum);
+    return true;
+}
+
+static bool bulk_intersect(const SkPath paths[], int count, SkPath* result,
+                           SkExecutor* executor) {
+    // The product lies inside every operand's bounds; if they share no common area, the
+    // intersection is empty and no op needs to run.
+    SkRect common = paths[0].getBounds();
+    for (int index = 1; index < count; ++index) {
+        if (!common.intersect(paths[index].getBounds())) {
+            result->reset();
+            return true;
+        }
+    }
+    std::vector<SkPath> operands(paths, paths + count);
+    if (!reduce_pairwise(operands.data(), count, kIntersect_SkPathOp, executor)) {
+        return false;
+    }
+    *result = std::move(operands[0]);
+    return true;
+}
+
+bool BulkOp(const SkPath paths[], int count, SkPathOp op, SkPath* result,
+            SkExecutor* executor) {
+    if (op != kUnion_SkPathOp && op != kIntersect_SkPathOp) {
+        return false;
+    }
+    if (count <= 0) {
+        result->reset();
+        return true;
+    }
+    for (int index = 0; index < count; ++index) {
+        if (paths[index].isInverseFillType()) {
+            // Inverse operands cover the plane outside their bounds, so the spatial grouping
+            // does not apply; fall back to resolving the ops in sequence.
+            SkOpBuilder builder;
+            for (int inner = 0; inner < count; ++inner) {
+                builder.add(paths[inner], inner ? op : kUnion_SkPathOp);
+            }
+            return builder.resolve(result);
+        }
+    }
+    return kUnion_SkPathOp == op ? bulk_union(paths, count, result, executor)
+                                 : bulk_intersect(paths, count, result, executor);
+}
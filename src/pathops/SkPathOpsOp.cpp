@@ -7,6 +7,7 @@
 #include "src/pathops/SkAddIntersections.h"
 #include "src/pathops/SkOpCoincidence.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
+#include "src/pathops/SkOpScratch.h"
 #include "src/pathops/SkPathOpsCommon.h"
 #include "src/pathops/SkPathWriter.h"
 
@@ -236,16 +237,10 @@ extern void (*gVerboseFinalize)();
 
 #endif
 
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
-        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
-#if DEBUG_DUMP_VERIFY
-#ifndef SK_DEBUG
-    const char* testName = "release";
-#endif
-    if (SkPathOpsDebug::gDumpOp) {
-        SkPathOpsDebug::DumpOp(one, two, op, testName);
-    }
-#endif
+// If scratch is not null, the op is carved out of its arenas. The caller rewinds the contour
+// arena once the op has returned and nothing on this stack frame refers to it any longer.
+static bool op_internal(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        SkOpScratch* scratch SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     op = gOpInverse[op][one.isInverseFillType()][two.isInverseFillType()];
     bool inverseFill = gOutInverse[op][one.isInverseFillType()][two.isInverseFillType()];
     SkPathFillType fillType = inverseFill ? SkPathFillType::kInverseEvenOdd :
@@ -286,11 +281,15 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         }
         return Simplify(work, result);
     }
-    SkSTArenaAlloc<4096> allocator;  // FIXME: add a constant expression here, tune
+    SkSTArenaAlloc<4096> localAllocator;  // FIXME: add a constant expression here, tune
+    SkArenaAlloc* allocator = scratch ? scratch->fContours.get() : &localAllocator;
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
-    SkOpGlobalState globalState(contourList, &allocator
+    SkOpGlobalState globalState(contourList, allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    if (scratch) {
+        globalState.setTSectScratch(&scratch->fTSect);
+    }
     SkOpCoincidence coincidence(&globalState);
     const SkPath* minuend = &one;
     const SkPath* subtrahend = &two;
@@ -367,6 +366,20 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
     return true;
 }
 
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
+        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+#if DEBUG_DUMP_VERIFY
+#ifndef SK_DEBUG
+    const char* testName = "release";
+#endif
+    if (SkPathOpsDebug::gDumpOp) {
+        SkPathOpsDebug::DumpOp(one, two, op, testName);
+    }
+#endif
+    return op_internal(one, two, op, result, nullptr
+            SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+}
+
 bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
@@ -380,3 +393,11 @@ bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
 #endif
     return OpDebug(one, two, op, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
+
+bool SkOpContext::op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    ++fScratch->fOpCount;
+    bool success = op_internal(one, two, op, result, fScratch.get()
+            SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    fScratch->fContours.rewind();
+    return success;
+}
@@ -7,6 +7,7 @@
 #include "src/pathops/SkAddIntersections.h"
 #include "src/pathops/SkOpCoincidence.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
+#include "src/pathops/SkOpScratch.h"
 #include "src/pathops/SkPathOpsCommon.h"
 #include "src/pathops/SkPathWriter.h"
 
@@ -137,7 +138,9 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* writer) {
 }
 
 // FIXME : add this as a member of SkPath
-bool SimplifyDebug(const SkPath& path, SkPath* result
+// If scratch is not null, the simplify is carved out of its arenas. The caller rewinds the
+// contour arena once this has returned.
+static bool simplify_internal(const SkPath& path, SkPath* result, SkOpScratch* scratch
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPathFillType fillType = path.isInverseFillType() ? SkPathFillType::kInverseEvenOdd
@@ -150,11 +153,15 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
         return true;
     }
     // turn path into list of segments
-    SkSTArenaAlloc<4096> allocator;  // FIXME: constant-ize, tune
+    SkSTArenaAlloc<4096> localAllocator;  // FIXME: constant-ize, tune
+    SkArenaAlloc* allocator = scratch ? scratch->fContours.get() : &localAllocator;
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
-    SkOpGlobalState globalState(contourList, &allocator
+    SkOpGlobalState globalState(contourList, allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    if (scratch) {
+        globalState.setTSectScratch(&scratch->fTSect);
+    }
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
@@ -211,6 +218,12 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
     return true;
 }
 
+bool SimplifyDebug(const SkPath& path, SkPath* result
+        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+    return simplify_internal(path, result, nullptr
+            SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+}
+
 bool Simplify(const SkPath& path, SkPath* result) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
@@ -224,3 +237,11 @@ bool Simplify(const SkPath& path, SkPath* result) {
 #endif
     return SimplifyDebug(path, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
+
+bool SkOpContext::simplify(const SkPath& path, SkPath* result) {
+    ++fScratch->fOpCount;
+    bool success = simplify_internal(path, result, fScratch.get()
+            SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    fScratch->fContours.rewind();
+    return success;
+}
@@ -6,6 +6,7 @@
  */
 
 #include "src/core/SkTSort.h"
+#include "src/pathops/SkOpScratch.h"
 #include "src/pathops/SkPathOpsTSect.h"
 
 #define COINCIDENT_SPAN_COUNT 9
@@ -496,11 +497,12 @@ void SkTSpan::validatePerpPt(double t, const SkDPoint& pt) const {
     SkASSERT(fDebugSect->fOppSect->fCurve.ptAtT(t) == pt);
 }
 
-SkTSect::SkTSect(const SkTCurve& c
+SkTSect::SkTSect(const SkTCurve& c, SkArenaAlloc* heap
         SkDEBUGPARAMS(SkOpGlobalState* debugGlobalState)
         PATH_OPS_DEBUG_T_SECT_PARAMS(int id))
     : fCurve(c)
-    , fHeap(sizeof(SkTSpan) * 4)
+    , fLocalHeap(sizeof(SkTSpan) * 4)
+    , fHeap(heap ? *heap : fLocalHeap)
     , fCoincident(nullptr)
     , fDeleted(nullptr)
     , fActiveCount(0)
@@ -2082,11 +2084,33 @@ void SkTSect::BinarySearch(SkTSect* sect1,
     SkOPOBJASSERT(intersections, intersections->used() <= sect1->fCurve.maxIntersections());
 }
 
+// Rewinds the scratch arena, if any, once the SkTSects allocating from it are destroyed.
+class SkAutoTSectScratch {
+public:
+    explicit SkAutoTSectScratch(SkOpScratchArena* scratch) : fScratch(scratch) {}
+
+    ~SkAutoTSectScratch() {
+        if (fScratch) {
+            fScratch->rewind();
+        }
+    }
+
+    SkArenaAlloc* heap() const {
+        return fScratch ? fScratch->get() : nullptr;
+    }
+
+private:
+    SkOpScratchArena* fScratch;
+};
+
 int SkIntersections::intersect(const SkDQuad& q1, const SkDQuad& q2) {
     SkTQuad quad1(q1);
     SkTQuad quad2(q2);
-    SkTSect sect1(quad1  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(quad2  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(quad1, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(quad2, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -2094,8 +2118,11 @@ int SkIntersections::intersect(const SkDQuad& q1, const SkDQuad& q2) {
 int SkIntersections::intersect(const SkDConic& c, const SkDQuad& q) {
     SkTConic conic(c);
     SkTQuad quad(q);
-    SkTSect sect1(conic  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(quad  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(conic, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(quad, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -2103,8 +2130,11 @@ int SkIntersections::intersect(const SkDConic& c, const SkDQuad& q) {
 int SkIntersections::intersect(const SkDConic& c1, const SkDConic& c2) {
     SkTConic conic1(c1);
     SkTConic conic2(c2);
-    SkTSect sect1(conic1  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(conic2  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(conic1, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(conic2, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -2112,8 +2142,11 @@ int SkIntersections::intersect(const SkDConic& c1, const SkDConic& c2) {
 int SkIntersections::intersect(const SkDCubic& c, const SkDQuad& q) {
     SkTCubic cubic(c);
     SkTQuad quad(q);
-    SkTSect sect1(cubic  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(quad  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(cubic, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(quad, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -2121,8 +2154,11 @@ int SkIntersections::intersect(const SkDCubic& c, const SkDQuad& q) {
 int SkIntersections::intersect(const SkDCubic& cu, const SkDConic& co) {
     SkTCubic cubic(cu);
     SkTConic conic(co);
-    SkTSect sect1(cubic  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(conic  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(cubic, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(conic, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 
@@ -2131,8 +2167,11 @@ int SkIntersections::intersect(const SkDCubic& cu, const SkDConic& co) {
 int SkIntersections::intersect(const SkDCubic& c1, const SkDCubic& c2) {
     SkTCubic cubic1(c1);
     SkTCubic cubic2(c2);
-    SkTSect sect1(cubic1  SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect sect2(cubic2   SkDEBUGPARAMS(globalState())  PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkAutoTSectScratch scratch(fTSectScratch);
+    SkTSect sect1(cubic1, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect sect2(cubic2, scratch.heap()  SkDEBUGPARAMS(globalState())
+            PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -243,7 +243,8 @@ private:
 
 class SkTSect {
 public:
-    SkTSect(const SkTCurve& c
+    // If heap is null, spans are allocated from the sect's own arena.
+    SkTSect(const SkTCurve& c, SkArenaAlloc* heap
                              SkDEBUGPARAMS(SkOpGlobalState* ) PATH_OPS_DEBUG_T_SECT_PARAMS(int id));
     static void BinarySearch(SkTSect* sect1, SkTSect* sect2,
             SkIntersections* intersections);
@@ -352,7 +353,8 @@ private:
     void validateBounded() const;
 
     const SkTCurve& fCurve;
-    SkSTArenaAlloc<1024> fHeap;
+    SkSTArenaAlloc<1024> fLocalHeap;
+    SkArenaAlloc& fHeap;
     SkTSpan* fHead;
     SkTSpan* fCoincident;
     SkTSpan* fDeleted;
@@ -26,6 +26,7 @@ class SkArenaAlloc;
 class SkOpCoincidence;
 class SkOpContour;
 class SkOpContourHead;
+class SkOpScratchArena;
 class SkIntersections;
 class SkIntersectionHelper;
 
@@ -171,11 +172,19 @@ public:
         fPhase = phase;
     }
 
+    void setTSectScratch(SkOpScratchArena* tSectScratch) {
+        fTSectScratch = tSectScratch;
+    }
+
     // called in very rare cases where angles are sorted incorrectly -- signfies op will fail
     void setWindingFailed() {
         fWindingFailed = true;
     }
 
+    SkOpScratchArena* tSectScratch() const {
+        return fTSectScratch;
+    }
+
     bool windingFailed() const {
         return fWindingFailed;
     }
@@ -184,6 +193,7 @@ private:
     SkArenaAlloc* fAllocator;
     SkOpCoincidence* fCoincidence;
     SkOpContourHead* fContourHead;
+    SkOpScratchArena* fTSectScratch;
     int fNested;
     bool fAllocatedOpSpan;
     bool fWindingFailed;
@@ -50,8 +50,8 @@ sk_sp<SkFlattenable> SkColor4Shader::CreateProc(SkReadBuffer& buffer) {
     sk_sp<SkColorSpace> colorSpace;
     buffer.readColor4f(&color);
     if (buffer.readBool()) {
-        sk_sp<SkData> data = buffer.readByteArrayAsData();
-        colorSpace = data ? SkColorSpace::Deserialize(data->data(), data->size()) : nullptr;
+        SkSpan<const uint8_t> data = buffer.readByteArrayView();
+        colorSpace = SkColorSpace::Deserialize(data.data(), data.size());
     }
     return SkShaders::Color(color, std::move(colorSpace));
 }
@@ -98,8 +98,8 @@ bool SkGradientShaderBase::DescriptorScope::unflatten(SkReadBuffer& buffer) {
     fColors = fColorStorage.begin();
 
     if (SkToBool(flags & kHasColorSpace_GSF)) {
-        sk_sp<SkData> data = buffer.readByteArrayAsData();
-        fColorSpace = data ? SkColorSpace::Deserialize(data->data(), data->size()) : nullptr;
+        SkSpan<const uint8_t> data = buffer.readByteArrayView();
+        fColorSpace = SkColorSpace::Deserialize(data.data(), data.size());
     } else {
         fColorSpace = nullptr;
     }
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkCompactPath.h"
+
+#include "include/private/SkTDArray.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkPathPriv.h"
+
+#include <cstring>
+
+// Layout of fData:
+//   verb runs:   [verb byte][varint run length], repeated; fVerbBytes in total
+//   points:      [zigzag varint dx][zigzag varint dy], repeated; fPointBytes in total
+//   weights:     fConicCount floats, unaligned
+//
+// Each point is quantized to 16 bits per axis relative to the bounds, and stored as the
+// difference from the previous quantized point, wrapped to 16 bits and zigzag encoded so that
+// small steps in either direction take a single byte.
+
+static constexpr int kQuantMax = 0xFFFF;
+
+static void write_varint(uint32_t value, SkTDArray<uint8_t>* out) {
+    while (value >= 0x80) {
+        *out->append() = SkToU8((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *out->append() = SkToU8(value);
+}
+
+static uint32_t read_varint(const uint8_t** cursor) {
+    const uint8_t* p = *cursor;
+    uint32_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = *p++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    *cursor = p;
+    return value;
+}
+
+static uint32_t zigzag(uint16_t from, uint16_t to) {
+    int16_t delta = (int16_t)(uint16_t)(to - from);
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 15);
+}
+
+static uint16_t unzigzag(uint16_t from, uint32_t encoded) {
+    int32_t delta = (int32_t)(encoded >> 1) ^ -(int32_t)(encoded & 1);
+    return (uint16_t)(from + delta);
+}
+
+static uint16_t quantize(SkScalar value, SkScalar origin, SkScalar scale) {
+    if (scale <= 0) {
+        return 0;
+    }
+    float q = sk_float_round((value - origin) / scale);
+    return (uint16_t)SkTPin(q, 0.0f, (float)kQuantMax);
+}
+
+static SkVector quant_scale(const SkRect& bounds) {
+    return { bounds.width() / kQuantMax, bounds.height() / kQuantMax };
+}
+
+SkCompactPath SkCompactPath::Make(const SkPath& path) {
+    SkCompactPath compact;
+    if (!path.isFinite()) {
+        return compact;
+    }
+    compact.fFillType = path.getFillType();
+    compact.fVerbCount = path.countVerbs();
+    compact.fPointCount = path.countPoints();
+    compact.fConicCount = SkPathPriv::ConicWeightCnt(path);
+    if (!compact.fVerbCount) {
+        return compact;
+    }
+    compact.fBounds = path.getBounds();
+
+    SkTDArray<uint8_t> verbs;
+    const uint8_t* verbData = SkPathPriv::VerbData(path);
+    for (int index = 0; index < compact.fVerbCount;) {
+        uint8_t verb = verbData[index];
+        int run = 1;
+        while (index + run < compact.fVerbCount && verbData[index + run] == verb) {
+            ++run;
+        }
+        *verbs.append() = verb;
+        write_varint(run, &verbs);
+        index += run;
+    }
+
+    SkTDArray<uint8_t> points;
+    points.setReserve(compact.fPointCount * 3);
+    const SkPoint* pointData = SkPathPriv::PointData(path);
+    SkVector scale = quant_scale(compact.fBounds);
+    uint16_t lastX = 0, lastY = 0;
+    for (int index = 0; index < compact.fPointCount; ++index) {
+        uint16_t x = quantize(pointData[index].fX, compact.fBounds.fLeft, scale.fX);
+        uint16_t y = quantize(pointData[index].fY, compact.fBounds.fTop, scale.fY);
+        write_varint(zigzag(lastX, x), &points);
+        write_varint(zigzag(lastY, y), &points);
+        lastX = x;
+        lastY = y;
+    }
+
+    compact.fVerbBytes = verbs.count();
+    compact.fPointBytes = points.count();
+    size_t weightBytes = compact.fConicCount * sizeof(SkScalar);
+    sk_sp<SkData> data = SkData::MakeUninitialized(verbs.count() + points.count() + weightBytes);
+    char* dst = (char*)data->writable_data();
+    memcpy(dst, verbs.begin(), verbs.count());
+    memcpy(dst + verbs.count(), points.begin(), points.count());
+    if (weightBytes) {
+        memcpy(dst + verbs.count() + points.count(), SkPathPriv::ConicWeightData(path),
+               weightBytes);
+    }
+    compact.fData = std::move(data);
+    return compact;
+}
+
+SkPath SkCompactPath::toPath() const {
+    if (!fVerbCount) {
+        SkPath empty;
+        empty.setFillType(fFillType);
+        return empty;
+    }
+    SkAutoSTMalloc<64, uint8_t> verbs(fVerbCount);
+    SkAutoSTMalloc<64, SkPoint> points(fPointCount);
+    SkAutoSTMalloc<8, SkScalar> weights(fConicCount);
+    int verbIndex = 0, pointIndex = 0, weightIndex = 0;
+
+    Iter iter(*this);
+    SkPathVerb verb;
+    SkPoint pts[4];
+    SkScalar weight;
+    while (iter.next(&verb, pts, &weight)) {
+        verbs[verbIndex++] = (uint8_t)verb;
+        switch (verb) {
+            case SkPathVerb::kMove:
+                points[pointIndex++] = pts[0];
+                break;
+            case SkPathVerb::kLine:
+                points[pointIndex++] = pts[1];
+                break;
+            case SkPathVerb::kConic:
+                weights[weightIndex++] = weight;
+                [[fallthrough]];
+            case SkPathVerb::kQuad:
+                points[pointIndex++] = pts[1];
+                points[pointIndex++] = pts[2];
+                break;
+            case SkPathVerb::kCubic:
+                points[pointIndex++] = pts[1];
+                points[pointIndex++] = pts[2];
+                points[pointIndex++] = pts[3];
+                break;
+            case SkPathVerb::kClose:
+                break;
+        }
+    }
+    SkASSERT(verbIndex == fVerbCount && pointIndex == fPointCount && weightIndex == fConicCount);
+    return SkPath::Make(points.get(), pointIndex, verbs.get(), verbIndex,
+                        weights.get(), weightIndex, fFillType);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkCompactPath::Iter::Iter(const SkCompactPath& path)
+    : fRunVerb(SkPathVerb::kMove)
+    , fRunRemaining(0)
+    , fLastX(0)
+    , fLastY(0)
+    , fLastPt({0, 0})
+    , fOrigin({path.fBounds.fLeft, path.fBounds.fTop})
+    , fScale(quant_scale(path.fBounds)) {
+    const uint8_t* base = path.fData ? path.fData->bytes() : nullptr;
+    fVerbs = base;
+    fVerbsStop = base + path.fVerbBytes;
+    fPoints = fVerbsStop;
+    fWeights = fPoints + path.fPointBytes;
+}
+
+SkPoint SkCompactPath::Iter::decodePoint() {
+    fLastX = unzigzag(fLastX, read_varint(&fPoints));
+    fLastY = unzigzag(fLastY, read_varint(&fPoints));
+    return { fOrigin.fX + fLastX * fScale.fX, fOrigin.fY + fLastY * fScale.fY };
+}
+
+bool SkCompactPath::Iter::next(SkPathVerb* verb, SkPoint pts[4], SkScalar* weight) {
+    if (!fRunRemaining) {
+        if (fVerbs == fVerbsStop) {
+            return false;
+        }
+        fRunVerb = (SkPathVerb)*fVerbs++;
+        fRunRemaining = read_varint(&fVerbs);
+    }
+    --fRunRemaining;
+    *verb = fRunVerb;
+    pts[0] = fLastPt;
+    switch (fRunVerb) {
+        case SkPathVerb::kMove:
+            pts[0] = fLastPt = this->decodePoint();
+            break;
+        case SkPathVerb::kLine:
+            pts[1] = fLastPt = this->decodePoint();
+            break;
+        case SkPathVerb::kConic:
+            memcpy(weight, fWeights, sizeof(SkScalar));
+            fWeights += sizeof(SkScalar);
+            [[fallthrough]];
+        case SkPathVerb::kQuad:
+            pts[1] = this->decodePoint();
+            pts[2] = fLastPt = this->decodePoint();
+            break;
+        case SkPathVerb::kCubic:
+            pts[1] = this->decodePoint();
+            pts[2] = this->decodePoint();
+            pts[3] = fLastPt = this->decodePoint();
+            break;
+        case SkPathVerb::kClose:
+            break;
+    }
+    return true;
+}
@@ -17,9 +17,28 @@
 #include "src/utils/SkMultiPictureDocumentPriv.h"
 
 #include <limits.h>
+#include <vector>
 
 /*
   File format:
+      BEGINNING_OF_FILE:
+        kMagic
+        uint32_t version_number (==3)
+        {
+          skp file
+        } * page_count
+        {
+          float sizeX
+          float sizeY
+          uint64_t offset  (of the page's skp file, from BEGINNING_OF_FILE)
+        } * page_count
+        uint32_t page_count
+        kEndOfFile
+
+  Each page is written as it ends, as a picture of its own, and the table at the end lets a
+  reader go straight to any one of them.
+
+  Version 2, which is still read, kept every page until the end:
       BEGINNING_OF_FILE:
         kMagic
         uint32_t version_number (==2)
@@ -28,7 +47,7 @@
           float sizeX
           float sizeY
         } * page_count
-        skp file
+        skp file, with each page followed by a kEndPage annotation
 */
 
 namespace {
@@ -37,112 +56,160 @@ static constexpr char kMagic[] = "Skia Multi-Picture Doc\n\n";
 
 static constexpr char kEndPage[] = "SkMultiPictureEndPage";
 
-const uint32_t kVersion = 2;
+const uint32_t kVersion = 3;
+const uint32_t kUnindexedVersion = 2;
 
-static SkSize join(const SkTArray<SkSize>& sizes) {
-    SkSize joined = {0, 0};
-    for (SkSize s : sizes) {
-        joined = SkSize{std::max(joined.width(), s.width()), std::max(joined.height(), s.height())};
-    }
-    return joined;
-}
+// The last four bytes of a (version 3) document, to tell it was finished.
+const uint32_t kEndOfFile = SkSetFourByteTag('m', 'p', 'd', 'e');
+
+constexpr size_t kHeaderSize = sizeof(kMagic) - 1 + sizeof(uint32_t);
+constexpr size_t kPageEntrySize = 2 * sizeof(float) + sizeof(uint64_t);
+constexpr size_t kTrailerSize = 2 * sizeof(uint32_t);
 
 struct MultiPictureDocument final : public SkDocument {
     const SkSerialProcs fProcs;
     SkPictureRecorder fPictureRecorder;
     SkSize fCurrentPageSize;
-    SkTArray<sk_sp<SkPicture>> fPages;
     SkTArray<SkSize> fSizes;
+    SkTArray<uint64_t> fOffsets;
+    size_t fBase = 0;  // Where the document starts in the stream.
+    bool fStarted = false;
     MultiPictureDocument(SkWStream* s, const SkSerialProcs* procs)
         : SkDocument(s)
         , fProcs(procs ? *procs : SkSerialProcs())
     {}
     ~MultiPictureDocument() override { this->close(); }
 
+    void writeHeader(SkWStream* wStream) {
+        if (!fStarted) {
+            fStarted = true;
+            fBase = wStream->bytesWritten();
+            wStream->writeText(kMagic);
+            wStream->write32(kVersion);
+        }
+    }
+
     SkCanvas* onBeginPage(SkScalar w, SkScalar h) override {
         fCurrentPageSize.set(w, h);
         return fPictureRecorder.beginRecording(w, h);
     }
     void onEndPage() override {
+        SkWStream* wStream = this->getStream();
+        this->writeHeader(wStream);
         fSizes.push_back(fCurrentPageSize);
-        fPages.push_back(fPictureRecorder.finishRecordingAsPicture());
+        fOffsets.push_back(wStream->bytesWritten() - fBase);
+        fPictureRecorder.finishRecordingAsPicture()->serialize(wStream, &fProcs);
     }
     void onClose(SkWStream* wStream) override {
         SkASSERT(wStream);
-        SkASSERT(wStream->bytesWritten() == 0);
-        wStream->writeText(kMagic);
-        wStream->write32(kVersion);
-        wStream->write32(SkToU32(fPages.count()));
-        for (SkSize s : fSizes) {
-            wStream->write(&s, sizeof(s));
+        this->writeHeader(wStream);
+        for (int i = 0; i < fSizes.count(); ++i) {
+            wStream->writeScalar(fSizes[i].width());
+            wStream->writeScalar(fSizes[i].height());
+            wStream->write(&fOffsets[i], sizeof(uint64_t));
         }
-        SkSize bigsize = join(fSizes);
-        SkCanvas* c = fPictureRecorder.beginRecording(SkRect::MakeSize(bigsize));
-        for (const sk_sp<SkPicture>& page : fPages) {
-            c->drawPicture(page);
-            // Annotations must include some data.
-            c->drawAnnotation(SkRect::MakeEmpty(), kEndPage, SkData::MakeWithCString("X"));
-        }
-        sk_sp<SkPicture> p = fPictureRecorder.finishRecordingAsPicture();
-        p->serialize(wStream, &fProcs);
-        fPages.reset();
-        fSizes.reset();
-        return;
+        wStream->write32(SkToU32(fSizes.count()));
+        wStream->write32(kEndOfFile);
+        this->onAbort();
     }
     void onAbort() override {
-        fPages.reset();
         fSizes.reset();
+        fOffsets.reset();
     }
 };
-}  // namespace
-
-sk_sp<SkDocument> SkMakeMultiPictureDocument(SkWStream* wStream, const SkSerialProcs* procs) {
-    return sk_make_sp<MultiPictureDocument>(wStream, procs);
-}
-
-////////////////////////////////////////////////////////////////////////////////
 
-int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
-    if (!stream) {
+// Reads the header, returning the version and the page count, and leaving the stream at the page
+// sizes: those of a version 2 document, or the page table of a version 3 one.
+static int read_header(SkStreamSeekable* stream, uint32_t* version) {
+    if (!stream || !stream->rewind()) {
         return 0;
     }
-    stream->seek(0);
     const size_t size = sizeof(kMagic) - 1;
     char buffer[size];
     if (size != stream->read(buffer, size) || 0 != memcmp(kMagic, buffer, size)) {
-        stream = nullptr;
         return 0;
     }
-    uint32_t versionNumber;
-    if (!stream->readU32(&versionNumber) || versionNumber != kVersion) {
+    if (!stream->readU32(version)) {
         return 0;
     }
     uint32_t pageCount;
-    if (!stream->readU32(&pageCount) || pageCount > INT_MAX) {
+    if (*version == kUnindexedVersion) {
+        if (!stream->readU32(&pageCount) || pageCount > INT_MAX) {
+            return 0;
+        }
+        return SkTo<int>(pageCount);
+    }
+    if (*version != kVersion) {
+        return 0;
+    }
+
+    size_t length;
+    if (stream->hasLength()) {
+        length = stream->getLength();
+    } else {
+        // Seeking past the end leaves a stream at its end.
+        stream->seek(SIZE_MAX);
+        length = stream->getPosition();
+    }
+    uint32_t endOfFile;
+    if (length < kHeaderSize + kTrailerSize || !stream->seek(length - kTrailerSize) ||
+        !stream->readU32(&pageCount) || !stream->readU32(&endOfFile) ||
+        endOfFile != kEndOfFile ||
+        pageCount > (length - kHeaderSize - kTrailerSize) / kPageEntrySize ||
+        !stream->seek(length - kTrailerSize - pageCount * kPageEntrySize)) {
         return 0;
     }
-    // leave stream position right here.
     return SkTo<int>(pageCount);
 }
 
+// Reads the page sizes that follow read_header(), and for version 3 the page offsets, checking
+// they fall between the header and the page table.
+static bool read_page_table(SkStreamSeekable* stream, uint32_t version,
+                            SkDocumentPage* dstArray, int pageCount, uint64_t* offsets) {
+    const size_t tableStart = stream->getPosition();
+    for (int i = 0; i < pageCount; ++i) {
+        SkSize& s = dstArray[i].fSize;
+        if (sizeof(s) != stream->read(&s, sizeof(s))) {
+            return false;
+        }
+        if (version == kVersion) {
+            uint64_t offset;
+            if (sizeof(offset) != stream->read(&offset, sizeof(offset)) ||
+                offset < kHeaderSize || offset >= tableStart) {
+                return false;
+            }
+            if (offsets) {
+                offsets[i] = offset;
+            }
+        }
+    }
+    return true;
+}
+}  // namespace
+
+sk_sp<SkDocument> SkMakeMultiPictureDocument(SkWStream* wStream, const SkSerialProcs* procs) {
+    return sk_make_sp<MultiPictureDocument>(wStream, procs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
+    uint32_t version;
+    return read_header(stream, &version);
+}
+
 bool SkMultiPictureDocumentReadPageSizes(SkStreamSeekable* stream,
                                          SkDocumentPage* dstArray,
                                          int dstArrayCount) {
     if (!dstArray || dstArrayCount < 1) {
         return false;
     }
-    int pageCount = SkMultiPictureDocumentReadPageCount(stream);
+    uint32_t version;
+    int pageCount = read_header(stream, &version);
     if (pageCount < 1 || pageCount != dstArrayCount) {
         return false;
     }
-    for (int i = 0; i < pageCount; ++i) {
-        SkSize& s = dstArray[i].fSize;
-        if (sizeof(s) != stream->read(&s, sizeof(s))) {
-            return false;
-        }
-    }
-    // leave stream position right here.
-    return true;
+    return read_page_table(stream, version, dstArray, pageCount, nullptr);
 }
 
 namespace {
@@ -176,13 +243,11 @@ struct PagerCanvas : public SkNWayCanvas {
 };
 }  // namespace
 
-bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
-                                SkDocumentPage* dstArray,
-                                int dstArrayCount,
-                                const SkDeserialProcs* procs) {
-    if (!SkMultiPictureDocumentReadPageSizes(stream, dstArray, dstArrayCount)) {
-        return false;
-    }
+// Reads the pages of a version 2 document, which follow its page sizes.
+static bool read_unindexed(SkStreamSeekable* stream,
+                           SkDocumentPage* dstArray,
+                           int dstArrayCount,
+                           const SkDeserialProcs* procs) {
     SkSize joined = {0.0f, 0.0f};
     for (int i = 0; i < dstArrayCount; ++i) {
         joined = SkSize{std::max(joined.width(), dstArray[i].fSize.width()),
@@ -190,6 +255,9 @@ bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
     }
 
     auto picture = SkPicture::MakeFromStream(stream, procs);
+    if (!picture) {
+        return false;
+    }
 
     PagerCanvas canvas(joined.toCeil(), dstArray, dstArrayCount);
     // Must call playback(), not drawPicture() to reach
@@ -201,3 +269,68 @@ bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
     }
     return true;
 }
+
+bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
+                                SkDocumentPage* dstArray,
+                                int dstArrayCount,
+                                const SkDeserialProcs* procs) {
+    if (!dstArray || dstArrayCount < 1) {
+        return false;
+    }
+    uint32_t version;
+    int pageCount = read_header(stream, &version);
+    if (pageCount < 1 || pageCount != dstArrayCount) {
+        return false;
+    }
+    std::vector<uint64_t> offsets(pageCount);
+    if (!read_page_table(stream, version, dstArray, pageCount, offsets.data())) {
+        return false;
+    }
+    if (version == kUnindexedVersion) {
+        return read_unindexed(stream, dstArray, dstArrayCount, procs);
+    }
+    // Pages are read in order, so procs that share data between pages still work.
+    for (int i = 0; i < pageCount; ++i) {
+        if (!stream->seek(offsets[i]) ||
+            !(dstArray[i].fPicture = SkPicture::MakeFromStream(stream, procs))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkMultiPictureDocumentReadPage(SkStreamSeekable* stream,
+                                    int index,
+                                    SkDocumentPage* dst,
+                                    const SkDeserialProcs* procs) {
+    if (!dst) {
+        return false;
+    }
+    uint32_t version;
+    int pageCount = read_header(stream, &version);
+    if (index < 0 || index >= pageCount) {
+        return false;
+    }
+    if (version == kUnindexedVersion) {
+        // There's no telling where a page starts without reading those before it.
+        std::vector<SkDocumentPage> pages(pageCount);
+        if (!SkMultiPictureDocumentRead(stream, pages.data(), pageCount, procs)) {
+            return false;
+        }
+        *dst = std::move(pages[index]);
+        return dst->fPicture != nullptr;
+    }
+    uint64_t offset;
+    if (!stream->seek(stream->getPosition() + index * kPageEntrySize) ||
+        !read_page_table(stream, version, dst, 1, &offset) ||
+        !stream->seek(offset)) {
+        return false;
+    }
+    dst->fPicture = SkPicture::MakeFromStream(stream, procs);
+    return dst->fPicture != nullptr;
+}
+
+bool SkMultiPictureDocumentIsIndexed(SkStreamSeekable* stream) {
+    uint32_t version;
+    return read_header(stream, &version) > 0 && version == kVersion;
+}
@@ -17,7 +17,8 @@ struct SkSerialProcs;
 class SkStreamSeekable;
 
 /**
- *  Writes into a file format that is similar to SkPicture::serialize()
+ *  Writes into a file format that is similar to SkPicture::serialize(). Each page is written to
+ *  dst as it ends, followed by a table of where the pages start when the document is closed.
  */
 SK_SPI sk_sp<SkDocument> SkMakeMultiPictureDocument(SkWStream* dst, const SkSerialProcs* = nullptr);
 
@@ -41,4 +42,22 @@ SK_SPI bool SkMultiPictureDocumentRead(SkStreamSeekable* src,
                                        int dstArrayCount,
                                        const SkDeserialProcs* = nullptr);
 
+/**
+ *  Read page index of the SkMultiPictureDocument into dst, seeking past the pages before it.
+ *  Procs that share data between pages, like those in tools/SkSharingProc.h, need the earlier
+ *  pages read first; use SkMultiPictureDocumentRead() with them.
+ *  Return false on error.
+ */
+SK_SPI bool SkMultiPictureDocumentReadPage(SkStreamSeekable* src,
+                                           int index,
+                                           SkDocumentPage* dst,
+                                           const SkDeserialProcs* = nullptr);
+
+/**
+ *  Returns true if the SkMultiPictureDocument has a table of where its pages start, so that
+ *  SkMultiPictureDocumentReadPage() reads only the page asked for. Older documents have to be
+ *  read whole for any of their pages; better to read them once with SkMultiPictureDocumentRead().
+ */
+SK_SPI bool SkMultiPictureDocumentIsIndexed(SkStreamSeekable* src);
+
 #endif  // SkMultiPictureDocument_DEFINED
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkPathTriangulator.h"
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/private/SkFloatBits.h"
+#include "include/private/SkTHash.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkRTree.h"
+#include "src/core/SkTLazy.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/gpu/GrEagerVertexAllocator.h"
+#include "src/gpu/GrTriangulator.h"
+
+#include <algorithm>
+
+static constexpr size_t kInitialArenaSize = 16 * 1024;
+
+// The working memory of one triangulation. The arena is carved out of a block that outlives it;
+// when a triangulation spills onto the heap, the block grows by the spill so the next one of
+// similar size allocates nothing.
+struct SkPathTriangulator::Scratch {
+    Scratch() : fBlockSize(kInitialArenaSize), fBlock(new char[kInitialArenaSize]) {
+        fArena.init(fBlock.get(), fBlockSize, kInitialArenaSize);
+    }
+
+    void rewind() {
+        size_t spilled = fArena->heapBytesAllocated();
+        fArena.reset();
+        if (spilled) {
+            fBlockSize += spilled;
+            fBlock.reset(new char[fBlockSize]);
+        }
+        fArena.init(fBlock.get(), fBlockSize, kInitialArenaSize);
+    }
+
+    size_t                     fBlockSize;
+    std::unique_ptr<char[]>    fBlock;
+    SkTLazy<SkArenaAlloc>      fArena;
+    std::vector<SkPoint>       fTriangles;
+    SkTHashMap<uint64_t, int>  fIndexOf;
+};
+
+namespace {
+
+// Receives the triangulator's unindexed output in a vector that keeps its capacity across uses.
+class TriangleAllocator final : public GrEagerVertexAllocator {
+public:
+    explicit TriangleAllocator(std::vector<SkPoint>* triangles) : fTriangles(triangles) {}
+
+    void* lock(size_t stride, int eagerCount) override {
+        SkASSERT(stride == sizeof(SkPoint));
+        fTriangles->resize(eagerCount);
+        return fTriangles->data();
+    }
+
+    void unlock(int actualCount) override { fTriangles->resize(actualCount); }
+
+private:
+    std::vector<SkPoint>* fTriangles;
+};
+
+}  // namespace
+
+SkPathTriangulator::SkPathTriangulator(SkExecutor* executor) : fExecutor(executor) {}
+
+SkPathTriangulator::~SkPathTriangulator() = default;
+
+std::unique_ptr<SkPathTriangulator::Scratch> SkPathTriangulator::acquireScratch() {
+    SkAutoMutexExclusive lock(fScratchMutex);
+    if (fFreeScratch.empty()) {
+        return std::make_unique<Scratch>();
+    }
+    std::unique_ptr<Scratch> scratch = std::move(fFreeScratch.back());
+    fFreeScratch.pop_back();
+    return scratch;
+}
+
+void SkPathTriangulator::releaseScratch(std::unique_ptr<Scratch> scratch) {
+    SkAutoMutexExclusive lock(fScratchMutex);
+    fFreeScratch.push_back(std::move(scratch));
+}
+
+// Triangulates path as a whole into mesh, merging bit-identical vertices into one index.
+void SkPathTriangulator::triangulateContours(const SkPath& path, const SkRect& clipBounds,
+                                             SkScalar tolerance, Mesh* mesh) {
+    std::unique_ptr<Scratch> scratch = this->acquireScratch();
+    TriangleAllocator allocator(&scratch->fTriangles);
+    int numCountedCurves;
+    int count = GrTriangulator::PathToTriangles(path, tolerance, clipBounds, &allocator,
+                                                GrTriangulator::Mode::kNormal, &numCountedCurves,
+                                                scratch->fArena.get());
+    scratch->rewind();
+
+    mesh->fVertices.clear();
+    mesh->fIndices.clear();
+    mesh->fIndices.reserve(count);
+    scratch->fIndexOf.reset();
+    for (int i = 0; i < count; ++i) {
+        const SkPoint& p = scratch->fTriangles[i];
+        uint64_t key = (uint64_t)SkFloat2Bits(p.fX) << 32 | (uint32_t)SkFloat2Bits(p.fY);
+        int* index = scratch->fIndexOf.find(key);
+        if (!index) {
+            index = scratch->fIndexOf.set(key, SkToInt(mesh->fVertices.size()));
+            mesh->fVertices.push_back(p);
+        }
+        mesh->fIndices.push_back(*index);
+    }
+    this->releaseScratch(std::move(scratch));
+}
+
+bool SkPathTriangulator::triangulate(const SkPath& path, Mesh* mesh, SkScalar tolerance) {
+    return this->triangulate(path, path.getBounds(), mesh, tolerance);
+}
+
+bool SkPathTriangulator::triangulate(const SkPath& path, const SkRect& clipBounds, Mesh* mesh,
+                                     SkScalar tolerance) {
+    mesh->fVertices.clear();
+    mesh->fIndices.clear();
+    if (!path.isFinite() || !SkScalarIsFinite(tolerance) || tolerance <= 0) {
+        return false;
+    }
+    if (!fExecutor || path.isInverseFillType()) {
+        // Inverse fills cover the area between every contour and the clip, so they cannot be
+        // split up.
+        this->triangulateContours(path, clipBounds, tolerance, mesh);
+        return true;
+    }
+
+    // Split the path into contours.
+    std::vector<SkPath> contours;
+    for (auto [verb, pts, weight] : SkPathPriv::Iterate(path)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                contours.emplace_back().moveTo(pts[0]);
+                break;
+            case SkPathVerb::kLine:
+                contours.back().lineTo(pts[1]);
+                break;
+            case SkPathVerb::kQuad:
+                contours.back().quadTo(pts[1], pts[2]);
+                break;
+            case SkPathVerb::kConic:
+                contours.back().conicTo(pts[1], pts[2], *weight);
+                break;
+            case SkPathVerb::kCubic:
+                contours.back().cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPathVerb::kClose:
+                contours.back().close();
+                break;
+        }
+    }
+
+    // A contour only changes the winding inside its own bounds, so contours whose bounds are
+    // disjoint from every other contour's, transitively, can be triangulated on their own and
+    // produce triangles that cannot overlap the others'.
+    int contourCount = SkToInt(contours.size());
+    std::vector<SkRect> bounds(contourCount);
+    std::vector<int> parents(contourCount);
+    for (int i = 0; i < contourCount; ++i) {
+        bounds[i] = contours[i].getBounds();
+        parents[i] = i;
+    }
+    auto findRoot = [&parents](int i) {
+        while (parents[i] != i) {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
+    };
+    SkRTree rtree;
+    rtree.insert(bounds.data(), contourCount);
+    std::vector<int> hits;
+    for (int i = 0; i < contourCount; ++i) {
+        hits.clear();
+        rtree.search(bounds[i], &hits);
+        int root = findRoot(i);
+        for (int hit : hits) {
+            int hitRoot = findRoot(hit);
+            if (hitRoot != root) {
+                parents[std::max(root, hitRoot)] = std::min(root, hitRoot);
+                root = std::min(root, hitRoot);
+            }
+        }
+    }
+
+    // Gather each group's contours into one path, in order of the group's first contour.
+    std::vector<int> groupOf(contourCount, -1);
+    std::vector<SkPath> groups;
+    for (int i = 0; i < contourCount; ++i) {
+        int root = findRoot(i);
+        if (groupOf[root] < 0) {
+            groupOf[root] = SkToInt(groups.size());
+            groups.emplace_back().setFillType(path.getFillType());
+        }
+        groups[groupOf[root]].addPath(contours[i]);
+    }
+    int groupCount = SkToInt(groups.size());
+    if (groupCount <= 1) {
+        this->triangulateContours(path, clipBounds, tolerance, mesh);
+        return true;
+    }
+
+    std::vector<Mesh> groupMeshes(groupCount);
+    SkTaskGroup(*fExecutor).batch(groupCount, [&](int i) {
+        this->triangulateContours(groups[i], clipBounds, tolerance, &groupMeshes[i]);
+    });
+
+    size_t vertexCount = 0, indexCount = 0;
+    for (const Mesh& groupMesh : groupMeshes) {
+        vertexCount += groupMesh.fVertices.size();
+        indexCount += groupMesh.fIndices.size();
+    }
+    mesh->fVertices.reserve(vertexCount);
+    mesh->fIndices.reserve(indexCount);
+    for (const Mesh& groupMesh : groupMeshes) {
+        uint32_t base = SkToU32(mesh->fVertices.size());
+        mesh->fVertices.insert(mesh->fVertices.end(), groupMesh.fVertices.begin(),
+                               groupMesh.fVertices.end());
+        for (uint32_t index : groupMesh.fIndices) {
+            mesh->fIndices.push_back(base + index);
+        }
+    }
+    return true;
+}
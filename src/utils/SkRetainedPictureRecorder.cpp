@@ -0,0 +1,250 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkRetainedPictureRecorder.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/private/SkTHash.h"
+
+#include <algorithm>
+#include <vector>
+
+class SkRetainedPictureRecorder::Impl {
+public:
+    SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory) {
+        SkASSERT(!fCanvas);
+        fFactory = bbhFactory;
+        fStats = Stats();
+        fCanvas = fFrame.beginRecording(bounds, bbhFactory);
+        return fCanvas;
+    }
+
+    bool drawGroup(uint64_t key) {
+        SkASSERT(fCanvas);
+        Group* group = fGroups.find(key);
+        if (!group || !group->fPicture) {
+            return false;
+        }
+        this->addContainer(group);
+        group->fUsed = true;
+        fStats.fGroupsReused++;
+        this->canvas()->drawPicture(group->fPicture);
+        return true;
+    }
+
+    SkCanvas* beginGroup(uint64_t key, const SkRect& bounds) {
+        SkASSERT(fCanvas);
+        Group* group = fGroups.find(key);
+        if (!group) {
+            group = fGroups.set(key, Group());
+        }
+        this->addContainer(group);
+        group->fPicture = nullptr;
+        group->fGeneration++;
+        group->fUsed = true;
+
+        fOpen.push_back({key, std::make_unique<SkPictureRecorder>()});
+        return fOpen.back().fRecorder->beginRecording(bounds, fFactory);
+    }
+
+    void endGroup() {
+        SkASSERT(!fOpen.empty());
+        OpenGroup open = std::move(fOpen.back());
+        fOpen.pop_back();
+
+        sk_sp<SkPicture> picture = open.fRecorder->finishRecordingAsPicture();
+        fStats.fGroupsRecorded++;
+        this->canvas()->drawPicture(picture);
+
+        // Invalidated while it was being recorded, the group can only be used this frame.
+        Group* group = fGroups.find(open.fKey);
+        if (group && !open.fInvalidated) {
+            group->fPicture = std::move(picture);
+        }
+    }
+
+    void invalidate(uint64_t key) {
+        // Invalidates the group and everything it's drawn in, however many containers that is.
+        // Visiting each key once also keeps us from going around a loop of containers.
+        SkTHashSet<uint64_t> visited;
+        std::vector<uint64_t> pending = {key};
+        while (!pending.empty()) {
+            key = pending.back();
+            pending.pop_back();
+            Group* group = fGroups.find(key);
+            if (!group || visited.contains(key)) {
+                continue;
+            }
+            visited.add(key);
+
+            // A group being recorded now can't be kept, nor can any being recorded around it.
+            for (size_t i = fOpen.size(); i --> 0;) {
+                if (fOpen[i].fKey == key) {
+                    for (size_t j = 0; j <= i; j++) {
+                        fOpen[j].fInvalidated = true;
+                    }
+                    break;
+                }
+            }
+            group->fPicture = nullptr;
+            for (const Container& container : group->fContainers) {
+                if (this->isLive(container)) {
+                    pending.push_back(container.fKey);
+                }
+            }
+        }
+    }
+
+    void invalidateAll() {
+        fGroups.foreach([](uint64_t, Group* group) { group->fPicture = nullptr; });
+        for (OpenGroup& open : fOpen) {
+            open.fInvalidated = true;
+        }
+    }
+
+    sk_sp<SkPicture> finishRecordingAsPicture() {
+        SkASSERT(fCanvas);
+        while (!fOpen.empty()) {
+            this->endGroup();
+        }
+
+        // Groups not drawn this frame, directly or inside another, may never be again.
+        SkTHashMap<uint64_t, bool> drawn;
+        std::vector<uint64_t> unused;
+        fGroups.foreach([&](uint64_t key, Group*) {
+            if (!this->wasDrawn(key, &drawn)) {
+                unused.push_back(key);
+            }
+        });
+        fGroups.foreach([](uint64_t, Group* group) { group->fUsed = false; });
+        for (uint64_t key : unused) {
+            fGroups.remove(key);
+        }
+        fStats.fGroupsRetained = 0;
+        fGroups.foreach([&](uint64_t, Group* group) {
+            fStats.fGroupsRetained += group->fPicture ? 1 : 0;
+        });
+
+        fCanvas = nullptr;
+        fFactory = nullptr;
+        return fFrame.finishRecordingAsPicture();
+    }
+
+    Stats stats() const { return fStats; }
+
+private:
+    // A group that another was drawn inside, and which recording of it that was.
+    struct Container {
+        uint64_t fKey;
+        uint32_t fGeneration;
+    };
+
+    struct Group {
+        sk_sp<SkPicture>       fPicture;          // Null when it needs recording.
+        uint32_t               fGeneration = 0;   // Counts recordings of this group.
+        std::vector<Container> fContainers;       // Drawn inside; some may have gone stale.
+        bool                   fUsed = false;     // Drawn directly in the frame being recorded.
+    };
+
+    struct OpenGroup {
+        uint64_t                           fKey;
+        std::unique_ptr<SkPictureRecorder> fRecorder;
+        bool                               fInvalidated = false;
+    };
+
+    SkCanvas* canvas() {
+        return fOpen.empty() ? fCanvas : fOpen.back().fRecorder->getRecordingCanvas();
+    }
+
+    // Notes that group is being drawn into the innermost group being recorded, if any, and
+    // forgets containers that have since been recorded again, and so no longer hold it.
+    void addContainer(Group* group) {
+        std::vector<Container>& containers = group->fContainers;
+        containers.erase(std::remove_if(containers.begin(), containers.end(),
+                                        [&](const Container& c) { return !this->isLive(c); }),
+                         containers.end());
+        if (!fOpen.empty()) {
+            const uint64_t key = fOpen.back().fKey;
+            const Container open = {key, fGroups.find(key)->fGeneration};
+            if (std::none_of(containers.begin(), containers.end(), [&](const Container& c) {
+                    return c.fKey == open.fKey && c.fGeneration == open.fGeneration;
+                })) {
+                containers.push_back(open);
+            }
+        }
+    }
+
+    // Is this still the recording of the container that the group was drawn inside?
+    bool isLive(const Container& container) {
+        const Group* group = fGroups.find(container.fKey);
+        return group && group->fGeneration == container.fGeneration;
+    }
+
+    // Was the group for key drawn this frame, directly or inside any of its containers? Memoizes
+    // in drawn, which also stops us going around a loop of containers.
+    bool wasDrawn(uint64_t key, SkTHashMap<uint64_t, bool>* drawn) {
+        if (const bool* known = drawn->find(key)) {
+            return *known;
+        }
+        const Group* group = fGroups.find(key);
+        drawn->set(key, group && group->fUsed);
+        if (group && !group->fUsed) {
+            for (const Container& container : group->fContainers) {
+                if (this->isLive(container) && this->wasDrawn(container.fKey, drawn)) {
+                    drawn->set(key, true);
+                    break;
+                }
+            }
+        }
+        return *drawn->find(key);
+    }
+
+    SkPictureRecorder             fFrame;
+    SkCanvas*                     fCanvas = nullptr;
+    SkBBHFactory*                 fFactory = nullptr;
+    std::vector<OpenGroup>        fOpen;
+    SkTHashMap<uint64_t, Group>   fGroups;
+    Stats                         fStats;
+};
+
+SkRetainedPictureRecorder::SkRetainedPictureRecorder() : fImpl(std::make_unique<Impl>()) {}
+
+SkRetainedPictureRecorder::~SkRetainedPictureRecorder() = default;
+
+SkCanvas* SkRetainedPictureRecorder::beginRecording(const SkRect& bounds,
+                                                    SkBBHFactory* bbhFactory) {
+    return fImpl->beginRecording(bounds, bbhFactory);
+}
+
+bool SkRetainedPictureRecorder::drawGroup(uint64_t key) {
+    return fImpl->drawGroup(key);
+}
+
+SkCanvas* SkRetainedPictureRecorder::beginGroup(uint64_t key, const SkRect& bounds) {
+    return fImpl->beginGroup(key, bounds);
+}
+
+void SkRetainedPictureRecorder::endGroup() {
+    fImpl->endGroup();
+}
+
+void SkRetainedPictureRecorder::invalidate(uint64_t key) {
+    fImpl->invalidate(key);
+}
+
+void SkRetainedPictureRecorder::invalidateAll() {
+    fImpl->invalidateAll();
+}
+
+sk_sp<SkPicture> SkRetainedPictureRecorder::finishRecordingAsPicture() {
+    return fImpl->finishRecordingAsPicture();
+}
+
+SkRetainedPictureRecorder::Stats SkRetainedPictureRecorder::stats() const {
+    return fImpl->stats();
+}
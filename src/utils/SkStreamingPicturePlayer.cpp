@@ -0,0 +1,603 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkStreamingPicturePlayer.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
+#include "include/core/SkVertices.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkPictureCommon.h"
+#include "src/core/SkPictureData.h"
+#include "src/core/SkPicturePlayback.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkTInternalLList.h"
+#include "src/core/SkTextBlobPriv.h"
+#include "src/core/SkVerticesPriv.h"
+
+#include <algorithm>
+#include <vector>
+
+/*
+  A picture's stream holds, after its header, tagged sections in this order:
+
+      SK_PICT_READER_TAG       the ops
+      SK_PICT_FACTORY_TAG      names of the flattenables' factories
+      SK_PICT_TYPEFACE_TAG     typefaces
+      SK_PICT_BUFFER_SIZE_TAG  paints, paths, text blobs, vertices and images, by type
+      SK_PICT_PICTURE_TAG      nested pictures, after an index of their sizes
+      SK_PICT_EOF_TAG
+
+  The factories and typefaces are read as they are. The other sections are only skimmed, to note
+  where each op window and resource can be read from later.
+*/
+
+namespace {
+
+enum Kind : uint8_t {
+    kPaint,
+    kPath,
+    kTextBlob,
+    kVertices,
+    kImage,
+    kPicture,
+
+    kKindCount
+};
+
+struct Resource {
+    size_t fOffset = 0;  // where it's serialized in the stream
+    size_t fSize = 0;
+    size_t fBytes = 0;   // what it's charged against the budget while loaded
+    Kind   fKind = kPaint;
+    int    fIndex = 0;
+    bool   fLoaded = false;
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Resource);
+};
+
+}  // namespace
+
+class SkStreamingPicturePlayer::Impl final : public SkPicturePlayback::Resources {
+public:
+    // Buffer section items are skimmed through a window of at least this much of the stream.
+    static constexpr size_t kMinSkimWindow = 64 << 10;
+
+    Impl(std::unique_ptr<SkStreamAsset> stream, const Options& options, const SkPictInfo& info)
+        : fStream(std::move(stream))
+        , fOptions(options)
+        , fInfo(info) {}
+
+    ~Impl() override {
+        while (Resource* resource = fLRU.head()) {
+            fLRU.remove(resource);
+        }
+    }
+
+    SkRect cullRect() const { return fInfo.fCullRect; }
+    Stats stats() const { return fStats; }
+
+    // Reads the sections that follow the header.
+    bool skim() {
+        for (;;) {
+            uint32_t tag, size;
+            if (!fStream->readU32(&tag)) {
+                return false;
+            }
+            if (tag == SK_PICT_EOF_TAG) {
+                break;
+            }
+            if (!fStream->readU32(&size)) {
+                return false;
+            }
+            switch (tag) {
+                case SK_PICT_READER_TAG:
+                    fOpOffset = fStream->getPosition();
+                    fOpSize = size;
+                    if (!this->skip(size)) {
+                        return false;
+                    }
+                    break;
+                case SK_PICT_FACTORY_TAG:
+                    if (!this->readFactories()) {
+                        return false;
+                    }
+                    break;
+                case SK_PICT_TYPEFACE_TAG:
+                    if (!this->readTypefaces(size)) {
+                        return false;
+                    }
+                    break;
+                case SK_PICT_BUFFER_SIZE_TAG: {
+                    const size_t offset = fStream->getPosition();
+                    if (!this->skip(size) || !this->skimBuffer(offset, size)) {
+                        return false;
+                    }
+                    if (!fStream->seek(offset + size)) {
+                        return false;
+                    }
+                } break;
+                case SK_PICT_PICTURE_TAG:
+                    if (!this->skimPictures(size)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+        fPaints.resize(fResources[kPaint].size());
+        fPaths.resize(fResources[kPath].size());
+        fTextBlobs.resize(fResources[kTextBlob].size());
+        fVertices.resize(fResources[kVertices].size());
+        fImages.resize(fResources[kImage].size());
+        fPictures.resize(fResources[kPicture].size());
+        return fFactoryPlayback && fOpOffset;
+    }
+
+    bool playback(SkCanvas* canvas) {
+        SkPicturePlayback playback(this);
+        const SkMatrix initialMatrix = canvas->getTotalMatrix();
+        SkAutoCanvasRestore acr(canvas, false);
+
+        fFailed = false;
+        // Ops are 4-byte aligned, so windows are too.
+        const size_t minWindow = SkAlign4(std::max<size_t>(fOptions.fOpWindowBytes, 16));
+        size_t offset = 0,
+               window = minWindow;
+        while (offset < fOpSize) {
+            const size_t size = std::min(fOpSize - offset, window);
+            sk_sp<SkData> ops = this->read(fOpOffset + offset, size);
+            if (!ops) {
+                return false;
+            }
+            fWindowBytes = size;
+            fStats.fWindowsRead++;
+            this->notePeak();
+
+            // Sharing the window lets annotations' data share it too.
+            SkReadBuffer reader(std::move(ops));
+            const size_t next = playback.drawPiece(canvas, &reader, offset, fOpSize,
+                                                   initialMatrix);
+            fWindowBytes = 0;
+            if (!reader.isValid() || fFailed) {
+                return false;
+            }
+            if (next == offset) {
+                // The first op didn't fit. Try again with room for it.
+                window = 2 * size;
+            } else {
+                window = minWindow;
+                offset = next;
+            }
+        }
+        return true;
+    }
+
+    const SkPaint* optionalPaint(SkReadBuffer* reader) override {
+        const int index = reader->readInt();
+        if (index == 0) {
+            return nullptr;  // recorder wrote a zero for no paint
+        }
+        const Resource* resource = this->find(reader, kPaint, index - 1);
+        return resource ? fPaints[resource->fIndex].get() : nullptr;
+    }
+
+    const SkPath& getPath(SkReadBuffer* reader) override {
+        const Resource* resource = this->find(reader, kPath, reader->readInt() - 1);
+        return resource ? fPaths[resource->fIndex] : fEmptyPath;
+    }
+
+    const SkImage* getImage(SkReadBuffer* reader) override {
+        // images are written base-0, unlike everything else
+        const Resource* resource = this->find(reader, kImage, reader->readInt());
+        return resource ? fImages[resource->fIndex].get() : nullptr;
+    }
+
+    const SkPicture* getPicture(SkReadBuffer* reader) override {
+        const Resource* resource = this->find(reader, kPicture, reader->readInt() - 1);
+        return resource ? fPictures[resource->fIndex].get() : nullptr;
+    }
+
+    SkDrawable* getDrawable(SkReadBuffer* reader) override {
+        // Drawables are drawn into pictures as they're serialized, so there are none to find.
+        reader->readInt();
+        reader->validate(false);
+        return nullptr;
+    }
+
+    const SkTextBlob* getTextBlob(SkReadBuffer* reader) override {
+        const Resource* resource = this->find(reader, kTextBlob, reader->readInt() - 1);
+        return resource ? fTextBlobs[resource->fIndex].get() : nullptr;
+    }
+
+    const SkVertices* getVertices(SkReadBuffer* reader) override {
+        const Resource* resource = this->find(reader, kVertices, reader->readInt() - 1);
+        return resource ? fVertices[resource->fIndex].get() : nullptr;
+    }
+
+    void endOp() override {
+        const size_t budget = fOptions.fMemoryBudget - std::min(fOptions.fMemoryBudget,
+                                                                fWindowBytes);
+        while (fLoadedBytes > budget) {
+            this->unload(fLRU.tail());
+            fStats.fResourcesEvicted++;
+        }
+    }
+
+private:
+    sk_sp<SkData> read(size_t offset, size_t size) {
+        return fStream->seek(offset) ? SkData::MakeFromStream(fStream.get(), size) : nullptr;
+    }
+
+    size_t remaining() const {
+        return fStream->getLength() - fStream->getPosition();
+    }
+
+    bool skip(size_t size) {
+        return size <= this->remaining() && fStream->seek(fStream->getPosition() + size);
+    }
+
+    void setupBuffer(SkReadBuffer* buffer) const {
+        buffer->setVersion(fInfo.getVersion());
+        fFactoryPlayback->setupBuffer(*buffer);
+        fTFPlayback.setupBuffer(*buffer);
+        buffer->setDeserialProcs(fOptions.fProcs);
+    }
+
+    bool readFactories() {
+        uint32_t count;
+        if (fFactoryPlayback || !fStream->readU32(&count) || count > this->remaining()) {
+            return false;
+        }
+        fFactoryPlayback = std::make_unique<SkFactoryPlayback>(SkToInt(count));
+        for (uint32_t i = 0; i < count; i++) {
+            SkString str;
+            size_t len;
+            if (!fStream->readPackedUInt(&len)) {
+                return false;
+            }
+            str.resize(len);
+            if (fStream->read(str.writable_str(), len) != len) {
+                return false;
+            }
+            fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+        }
+        return true;
+    }
+
+    bool readTypefaces(uint32_t count) {
+        if (fTFPlayback.count() > 0 || count > this->remaining()) {
+            return false;
+        }
+        fTFPlayback.setCount(count);
+        for (uint32_t i = 0; i < count; i++) {
+            sk_sp<SkTypeface> tf;
+            if (fOptions.fProcs.fTypefaceProc) {
+                SkStream* stream = fStream.get();
+                tf = fOptions.fProcs.fTypefaceProc(&stream, sizeof(stream),
+                                                   fOptions.fProcs.fTypefaceCtx);
+            } else {
+                tf = SkTypeface::MakeDeserialize(fStream.get());
+            }
+            fTFPlayback[i] = tf ? std::move(tf) : SkTypeface::MakeDefault();
+        }
+        return true;
+    }
+
+    void addResource(Kind kind, size_t offset, size_t size) {
+        Resource resource;
+        resource.fOffset = offset;
+        resource.fSize = size;
+        resource.fKind = kind;
+        resource.fIndex = SkToInt(fResources[kind].size());
+        fResources[kind].push_back(resource);
+    }
+
+    // Notes where each item in the buffer section lies, parsing them one at a time through a
+    // window of the stream that grows whenever an item runs off its end.
+    bool skimBuffer(size_t offset, size_t size) {
+        if (!fFactoryPlayback) {
+            return false;
+        }
+        sk_sp<SkData> window;
+        size_t windowStart = 0,
+               cursor = 0;
+        // Parses the item at cursor with parse(SkReadBuffer&), then steps cursor past it.
+        auto next = [&](auto&& parse) {
+            size_t available = window ? windowStart + window->size() - cursor : 0;
+            for (;;) {
+                if (available > 0) {
+                    SkReadBuffer buffer(SkData::MakeSubset(window.get(), cursor - windowStart,
+                                                           available));
+                    this->setupBuffer(&buffer);
+                    parse(buffer);
+                    if (buffer.isValid()) {
+                        cursor += buffer.offset();
+                        return true;
+                    }
+                }
+                if (cursor + available >= size) {
+                    return false;
+                }
+                available = std::min(size - cursor, std::max(kMinSkimWindow, 2 * available));
+                if (!(window = this->read(offset + cursor, available))) {
+                    return false;
+                }
+                windowStart = cursor;
+            }
+        };
+        // Parses count items, noting each as a resource of kind.
+        auto items = [&](Kind kind, int count, auto&& parse) {
+            if (!fResources[kind].empty()) {
+                return false;
+            }
+            fResources[kind].reserve(count);
+            for (int i = 0; i < count; i++) {
+                const size_t start = cursor;
+                if (!next(parse)) {
+                    return false;
+                }
+                this->addResource(kind, offset + start, cursor - start);
+            }
+            return true;
+        };
+
+        while (cursor < size) {
+            uint32_t tag = 0, count = 0;
+            if (!next([&](SkReadBuffer& buffer) {
+                    tag = buffer.readUInt();
+                    count = buffer.readUInt();
+                }) || count > size - cursor) {
+                return false;
+            }
+            bool ok = false;
+            switch (tag) {
+                case SK_PICT_PAINT_BUFFER_TAG:
+                    ok = items(kPaint, SkToInt(count), [](SkReadBuffer& buffer) {
+                        SkPaint paint;
+                        buffer.readPaint(&paint, nullptr);
+                    });
+                    break;
+                case SK_PICT_PATH_BUFFER_TAG: {
+                    int paths = 0;
+                    ok = count == 0 || next([&](SkReadBuffer& buffer) {
+                        paths = buffer.readInt();
+                        buffer.validate(paths >= 0 && (size_t)paths <= size - cursor);
+                    });
+                    ok = ok && items(kPath, paths, [](SkReadBuffer& buffer) {
+                        SkPath path;
+                        buffer.readPath(&path);
+                    });
+                } break;
+                case SK_PICT_TEXTBLOB_BUFFER_TAG:
+                    ok = items(kTextBlob, SkToInt(count), [](SkReadBuffer& buffer) {
+                        buffer.validate(SkTextBlobPriv::MakeFromBuffer(buffer) != nullptr);
+                    });
+                    break;
+                case SK_PICT_VERTICES_BUFFER_TAG:
+                    ok = items(kVertices, SkToInt(count), [](SkReadBuffer& buffer) {
+                        buffer.validate(SkVerticesPriv::Decode(buffer) != nullptr);
+                    });
+                    break;
+                case SK_PICT_IMAGE_BUFFER_TAG:
+                    // Only the encoded bytes are read, and they share the window.
+                    ok = items(kImage, SkToInt(count), [](SkReadBuffer& buffer) {
+                        SkReadBuffer::EncodedImage encoded;
+                        buffer.readEncodedImage(&encoded);
+                    });
+                    break;
+            }
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool skimPictures(uint32_t count) {
+        if (!fResources[kPicture].empty() || count > this->remaining() / (2 * sizeof(uint32_t))) {
+            return false;
+        }
+        std::vector<uint32_t> sizes(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t opCount;
+            if (!fStream->readU32(&sizes[i]) || !fStream->readU32(&opCount)) {
+                return false;
+            }
+        }
+        fResources[kPicture].reserve(count);
+        for (uint32_t size : sizes) {
+            this->addResource(kPicture, fStream->getPosition(), size);
+            if (!this->skip(size)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reads the resource of kind at index, loading it if need be. Returns nullptr, leaving the
+    // reader invalid, if there's no such resource or it can't be loaded.
+    Resource* find(SkReadBuffer* reader, Kind kind, int index) {
+        std::vector<Resource>& resources = fResources[kind];
+        if (!reader->validateIndex(index, SkToInt(resources.size()))) {
+            return nullptr;
+        }
+        Resource* resource = &resources[index];
+        if (resource->fLoaded) {
+            if (resource != fLRU.head()) {
+                fLRU.remove(resource);
+                fLRU.addToHead(resource);
+            }
+        } else if (!this->load(resource)) {
+            fFailed = true;
+            reader->validate(false);
+            return nullptr;
+        }
+        return resource;
+    }
+
+    bool load(Resource* resource) {
+        sk_sp<SkData> data = this->read(resource->fOffset, resource->fSize);
+        if (!data) {
+            return false;
+        }
+        const int i = resource->fIndex;
+        size_t bytes = resource->fSize;
+        if (resource->fKind == kPicture) {
+            // Nested pictures carry their own factories and typefaces.
+            fPictures[i] = SkPicture::MakeFromData(data.get(), &fOptions.fProcs);
+            if (!fPictures[i]) {
+                return false;
+            }
+            bytes = fPictures[i]->approximateBytesUsed();
+        } else {
+            SkReadBuffer buffer(std::move(data));
+            this->setupBuffer(&buffer);
+            bool ok = false;
+            switch (resource->fKind) {
+                case kPaint:
+                    fPaints[i] = std::make_unique<SkPaint>();
+                    ok = buffer.readPaint(fPaints[i].get(), nullptr);
+                    bytes += sizeof(SkPaint);
+                    break;
+                case kPath:
+                    buffer.readPath(&fPaths[i]);
+                    ok = true;
+                    bytes = fPaths[i].approximateBytesUsed();
+                    break;
+                case kTextBlob:
+                    ok = (fTextBlobs[i] = SkTextBlobPriv::MakeFromBuffer(buffer)) != nullptr;
+                    break;
+                case kVertices:
+                    ok = (fVertices[i] = SkVerticesPriv::Decode(buffer)) != nullptr;
+                    bytes = ok ? fVertices[i]->approximateSize() : 0;
+                    break;
+                case kImage:
+                    ok = (fImages[i] = buffer.readImage()) != nullptr;
+                    // Encoded images keep their data, which is all decoded images cache too.
+                    if (ok && !fImages[i]->isLazyGenerated()) {
+                        bytes = std::max(bytes, fImages[i]->imageInfo().computeMinByteSize());
+                    }
+                    break;
+                default:
+                    break;
+            }
+            if (!buffer.isValid() || !ok) {
+                this->release(resource);
+                return false;
+            }
+        }
+        resource->fLoaded = true;
+        resource->fBytes = bytes;
+        fLRU.addToHead(resource);
+        fLoadedBytes += bytes;
+        fStats.fResourcesLoaded++;
+        this->notePeak();
+        return true;
+    }
+
+    void unload(Resource* resource) {
+        SkASSERT(resource->fLoaded);
+        fLRU.remove(resource);
+        fLoadedBytes -= resource->fBytes;
+        resource->fLoaded = false;
+        resource->fBytes = 0;
+        this->release(resource);
+    }
+
+    void release(const Resource* resource) {
+        const int i = resource->fIndex;
+        switch (resource->fKind) {
+            case kPaint:    fPaints[i] = nullptr;    break;
+            case kPath:     fPaths[i] = SkPath();     break;
+            case kTextBlob: fTextBlobs[i] = nullptr; break;
+            case kVertices: fVertices[i] = nullptr;  break;
+            case kImage:    fImages[i] = nullptr;    break;
+            case kPicture:  fPictures[i] = nullptr;  break;
+            default: break;
+        }
+    }
+
+    void notePeak() {
+        fStats.fPeakBytes = std::max(fStats.fPeakBytes, fLoadedBytes + fWindowBytes);
+    }
+
+    std::unique_ptr<SkStreamAsset> fStream;
+    const Options                  fOptions;
+    const SkPictInfo               fInfo;
+
+    size_t fOpOffset = 0,  // where the ops are in the stream
+           fOpSize = 0;
+
+    std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
+    SkTypefacePlayback                 fTFPlayback;
+
+    std::vector<Resource> fResources[kKindCount];
+
+    // Loaded resources, indexed like fResources.
+    std::vector<std::unique_ptr<SkPaint>> fPaints;
+    std::vector<SkPath>                   fPaths;
+    std::vector<sk_sp<SkTextBlob>>        fTextBlobs;
+    std::vector<sk_sp<SkVertices>>        fVertices;
+    std::vector<sk_sp<SkImage>>           fImages;
+    std::vector<sk_sp<SkPicture>>         fPictures;
+    const SkPath                          fEmptyPath;
+
+    SkTInternalLList<Resource> fLRU;  // loaded resources, the most recently used at the head
+    size_t fLoadedBytes = 0,
+           fWindowBytes = 0;
+    bool   fFailed = false;
+    Stats  fStats;
+};
+
+std::unique_ptr<SkStreamingPicturePlayer> SkStreamingPicturePlayer::Make(
+        std::unique_ptr<SkStreamAsset> stream, const Options& options) {
+    SkPictInfo info;
+    if (!SkPicture_StreamIsSKP(stream.get(), &info) ||
+        info.getVersion() < SkPicturePriv::kIndexedSubPictures_Version) {
+        return nullptr;
+    }
+    // The byte after the header is 1 when picture data follows it. Pictures serialized by custom
+    // procs, or that failed to serialize, have no ops to stream.
+    uint8_t trailingByte;
+    if (!stream->readU8(&trailingByte) || trailingByte != 1) {
+        return nullptr;
+    }
+
+    auto impl = std::make_unique<Impl>(std::move(stream), options, info);
+    if (!impl->skim()) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkStreamingPicturePlayer>(new SkStreamingPicturePlayer(std::move(impl)));
+}
+
+std::unique_ptr<SkStreamingPicturePlayer> SkStreamingPicturePlayer::Make(
+        std::unique_ptr<SkStreamAsset> stream) {
+    return Make(std::move(stream), Options());
+}
+
+SkStreamingPicturePlayer::SkStreamingPicturePlayer(std::unique_ptr<Impl> impl)
+    : fImpl(std::move(impl)) {}
+
+SkStreamingPicturePlayer::~SkStreamingPicturePlayer() = default;
+
+SkRect SkStreamingPicturePlayer::cullRect() const { return fImpl->cullRect(); }
+
+bool SkStreamingPicturePlayer::playback(SkCanvas* canvas) { return fImpl->playback(canvas); }
+
+SkStreamingPicturePlayer::Stats SkStreamingPicturePlayer::stats() const {
+    return fImpl->stats();
+}
@@ -36,6 +36,7 @@
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
 #include "src/effects/SkEmbossMaskFilter.h"
@@ -663,3 +664,46 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+// Makes an A8 mask of the given size holding a disc of radius 70 centered at (cx, cy).
+static SkMask make_disc_mask(int width, int height, int cx, int cy) {
+    SkMask mask;
+    mask.fBounds.setWH(width, height);
+    mask.fRowBytes = width;
+    mask.fFormat = SkMask::kA8_Format;
+    mask.fImage = SkMask::AllocImage(mask.computeImageSize(), SkMask::kZeroInit_Alloc);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int dx = x - cx, dy = y - cy;
+            mask.fImage[y * width + x] = dx * dx + dy * dy <= 70 * 70 ? 0xFF : 0;
+        }
+    }
+    return mask;
+}
+
+// Big masks are blurred in strips, so blurring a shape in the middle of a big mask must give the
+// same pixels as blurring it in a mask of its own, which is too small to be split up.
+DEF_TEST(BlurMaskStrips, reporter) {
+    SkMask small = make_disc_mask(160, 160, 80, 80),
+           big   = make_disc_mask(700, 600, 380, 280);
+    SkAutoMaskFreeImage freeSmall(small.fImage), freeBig(big.fImage);
+
+    for (double sigma : {1.5, 5.0, 20.0}) {
+        SkMaskBlurFilter blur(sigma, sigma);
+        SkMask smallDst, bigDst;
+        SkIPoint smallBorder = blur.blur(small, &smallDst),
+                 bigBorder   = blur.blur(big,   &bigDst);
+        SkAutoMaskFreeImage freeSmallDst(smallDst.fImage), freeBigDst(bigDst.fImage);
+        REPORTER_ASSERT(reporter, smallBorder == bigBorder);
+
+        int mismatches = 0;
+        for (int y = 0; y < smallDst.fBounds.height(); ++y) {
+            for (int x = 0; x < smallDst.fBounds.width(); ++x) {
+                uint8_t expected = smallDst.fImage[y * smallDst.fRowBytes + x],
+                        actual   = bigDst.fImage[(y + 200) * bigDst.fRowBytes + x + 300];
+                mismatches += expected != actual;
+            }
+        }
+        REPORTER_ASSERT(reporter, mismatches == 0, "sigma %g: %d mismatches", sigma, mismatches);
+    }
+}
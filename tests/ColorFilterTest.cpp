@@ -10,6 +10,9 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkColorMatrix.h"
+#include "include/effects/SkTableColorFilter.h"
+#include "include/private/SkColorData.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkReadBuffer.h"
@@ -90,3 +93,80 @@ DEF_TEST(ColorFilter, reporter) {
         }
     }
 }
+
+// Chains of matrices, or of tables, fold into one filter when that changes nothing but speed.
+DEF_TEST(ColorFilter_FoldedChains, reporter) {
+    auto check_same = [&](const sk_sp<SkColorFilter>& folded,
+                          std::initializer_list<sk_sp<SkColorFilter>> chain) {
+        SkRandom rand;
+        for (int i = 0; i < 100; ++i) {
+            const SkColor4f color = {rand.nextF(), rand.nextF(), rand.nextF(),
+                                     i < 10 ? 0.0f : rand.nextF()};
+            SkColor4f expected = color;
+            for (const sk_sp<SkColorFilter>& cf : chain) {
+                expected = cf->filterColor4f(expected, nullptr, nullptr);
+            }
+            SkColor4f actual = folded->filterColor4f(color, nullptr, nullptr);
+            // filterColor4f() unpremuls its result; compare premul colors.
+            SkPMColor4f e = expected.premul(), a = actual.premul();
+            for (int j = 0; j < 4; ++j) {
+                REPORTER_ASSERT(reporter, SkScalarNearlyEqual(e[j], a[j], 1 / 255.0f),
+                                "%g vs %g", e[j], a[j]);
+            }
+        }
+    };
+
+    SkColorMatrix desaturate, scale;
+    desaturate.setSaturation(0.5f);
+    scale.setScale(0.9f, 0.5f, 0.7f, 0.8f);
+    auto m0 = SkColorFilters::Matrix(desaturate),
+         m1 = SkColorFilters::Matrix(scale);
+
+    // Either association folds the chain into a single matrix.
+    auto chain = m0->makeComposed(m1)->makeComposed(m0);
+    REPORTER_ASSERT(reporter, chain->asAColorMatrix(nullptr));
+    check_same(chain, {m0, m1, m0});
+    chain = m0->makeComposed(m1->makeComposed(m0));
+    REPORTER_ASSERT(reporter, chain->asAColorMatrix(nullptr));
+    check_same(chain, {m0, m1, m0});
+
+    // A brightening matrix pushes color past 1, where the clamp between the two matters.
+    SkColorMatrix brighten;
+    brighten.setScale(1.5f, 1.5f, 1.5f);
+    auto bright = SkColorFilters::Matrix(brighten);
+    chain = m0->makeComposed(bright);
+    REPORTER_ASSERT(reporter, !chain->asAColorMatrix(nullptr));
+    check_same(chain, {bright, m0});
+
+    // An alpha matrix that makes transparent colors opaque can't absorb a scale that reaches 0.
+    const float opaque[20] = { 1, 0, 0, 0, 0,
+                               0, 1, 0, 0, 0,
+                               0, 0, 1, 0, 0,
+                               0, 0, 0, 0, 1 };
+    auto makeOpaque = SkColorFilters::Matrix(opaque);
+    chain = makeOpaque->makeComposed(m1);
+    REPORTER_ASSERT(reporter, !chain->asAColorMatrix(nullptr));
+    check_same(chain, {m1, makeOpaque});
+
+    // HSLA matrices are not color matrices, and don't fold.
+    auto hsla = SkColorFilters::HSLAMatrix(desaturate);
+    REPORTER_ASSERT(reporter, !hsla->asAColorMatrix(nullptr));
+    check_same(m0->makeComposed(hsla), {hsla, m0});
+
+    uint8_t invert[256], halve[256];
+    for (int i = 0; i < 256; ++i) {
+        invert[i] = 255 - i;
+        halve[i] = i / 2;
+    }
+    auto t0 = SkTableColorFilter::MakeARGB(nullptr, invert, nullptr, halve),
+         t1 = SkTableColorFilter::MakeARGB(halve, halve, invert, nullptr);
+    chain = t0->makeComposed(t1)->makeComposed(t0);
+    REPORTER_ASSERT(reporter, !strcmp(chain->getTypeName(), t0->getTypeName()));
+    check_same(chain, {t0, t1, t0});
+
+    // Inverting alpha turns 0 into 255, which can't absorb a table that makes alpha 0.
+    auto invertAlpha = SkTableColorFilter::MakeARGB(invert, nullptr, nullptr, nullptr);
+    chain = invertAlpha->makeComposed(t1);
+    REPORTER_ASSERT(reporter, strcmp(chain->getTypeName(), t0->getTypeName()));
+    check_same(chain, {t1, invertAlpha});
+}
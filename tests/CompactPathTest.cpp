@@ -0,0 +1,87 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/utils/SkCompactPath.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkPathPriv.h"
+#include "tests/Test.h"
+
+static void check_round_trip(skiatest::Reporter* reporter, const SkPath& path) {
+    SkCompactPath compact = SkCompactPath::Make(path);
+    REPORTER_ASSERT(reporter, compact.countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(reporter, compact.countPoints() == path.countPoints());
+    REPORTER_ASSERT(reporter, compact.getFillType() == path.getFillType());
+
+    SkPath decoded = compact.toPath();
+    REPORTER_ASSERT(reporter, decoded.countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(reporter, decoded.countPoints() == path.countPoints());
+    REPORTER_ASSERT(reporter, decoded.getFillType() == path.getFillType());
+
+    // Every point is within half a quantization step of the original.
+    const SkRect& bounds = path.getBounds();
+    SkScalar tolX = bounds.width() / 65535 + SK_ScalarNearlyZero;
+    SkScalar tolY = bounds.height() / 65535 + SK_ScalarNearlyZero;
+    for (int i = 0; i < path.countPoints(); ++i) {
+        SkPoint a = path.getPoint(i), b = decoded.getPoint(i);
+        REPORTER_ASSERT(reporter, SkScalarAbs(a.fX - b.fX) <= tolX);
+        REPORTER_ASSERT(reporter, SkScalarAbs(a.fY - b.fY) <= tolY);
+    }
+    for (int i = 0; i < path.countVerbs(); ++i) {
+        REPORTER_ASSERT(reporter, SkPathPriv::VerbData(path)[i] ==
+                                  SkPathPriv::VerbData(decoded)[i]);
+    }
+    REPORTER_ASSERT(reporter, SkPathPriv::ConicWeightCnt(path) ==
+                              SkPathPriv::ConicWeightCnt(decoded));
+    for (int i = 0; i < SkPathPriv::ConicWeightCnt(path); ++i) {
+        REPORTER_ASSERT(reporter, SkPathPriv::ConicWeightData(path)[i] ==
+                                  SkPathPriv::ConicWeightData(decoded)[i]);
+    }
+}
+
+DEF_TEST(CompactPath, reporter) {
+    SkCompactPath empty = SkCompactPath::Make(SkPath());
+    REPORTER_ASSERT(reporter, empty.isEmpty());
+    REPORTER_ASSERT(reporter, empty.toPath().isEmpty());
+
+    SkPath nonFinite;
+    nonFinite.moveTo(0, 0);
+    nonFinite.lineTo(SK_ScalarInfinity, 1);
+    REPORTER_ASSERT(reporter, SkCompactPath::Make(nonFinite).isEmpty());
+
+    SkPath shapes;
+    shapes.setFillType(SkPathFillType::kEvenOdd);
+    shapes.addRRect(SkRRect::MakeRectXY({10, 10, 200, 120}, 20, 30));
+    shapes.addCircle(-40, 60, 25);
+    shapes.moveTo(0, 0);
+    shapes.cubicTo(300, -50, -100, 400, 150, 150);
+    shapes.quadTo(10, 300, 0, 0);
+    shapes.close();
+    shapes.lineTo(5, 5);
+    check_round_trip(reporter, shapes);
+
+    // A flat path has an empty height and must still round trip.
+    SkPath flat;
+    flat.moveTo(0, 7);
+    flat.lineTo(100, 7);
+    check_round_trip(reporter, flat);
+
+    // A long polyline with small steps, like a map feature, should shrink substantially.
+    SkRandom rand;
+    SkPath polyline;
+    SkPoint pt = {1000, 1000};
+    polyline.moveTo(pt);
+    for (int i = 0; i < 10000; ++i) {
+        pt += {rand.nextRangeScalar(-1, 1), rand.nextRangeScalar(-1, 1)};
+        polyline.lineTo(pt);
+    }
+    check_round_trip(reporter, polyline);
+    SkCompactPath compact = SkCompactPath::Make(polyline);
+    REPORTER_ASSERT(reporter, compact.approximateBytesUsed() * 2 <
+                              polyline.countPoints() * sizeof(SkPoint));
+}
@@ -14,6 +14,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkSpecialImage.h"
 
 SK_USE_FLUENT_IMAGE_FILTER_TYPES
@@ -171,6 +172,48 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_explicit_purging(reporter, fullImg, subsetImg);
 }
 
+// Filters rebuilt with the same parameters share results in a content-keyed cache, and those
+// results outlive the filter that produced them.
+DEF_TEST(ImageFilterCache_ContentKeys, reporter) {
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> srcImg(
+            SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize, kFullSize), srcBM));
+
+    auto filter1 = make_filter();
+    auto filter2 = make_filter();
+    auto other = SkImageFilters::ColorFilter(
+            SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kSrcIn), nullptr, nullptr);
+    REPORTER_ASSERT(reporter, as_IFB(filter1)->uniqueID() != as_IFB(filter2)->uniqueID());
+    REPORTER_ASSERT(reporter, as_IFB(filter1)->contentID() == as_IFB(filter2)->contentID());
+    REPORTER_ASSERT(reporter, as_IFB(filter1)->contentID() != as_IFB(other)->contentID());
+    REPORTER_ASSERT(reporter, as_IFB(filter1)->contentID() != as_IFB(filter1)->uniqueID());
+
+    // Referenced images are compared by identity, not by their (here identical) pixels.
+    sk_sp<SkImage> image1 = SkImage::MakeFromBitmap(srcBM),
+                   image2 = SkImage::MakeRasterCopy(srcBM.pixmap());
+    REPORTER_ASSERT(reporter, as_IFB(SkImageFilters::Image(image1))->contentID() ==
+                              as_IFB(SkImageFilters::Image(image1))->contentID());
+    REPORTER_ASSERT(reporter, as_IFB(SkImageFilters::Image(image1))->contentID() !=
+                              as_IFB(SkImageFilters::Image(image2))->contentID());
+
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000, true));
+    skif::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kFullSize, kFullSize), cache.get(),
+                      kN32_SkColorType, nullptr, srcImg.get());
+    REPORTER_ASSERT(reporter, as_IFB(filter1)->filterImage(ctx).image());
+    filter1.reset();
+    REPORTER_ASSERT(reporter, as_IFB(filter2)->filterImage(ctx).image());
+    REPORTER_ASSERT(reporter, as_IFB(other)->filterImage(ctx).image());
+
+    SkImageFilterCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fHits == 1 && stats.fMisses == 2);
+    REPORTER_ASSERT(reporter, stats.fCount == 2 && stats.fBytesUsed > 0);
+
+    // Without content keys, the same filters miss.
+    cache->setUseContentKeys(false);
+    REPORTER_ASSERT(reporter, as_IFB(filter2)->filterImage(ctx).image());
+    REPORTER_ASSERT(reporter, cache->stats().fMisses == 3);
+}
+
 
 // Shared test code for both the raster and gpu-backed image cases
 static void test_image_backed(skiatest::Reporter* reporter,
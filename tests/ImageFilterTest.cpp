@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -674,6 +675,96 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(MorphologyFilterRadiusWithMirrorCTM_Gpu, repo
     test_morphology_radius_with_mirror_ctm(reporter, ctxInfo.directContext());
 }
 
+// The per-channel extreme of src over each pixel's window, computed one axis at a time. The
+// window is cut short at the edges of bounds, and reads transparent black outside of src.
+static SkBitmap morphology_reference(const SkBitmap& src, const SkIRect& bounds, SkISize radius,
+                                     bool dilate) {
+    auto extreme = [dilate](SkPMColor a, SkPMColor b) {
+        SkPMColor result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            U8CPU ca = a >> shift & 0xFF, cb = b >> shift & 0xFF;
+            result |= (SkPMColor)(dilate ? std::max(ca, cb) : std::min(ca, cb)) << shift;
+        }
+        return result;
+    };
+    const SkPMColor identity = dilate ? 0 : 0xFFFFFFFF;
+
+    SkBitmap rows, result;
+    rows.allocN32Pixels(bounds.width(), bounds.height());
+    result.allocN32Pixels(bounds.width(), bounds.height());
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+        for (int x = bounds.fLeft; x < bounds.fRight; ++x) {
+            SkPMColor e = identity;
+            for (int wx = std::max(x - radius.width(), bounds.fLeft);
+                 wx <= std::min(x + radius.width(), bounds.fRight - 1); ++wx) {
+                bool inside = wx >= 0 && y >= 0 && wx < src.width() && y < src.height();
+                e = extreme(e, inside ? *src.getAddr32(wx, y) : 0);
+            }
+            *rows.getAddr32(x - bounds.fLeft, y - bounds.fTop) = e;
+        }
+    }
+    for (int y = 0; y < bounds.height(); ++y) {
+        for (int x = 0; x < bounds.width(); ++x) {
+            SkPMColor e = identity;
+            for (int wy = std::max(y - radius.height(), 0);
+                 wy <= std::min(y + radius.height(), bounds.height() - 1); ++wy) {
+                e = extreme(e, *rows.getAddr32(x, wy));
+            }
+            *result.getAddr32(x, y) = e;
+        }
+    }
+    return result;
+}
+
+// Dilate and erode must match the reference for radii handled both by scanning the window and by
+// the block-based raster implementation.
+DEF_TEST(MorphologyFilterLargeRadius, reporter) {
+    // An odd number of rows, so the lines do not all fill groups of four.
+    static const int kWidth = 70, kHeight = 45;
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(kWidth, kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            U8CPU a = (x * 97 + y * 53) % 256;
+            *srcBM.getAddr32(x, y) = SkPreMultiplyARGB(a, x * 29 % 256, y * 41 % 256, 200);
+        }
+    }
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(kWidth, kHeight), srcBM));
+
+    const SkISize radii[] = { {1, 2}, {3, 0}, {0, 5}, {6, 4}, {23, 17}, {90, 60}, {150, 120} };
+    for (bool dilate : {true, false}) {
+        for (SkISize radius : radii) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radius.width(), radius.height(), nullptr)
+                           : SkImageFilters::Erode(radius.width(), radius.height(), nullptr);
+            SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight),
+                                            nullptr, kN32_SkColorType, nullptr, srcImg.get());
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result(as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset));
+            SkBitmap resultBM;
+            REPORTER_ASSERT(reporter, result && result->getROPixels(&resultBM));
+            if (!resultBM.getPixels()) {
+                continue;
+            }
+
+            SkBitmap expected = morphology_reference(
+                    srcBM, SkIRect::MakeXYWH(offset.fX, offset.fY, resultBM.width(),
+                                             resultBM.height()),
+                    radius, dilate);
+            int mismatches = 0;
+            for (int y = 0; y < resultBM.height(); ++y) {
+                for (int x = 0; x < resultBM.width(); ++x) {
+                    mismatches += *resultBM.getAddr32(x, y) != *expected.getAddr32(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, !mismatches, "%s %dx%d: %d mismatched pixels",
+                            dilate ? "dilate" : "erode", radius.width(), radius.height(),
+                            mismatches);
+        }
+    }
+}
+
 static void test_zero_blur_sigma(skiatest::Reporter* reporter, GrDirectContext* dContext) {
     // Check that SkBlurImageFilter with a zero sigma and a non-zero srcOffset works correctly.
     SkIRect cropRect = SkIRect::MakeXYWH(5, 0, 5, 10);
@@ -1185,6 +1276,84 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMatrixConvolutionBigKernel_Gpu,
     test_big_kernel(reporter, ctxInfo.directContext());
 }
 
+// Convolves src with kernel the slow way, reading transparent black outside of src.
+static SkPMColor convolve_reference(const SkBitmap& src, int x, int y, const SkISize& kernelSize,
+                                    const SkScalar* kernel, SkScalar gain, SkScalar bias,
+                                    const SkIPoint& kernelOffset) {
+    SkScalar sums[4] = {0, 0, 0, 0};
+    for (int cy = 0; cy < kernelSize.height(); ++cy) {
+        for (int cx = 0; cx < kernelSize.width(); ++cx) {
+            int sx = x + cx - kernelOffset.fX, sy = y + cy - kernelOffset.fY;
+            if (sx < 0 || sy < 0 || sx >= src.width() || sy >= src.height()) {
+                continue;
+            }
+            SkPMColor s = *src.getAddr32(sx, sy);
+            SkScalar k = kernel[cy * kernelSize.width() + cx];
+            sums[0] += SkGetPackedA32(s) * k;
+            sums[1] += SkGetPackedR32(s) * k;
+            sums[2] += SkGetPackedG32(s) * k;
+            sums[3] += SkGetPackedB32(s) * k;
+        }
+    }
+    int a = SkTPin(SkScalarFloorToInt(sums[0] * gain + bias), 0, 255);
+    return SkPackARGB32(a, SkTPin(SkScalarFloorToInt(sums[1] * gain + bias), 0, a),
+                           SkTPin(SkScalarFloorToInt(sums[2] * gain + bias), 0, a),
+                           SkTPin(SkScalarFloorToInt(sums[3] * gain + bias), 0, a));
+}
+
+// Factored (separable) and general kernels must both match a direct convolution, up to the
+// rounding of summing the taps in a different order.
+DEF_TEST(ImageFilterMatrixConvolutionSeparable, reporter) {
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(40, 30);
+    for (int y = 0; y < srcBM.height(); ++y) {
+        for (int x = 0; x < srcBM.width(); ++x) {
+            U8CPU a = (x * 37 + y * 11) % 256;
+            *srcBM.getAddr32(x, y) = SkPreMultiplyARGB(a, x * 6, y * 8, (x * y) % 256);
+        }
+    }
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(srcBM.width(), srcBM.height()), srcBM));
+
+    const SkScalar column[5] = {1, 4, 6, 4, 1},
+                   row[7] = {1, 2, 3, 4, 3, 2, 1};
+    SkScalar separable[35], general[35];
+    for (int i = 0; i < 35; ++i) {
+        separable[i] = column[i / 7] * row[i % 7];
+        general[i] = (i * 7 % 11) - 4.5f;
+    }
+
+    const SkISize kernelSize = SkISize::Make(7, 5);
+    const SkIPoint kernelOffset = SkIPoint::Make(4, 1);
+    for (const SkScalar* kernel : {separable, general}) {
+        SkScalar gain = kernel == separable ? 1 / 256.f : 0.05f, bias = 10;
+        sk_sp<SkImageFilter> filter(SkImageFilters::MatrixConvolution(
+                kernelSize, kernel, gain, bias, kernelOffset, SkTileMode::kDecal, true, nullptr));
+
+        SkIPoint offset;
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(40, 30), nullptr,
+                                        kN32_SkColorType, nullptr, srcImg.get());
+        sk_sp<SkSpecialImage> resultImg(as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset));
+        SkBitmap resultBM;
+        REPORTER_ASSERT(reporter, resultImg && resultImg->getROPixels(&resultBM));
+
+        int maxError = 0;
+        for (int y = 0; y < resultBM.height(); ++y) {
+            for (int x = 0; x < resultBM.width(); ++x) {
+                SkPMColor expected = convolve_reference(srcBM, x + offset.fX, y + offset.fY,
+                                                        kernelSize, kernel, gain, bias,
+                                                        kernelOffset),
+                          actual = *resultBM.getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    maxError = std::max(maxError, SkTAbs((int)(expected >> shift & 0xFF) -
+                                                         (int)(actual >> shift & 0xFF)));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, maxError <= 1, "max error %d", maxError);
+    }
+}
+
 DEF_TEST(ImageFilterCropRect, reporter) {
     test_cropRects(reporter, nullptr);
 }
@@ -1743,6 +1912,123 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMakeWithFilter_Gpu, reporter, ctxI
     test_make_with_filter(reporter, ctxInfo.directContext());
 }
 
+// Draws a filtered image into a transparent bitmap covering clipBounds.
+static SkBitmap draw_filtered(sk_sp<SkImage> image, const SkIRect& outSubset,
+                              const SkIPoint& offset, const SkIRect& clipBounds) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(clipBounds.width(), clipBounds.height());
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorTRANSPARENT);
+    canvas.translate(SkIntToScalar(offset.x() - clipBounds.x()),
+                     SkIntToScalar(offset.y() - clipBounds.y()));
+    canvas.drawImageRect(image, outSubset, SkRect::MakeIWH(outSubset.width(), outSubset.height()),
+                         nullptr);
+    return bitmap;
+}
+
+// Pixel-aligned rects, so the content is identical wherever it is drawn.
+static sk_sp<SkImage> make_cross_image(int width, int height, int x, int y) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(width, height);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setColor(0xFF3080C0);
+    surface->getCanvas()->drawRect(SkRect::MakeXYWH(x + 20, y + 80, 160, 40), paint);
+    paint.setColor(0x80C04020);
+    surface->getCanvas()->drawRect(SkRect::MakeXYWH(x + 80, y + 20, 40, 160), paint);
+    return surface->makeImageSnapshot();
+}
+
+// The raster blur splits big images into strips, so blurring a shape in the middle of a big
+// image must give the same pixels as blurring it in an image of its own.
+DEF_TEST(ImageFilterBlurStrips, reporter) {
+    sk_sp<SkImage> small = make_cross_image(200, 200, 0, 0),
+                   big   = make_cross_image(1000, 800, 400, 300);
+    const SkIRect smallClip = SkIRect::MakeLTRB(-40, -40, 240, 240),
+                  bigClip   = SkIRect::MakeWH(1000, 800);
+
+    for (SkScalar sigma : {4.f, 12.f}) {
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(sigma, sigma, nullptr);
+        SkIRect smallSubset, bigSubset;
+        SkIPoint smallOffset, bigOffset;
+        sk_sp<SkImage> smallResult = small->makeWithFilter(nullptr, blur.get(), small->bounds(),
+                                                           smallClip, &smallSubset, &smallOffset);
+        sk_sp<SkImage> bigResult = big->makeWithFilter(nullptr, blur.get(), big->bounds(),
+                                                       bigClip, &bigSubset, &bigOffset);
+        REPORTER_ASSERT(reporter, smallResult && bigResult);
+        if (!smallResult || !bigResult) {
+            continue;
+        }
+        SkBitmap smallBitmap = draw_filtered(smallResult, smallSubset, smallOffset, smallClip),
+                 bigBitmap   = draw_filtered(bigResult, bigSubset, bigOffset, bigClip);
+
+        int mismatches = 0;
+        for (int y = 0; y < smallClip.height(); ++y) {
+            for (int x = 0; x < smallClip.width(); ++x) {
+                mismatches += *smallBitmap.getAddr32(x, y) !=
+                              *bigBitmap.getAddr32(x + 400 + smallClip.x(),
+                                                   y + 300 + smallClip.y());
+            }
+        }
+        REPORTER_ASSERT(reporter, mismatches == 0, "sigma %g: %d mismatches", sigma, mismatches);
+    }
+}
+
+// Evaluating a DAG one tile at a time, serially or on an executor, must match evaluating it
+// over the whole clip at once.
+DEF_TEST(ImageFilterMakeWithFilterTiled, reporter) {
+    sk_sp<SkSurface> surface(create_surface(nullptr, 300, 200));
+    SkPaint paint;
+    SkPoint pts[] = {{0, 0}, {300, 200}};
+    SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    surface->getCanvas()->drawPaint(paint);
+    paint.setShader(nullptr);
+    paint.setColor(SK_ColorGREEN);
+    surface->getCanvas()->drawCircle(120, 90, 50, paint);
+    sk_sp<SkImage> sourceImage = surface->makeImageSnapshot();
+
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(6, 6, nullptr);
+    sk_sp<SkImageFilter> inputs[] = {
+        make_grayscale(blur, nullptr),
+        SkImageFilters::Offset(20, -10, blur),
+        SkImageFilters::Dilate(3, 3, nullptr),
+    };
+    sk_sp<SkImageFilter> filter = SkImageFilters::Merge(inputs, SK_ARRAY_COUNT(inputs));
+
+    const SkIRect subset = SkIRect::MakeXYWH(10, 10, 280, 180);
+    const SkIRect clipBounds = SkIRect::MakeXYWH(5, 15, 250, 170);
+    SkIRect outSubset;
+    SkIPoint offset;
+    sk_sp<SkImage> expected = sourceImage->makeWithFilter(nullptr, filter.get(), subset,
+                                                          clipBounds, &outSubset, &offset);
+    REPORTER_ASSERT(reporter, expected);
+    SkBitmap expectedBitmap = draw_filtered(expected, outSubset, offset, clipBounds);
+
+    REPORTER_ASSERT(reporter, !sourceImage->makeWithFilter(filter.get(), subset, clipBounds,
+                                                           &outSubset, &offset, 0));
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int tileSize : {37, 64, 1000}) {
+        for (SkExecutor* tileExecutor : {(SkExecutor*)nullptr, executor.get()}) {
+            sk_sp<SkImage> tiled = sourceImage->makeWithFilter(filter.get(), subset, clipBounds,
+                                                               &outSubset, &offset, tileSize,
+                                                               tileExecutor);
+            REPORTER_ASSERT(reporter, tiled);
+            if (!tiled) {
+                continue;
+            }
+            SkBitmap tiledBitmap = draw_filtered(tiled, outSubset, offset, clipBounds);
+            bool matches = true;
+            for (int y = 0; y < clipBounds.height() && matches; ++y) {
+                matches = !memcmp(expectedBitmap.getAddr32(0, y), tiledBitmap.getAddr32(0, y),
+                                  clipBounds.width() * sizeof(SkPMColor));
+            }
+            REPORTER_ASSERT(reporter, matches, "tile size %d, %s", tileSize,
+                            tileExecutor ? "threaded" : "serial");
+        }
+    }
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterHugeBlur_Gpu, reporter, ctxInfo) {
 
     sk_sp<SkSurface> surf(SkSurface::MakeRenderTarget(ctxInfo.directContext(),
@@ -1026,6 +1026,87 @@ DEF_TEST(Matrix_maprects, r) {
     }
 }
 
+// The batch entry points run through SkOpts kernels; check them against the per-point math for
+// counts that exercise both the full-width steps and the leftovers.
+DEF_TEST(Matrix_batch, r) {
+    auto nearly_equal_pt = [](SkPoint a, SkPoint b) {
+        return SkScalarNearlyEqual(a.fX, b.fX, 1e-4f * std::max(1.f, SkScalarAbs(b.fX))) &&
+               SkScalarNearlyEqual(a.fY, b.fY, 1e-4f * std::max(1.f, SkScalarAbs(b.fY)));
+    };
+
+    SkMatrix affine = SkMatrix::Translate(5, -3);
+    affine.preRotate(30).preScale(2, 0.5f);
+    SkMatrix persp = affine;
+    persp.setPerspX(0.001f);
+    persp.setPerspY(-0.002f);
+
+    SkRandom rand;
+    constexpr int kCount = 37;
+    SkPoint pts[kCount];
+    SkRect rects[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        pts[i] = { rand.nextRangeF(-100, 100), rand.nextRangeF(-100, 100) };
+        rects[i] = SkRect::MakeLTRB(rand.nextRangeF(-100, 0), rand.nextRangeF(-100, 0),
+                                    rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+    }
+
+    for (const SkMatrix& m : { affine, persp }) {
+        for (int count : { 1, 7, 8, 9, kCount }) {
+            SkPoint mapped[kCount];
+            m.mapPoints(mapped, pts, count);
+            for (int i = 0; i < count; ++i) {
+                REPORTER_ASSERT(r, nearly_equal_pt(mapped[i], m.mapXY(pts[i].fX, pts[i].fY)));
+            }
+
+            SkPoint3 homogeneous[kCount];
+            m.mapHomogeneousPoints(homogeneous, pts, count);
+            for (int i = 0; i < count; ++i) {
+                SkPoint3 expected, src = {pts[i].fX, pts[i].fY, 1};
+                m.mapHomogeneousPoints(&expected, &src, 1);
+                REPORTER_ASSERT(r, nearly_equal_pt({homogeneous[i].fX, homogeneous[i].fY},
+                                                {expected.fX, expected.fY}));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(homogeneous[i].fZ, expected.fZ, 1e-4f));
+            }
+
+            SkRect bounds[kCount];
+            m.mapRects(bounds, rects, count);
+            for (int i = 0; i < count; ++i) {
+                SkRect expected = m.mapRect(rects[i]);
+                REPORTER_ASSERT(r, nearly_equal_pt({bounds[i].fLeft, bounds[i].fTop},
+                                                {expected.fLeft, expected.fTop}));
+                REPORTER_ASSERT(r, nearly_equal_pt({bounds[i].fRight, bounds[i].fBottom},
+                                                {expected.fRight, expected.fBottom}));
+            }
+
+            SkPoint quads[4 * kCount];
+            m.mapRectsToQuads(quads, rects, count);
+            for (int i = 0; i < count; ++i) {
+                SkPoint expected[4];
+                m.mapRectToQuad(expected, rects[i]);
+                for (int j = 0; j < 4; ++j) {
+                    REPORTER_ASSERT(r, nearly_equal_pt(quads[4 * i + j], expected[j]));
+                }
+            }
+        }
+    }
+
+    // In place, and with a point on the perspective horizon, which maps to the origin.
+    SkPoint horizon[] = { { 1, 1 }, { 0, 0 } };
+    SkMatrix horizonMatrix = SkMatrix::MakeAll(1, 0, 0,  0, 1, 0,  1, 0, -1);
+    horizonMatrix.mapPoints(horizon, SK_ARRAY_COUNT(horizon));
+    REPORTER_ASSERT(r, horizon[0] == SkPoint::Make(0, 0));
+    REPORTER_ASSERT(r, horizon[1] == SkPoint::Make(0, 0));
+
+    // A rect whose corners overflow reports non-finite bounds, as mapRect() does.
+    SkMatrix huge;
+    huge.setRotate(30);
+    huge.postScale(1e20f, 1e20f);
+    SkRect hugeRects[] = { { 0, 0, 1e20f, 1e20f }, { 0, 0, 1, 1 } };
+    huge.mapRects(hugeRects, hugeRects, SK_ARRAY_COUNT(hugeRects));
+    REPORTER_ASSERT(r, !hugeRects[0].isFinite());
+    REPORTER_ASSERT(r, hugeRects[1].isFinite());
+}
+
 DEF_TEST(Matrix_Ctor, r) {
     REPORTER_ASSERT(r, SkMatrix{} == SkMatrix::I());
 }
@@ -6,11 +6,16 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/private/SkHalf.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkMipmap.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <vector>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -211,6 +216,199 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// Large levels are filled in strips of rows. A crop small enough to fill as one strip, taken at an
+// even offset and with the same odd or even dimensions, must produce the same pixels as the
+// corresponding part of the whole level.
+DEF_TEST(MipMap_Strips, reporter) {
+    const SkColorType colorTypes[] = {
+        kRGBA_8888_SkColorType, kBGRA_8888_SkColorType, kRGB_565_SkColorType,
+        kARGB_4444_SkColorType, kAlpha_8_SkColorType, kGray_8_SkColorType,
+        kRGBA_F16_SkColorType, kR8G8_unorm_SkColorType, kR16G16_unorm_SkColorType,
+        kA16_unorm_SkColorType, kRGBA_1010102_SkColorType, kA16_float_SkColorType,
+        kR16G16_float_SkColorType, kR16G16B16A16_unorm_SkColorType,
+    };
+    const SkISize sizes[] = { {600, 522}, {601, 523} };
+
+    SkRandom rand;
+    for (SkColorType ct : colorTypes) {
+        for (SkISize size : sizes) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            SkPixmap pm = bm.pixmap();
+            auto bytes = static_cast<uint8_t*>(pm.writable_addr());
+            for (size_t i = 0; i < pm.computeByteSize(); ++i) {
+                bytes[i] = rand.nextU() & 0xFF;
+            }
+            if (ct == kRGBA_F16_SkColorType || ct == kA16_float_SkColorType ||
+                ct == kR16G16_float_SkColorType) {
+                auto halfs = static_cast<SkHalf*>(pm.writable_addr());
+                for (size_t i = 0; i < pm.computeByteSize() / sizeof(SkHalf); ++i) {
+                    halfs[i] = SkFloatToHalf(rand.nextRangeF(0.25f, 1));
+                }
+            }
+
+            SkIRect crop = SkIRect::MakeXYWH(200, 300, 100 + (size.width() & 1),
+                                                       90 + (size.height() & 1));
+            SkPixmap cropped;
+            REPORTER_ASSERT(reporter, pm.extractSubset(&cropped, crop));
+            sk_sp<SkMipmap> whole(SkMipmap::Build(pm, nullptr)),
+                            part(SkMipmap::Build(cropped, nullptr));
+            SkMipmap::Level wholeLevel, partLevel;
+            REPORTER_ASSERT(reporter, whole && whole->getLevel(0, &wholeLevel));
+            REPORTER_ASSERT(reporter, part && part->getLevel(0, &partLevel));
+
+            const SkPixmap& w = wholeLevel.fPixmap;
+            const SkPixmap& p = partLevel.fPixmap;
+            bool same = true;
+            for (int y = 0; y < p.height(); ++y) {
+                same &= !memcmp(p.addr(0, y), w.addr(crop.x() / 2, crop.y() / 2 + y),
+                                p.info().minRowBytes());
+            }
+            REPORTER_ASSERT(reporter, same, "color type %d, %dx%d", ct, size.width(),
+                            size.height());
+        }
+    }
+}
+
+DEF_TEST(MipMap_R16G16, reporter) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(2, 2, kR16G16_unorm_SkColorType, kPremul_SkAlphaType));
+    const uint16_t rg[] = { 100, 1000, 300, 3000, 500, 5000, 700, 7000 };
+    memcpy(bm.getPixels(), rg, sizeof(rg));
+
+    sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+    SkMipmap::Level level;
+    REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+    auto avg = static_cast<const uint16_t*>(level.fPixmap.addr());
+    REPORTER_ASSERT(reporter, avg[0] == 400 && avg[1] == 4000, "%d %d", avg[0], avg[1]);
+}
+
+DEF_TEST(MipMap_LinearLight, reporter) {
+    // A checkerboard of black and white averages to 50% gray: 127 when averaged as encoded, and
+    // the sRGB encoding of 0.5, 188, when averaged in linear light.
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32(64, 64, kPremul_SkAlphaType, SkColorSpace::MakeSRGB()));
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = ((x ^ y) & 1) ? 0xFFFFFFFF : 0xFF000000;
+        }
+    }
+
+    auto gray_of = [&](SkMipmap::Averaging averaging) {
+        sk_sp<SkMipmap> mm(SkMipmap::Build(bm.pixmap(), nullptr, true, averaging));
+        SkMipmap::Level level;
+        REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+        SkColor c = level.fPixmap.getColor(5, 7);
+        REPORTER_ASSERT(reporter, SkColorGetA(c) == 0xFF);
+        REPORTER_ASSERT(reporter, SkColorGetR(c) == SkColorGetG(c) &&
+                                  SkColorGetG(c) == SkColorGetB(c));
+        return (int)SkColorGetR(c);
+    };
+    REPORTER_ASSERT(reporter, gray_of(SkMipmap::Averaging::kEncoded) == 127);
+    int linear = gray_of(SkMipmap::Averaging::kLinearLight);
+    REPORTER_ASSERT(reporter, SkTAbs(linear - 188) <= 1, "%d", linear);
+
+    // Half-transparent white over transparent stays premultiplied: color never exceeds alpha.
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = ((x ^ y) & 1) ? SkPackARGB32(0x80, 0x80, 0x80, 0x80) : 0;
+        }
+    }
+    sk_sp<SkMipmap> mm(SkMipmap::Build(bm.pixmap(), nullptr, true,
+                                       SkMipmap::Averaging::kLinearLight));
+    for (int i = 0; i < mm->countLevels(); ++i) {
+        SkMipmap::Level level;
+        REPORTER_ASSERT(reporter, mm->getLevel(i, &level));
+        for (int y = 0; y < level.fPixmap.height(); ++y) {
+            for (int x = 0; x < level.fPixmap.width(); ++x) {
+                SkPMColor c = *level.fPixmap.addr32(x, y);
+                REPORTER_ASSERT(reporter, SkGetPackedR32(c) <= SkGetPackedA32(c) &&
+                                          SkGetPackedG32(c) <= SkGetPackedA32(c) &&
+                                          SkGetPackedB32(c) <= SkGetPackedA32(c));
+            }
+        }
+    }
+}
+
+// Discardable memory that is only purged when a test says so.
+class TestDiscardable : public SkDiscardableMemory {
+public:
+    explicit TestDiscardable(size_t bytes) : fMemory(sk_malloc_throw(bytes)) {}
+
+    bool lock() override { return !fPurged; }
+    void* data() override { return fMemory.get(); }
+    void unlock() override {}
+
+    bool fPurged = false;
+
+private:
+    SkAutoFree fMemory;
+};
+
+static std::vector<TestDiscardable*> gLazyAllocations;
+
+static SkDiscardableMemory* lazy_factory(size_t bytes) {
+    gLazyAllocations.push_back(new TestDiscardable(bytes));
+    return gLazyAllocations.back();
+}
+
+// A lazy mipmap builds a level, and any levels above it not built yet, when it is asked for, and
+// builds the same pixels as a mipmap built up front.
+DEF_TEST(MipMap_Lazy, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 60);
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+        }
+    }
+    sk_sp<SkMipmap> eager(SkMipmap::Build(bm, nullptr));
+
+    // The first allocation holds the Level structs, and one more is made per level built.
+    gLazyAllocations.clear();
+    SkMipmap* lazy = SkMipmap::BuildLazy(bm, lazy_factory);
+    REPORTER_ASSERT(reporter, lazy && lazy->countLevels() == eager->countLevels());
+    REPORTER_ASSERT(reporter, gLazyAllocations.size() == 1);
+
+    auto same_level = [&](int index) {
+        SkMipmap::Level a, b;
+        if (!eager->getLevel(index, &a) || !lazy->getLevel(index, &b) ||
+            a.fPixmap.dimensions() != b.fPixmap.dimensions()) {
+            return false;
+        }
+        for (int y = 0; y < a.fPixmap.height(); ++y) {
+            if (memcmp(a.fPixmap.addr32(0, y), b.fPixmap.addr32(0, y), a.fPixmap.width() * 4)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    REPORTER_ASSERT(reporter, same_level(2));
+    REPORTER_ASSERT(reporter, gLazyAllocations.size() == 4);
+    REPORTER_ASSERT(reporter, same_level(0));
+    REPORTER_ASSERT(reporter, gLazyAllocations.size() == 4);
+
+    // Once only a cache owns it, its levels can be purged and it lets go of its base. When it
+    // is found again, it rebuilds the purged levels after being given its base back.
+    lazy->attachToCacheAndRef();
+    lazy->unref();
+    REPORTER_ASSERT(reporter, lazy->needsBase());
+    for (size_t i = 1; i < gLazyAllocations.size(); ++i) {
+        gLazyAllocations[i]->fPurged = true;
+    }
+    lazy->ref();
+    SkMipmap::Level level;
+    REPORTER_ASSERT(reporter, !lazy->getLevel(1, &level));
+    lazy->setBase(bm);
+    REPORTER_ASSERT(reporter, !lazy->needsBase());
+    REPORTER_ASSERT(reporter, same_level(1));
+    REPORTER_ASSERT(reporter, gLazyAllocations.size() == 6);
+    lazy->unref();
+    lazy->detachFromCacheAndUnref();
+    gLazyAllocations.clear();
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 
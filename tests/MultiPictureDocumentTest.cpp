@@ -162,3 +162,82 @@ DEF_TEST(Serialize_and_deserialize_multi_skp, reporter) {
         i++;
     }
 }
+
+// Pages are written as they end, and can each be read without reading the others.
+DEF_TEST(Multi_skp_random_access, reporter) {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc = SkMakeMultiPictureDocument(&stream);
+
+    static const int kPages = 5;
+    size_t written = 0;
+    for (int i = 0; i < kPages; i++) {
+        SkCanvas* canvas = doc->beginPage(100 + i, 200);
+        canvas->drawRect(SkRect::MakeWH(10 * (i + 1), 10), SkPaint());
+        doc->endPage();
+        REPORTER_ASSERT(reporter, stream.bytesWritten() > written);
+        written = stream.bytesWritten();
+    }
+    doc->close();
+
+    std::unique_ptr<SkStreamAsset> data = stream.detachAsStream();
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentReadPageCount(data.get()) == kPages);
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentIsIndexed(data.get()));
+    for (int i : {3, 0, 4, 1}) {
+        SkDocumentPage page;
+        REPORTER_ASSERT(reporter, SkMultiPictureDocumentReadPage(data.get(), i, &page));
+        REPORTER_ASSERT(reporter, page.fSize == SkSize::Make(100 + i, 200));
+        REPORTER_ASSERT(reporter, page.fPicture &&
+                                  page.fPicture->cullRect() == SkRect::MakeWH(100 + i, 200));
+        REPORTER_ASSERT(reporter, page.fPicture && page.fPicture->approximateOpCount() == 1);
+    }
+    SkDocumentPage page;
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentReadPage(data.get(), kPages, &page));
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentReadPage(data.get(), -1, &page));
+
+    // A document that wasn't closed has no page table, and can't be read.
+    SkDynamicMemoryWStream unfinished;
+    doc = SkMakeMultiPictureDocument(&unfinished);
+    doc->beginPage(100, 100);
+    doc->endPage();
+    doc->abort();
+    std::unique_ptr<SkStreamAsset> unfinishedData = unfinished.detachAsStream();
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentReadPageCount(unfinishedData.get()) == 0);
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentIsIndexed(unfinishedData.get()));
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentReadPage(unfinishedData.get(), 0, &page));
+}
+
+// Documents written before pages had offsets are still read, though not a page at a time.
+DEF_TEST(Multi_skp_version2, reporter) {
+    static const int kPages = 3;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    for (int i = 0; i < kPages; i++) {
+        SkPictureRecorder pageRecorder;
+        pageRecorder.beginRecording(SkRect::MakeWH(100, 50 + i))
+                    ->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+        canvas->drawPicture(pageRecorder.finishRecordingAsPicture());
+        canvas->drawAnnotation(SkRect::MakeEmpty(), "SkMultiPictureEndPage",
+                               SkData::MakeWithCString("X"));
+    }
+
+    SkDynamicMemoryWStream stream;
+    stream.writeText("Skia Multi-Picture Doc\n\n");
+    stream.write32(2);
+    stream.write32(kPages);
+    for (int i = 0; i < kPages; i++) {
+        SkSize size = SkSize::Make(100, 50 + i);
+        stream.write(&size, sizeof(size));
+    }
+    recorder.finishRecordingAsPicture()->serialize(&stream);
+    std::unique_ptr<SkStreamAsset> data = stream.detachAsStream();
+
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentReadPageCount(data.get()) == kPages);
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentIsIndexed(data.get()));
+    SkDocumentPage pages[kPages];
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentRead(data.get(), pages, kPages));
+    SkDocumentPage page;
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentReadPage(data.get(), 2, &page));
+    REPORTER_ASSERT(reporter, page.fSize == SkSize::Make(100, 52));
+    REPORTER_ASSERT(reporter, page.fPicture &&
+                              page.fPicture->cullRect() == SkRect::MakeWH(100, 52));
+}
@@ -6,6 +6,8 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
+#include "include/utils/SkRandom.h"
 #include "tests/PathOpsExtendedTest.h"
 #include "tests/PathOpsTestCommon.h"
 #include "tests/Test.h"
@@ -79,6 +81,58 @@ DEF_TEST(PathOpsBuilder, reporter) {
     REPORTER_ASSERT(reporter, pixelDiff == 0);
 }
 
+DEF_TEST(PathOpsBulkOp, reporter) {
+    SkPath result;
+    REPORTER_ASSERT(reporter, BulkOp(nullptr, 0, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+    REPORTER_ASSERT(reporter, !BulkOp(nullptr, 0, kDifference_SkPathOp, &result));
+
+    // Two clusters of overlapping circles, a pair of rects sharing an edge, and an empty path.
+    SkPath paths[7];
+    paths[0].addCircle(10, 10, 6);
+    paths[1].addCircle(16, 12, 6, SkPathDirection::kCCW);
+    paths[2].addCircle(60, 60, 5);
+    paths[3].addCircle(64, 58, 5);
+    paths[4].addRect(30, 70, 40, 80);
+    paths[5].addRect(40, 70, 50, 80);
+    SkOpBuilder builder;
+    for (const SkPath& path : paths) {
+        builder.add(path, kUnion_SkPathOp);
+    }
+    SkPath expected;
+    REPORTER_ASSERT(reporter, builder.resolve(&expected));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkExecutor* exec : { (SkExecutor*) nullptr, executor.get() }) {
+        REPORTER_ASSERT(reporter, BulkOp(paths, SK_ARRAY_COUNT(paths), kUnion_SkPathOp, &result,
+                                         exec));
+        REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+        REPORTER_ASSERT(reporter, result.getBounds() == expected.getBounds());
+    }
+
+    // Intersection of overlapping circles, and of operands with no common area.
+    Op(paths[0], paths[1], kIntersect_SkPathOp, &expected);
+    REPORTER_ASSERT(reporter, BulkOp(paths, 2, kIntersect_SkPathOp, &result, executor.get()));
+    REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+    REPORTER_ASSERT(reporter, BulkOp(paths, 4, kIntersect_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+
+    // Many random rects must match the sequential builder.
+    SkRandom rand;
+    SkTArray<SkPath> rects;
+    for (int i = 0; i < 64; ++i) {
+        SkScalar x = rand.nextRangeScalar(0, 90);
+        SkScalar y = rand.nextRangeScalar(0, 90);
+        rects.push_back().addRect(x, y, x + rand.nextRangeScalar(1, 10),
+                                  y + rand.nextRangeScalar(1, 10));
+        builder.add(rects.back(), kUnion_SkPathOp);
+    }
+    REPORTER_ASSERT(reporter, builder.resolve(&expected));
+    REPORTER_ASSERT(reporter, BulkOp(rects.begin(), rects.count(), kUnion_SkPathOp, &result,
+                                     executor.get()));
+    REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+}
+
 DEF_TEST(BuilderIssue3838, reporter) {
     SkPath path;
     path.moveTo(200, 170);
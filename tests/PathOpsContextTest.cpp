@@ -0,0 +1,55 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/pathops/SkPathOps.h"
+#include "tests/Test.h"
+
+DEF_TEST(PathOpsContext, reporter) {
+    SkPath one, two, loop;
+    one.addOval({-10, -20, 10, 20});
+    two.addOval({-20, -10, 20, 10});
+    loop.moveTo(0, 0);
+    loop.cubicTo(30, 30, -10, 30, 20, 0);
+    loop.close();
+
+    SkOpContext context;
+    SkOpContext::Stats stats = context.stats();
+    REPORTER_ASSERT(reporter, stats.fOpCount == 0);
+    REPORTER_ASSERT(reporter, stats.fArenaGrowths == 0);
+
+    // Results through a context match the context-free entry points exactly.
+    for (SkPathOp op : { kDifference_SkPathOp, kIntersect_SkPathOp, kUnion_SkPathOp,
+                         kXOR_SkPathOp, kReverseDifference_SkPathOp }) {
+        SkPath expected, result;
+        REPORTER_ASSERT(reporter, Op(one, two, op, &expected));
+        REPORTER_ASSERT(reporter, context.op(one, two, op, &result));
+        REPORTER_ASSERT(reporter, expected == result);
+    }
+    SkPath expected, result;
+    REPORTER_ASSERT(reporter, Simplify(loop, &expected));
+    REPORTER_ASSERT(reporter, context.simplify(loop, &result));
+    REPORTER_ASSERT(reporter, expected == result);
+
+    // Once the arenas have grown to fit, repeating the same work does not grow them again.
+    stats = context.stats();
+    REPORTER_ASSERT(reporter, stats.fOpCount == 6);
+    REPORTER_ASSERT(reporter, stats.fBytesReserved > 0);
+    for (int i = 0; i < 10; ++i) {
+        context.op(one, two, kUnion_SkPathOp, &result);
+        context.simplify(loop, &result);
+    }
+    SkOpContext::Stats after = context.stats();
+    REPORTER_ASSERT(reporter, after.fOpCount == 26);
+    REPORTER_ASSERT(reporter, after.fArenaGrowths == stats.fArenaGrowths);
+    REPORTER_ASSERT(reporter, after.fBytesReserved == stats.fBytesReserved);
+
+    context.reset();
+    stats = context.stats();
+    REPORTER_ASSERT(reporter, stats.fOpCount == 0);
+    REPORTER_ASSERT(reporter, stats.fArenaGrowths == 0);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/utils/SkPathTriangulator.h"
+#include "tests/Test.h"
+
+static float mesh_area(const SkPathTriangulator::Mesh& mesh) {
+    float area = 0;
+    for (int i = 0; i < mesh.triangleCount(); ++i) {
+        SkPoint a = mesh.fVertices[mesh.fIndices[3 * i + 0]],
+                b = mesh.fVertices[mesh.fIndices[3 * i + 1]],
+                c = mesh.fVertices[mesh.fIndices[3 * i + 2]];
+        area += SkScalarAbs(SkPoint::CrossProduct(b - a, c - a)) / 2;
+    }
+    return area;
+}
+
+static bool indices_in_range(const SkPathTriangulator::Mesh& mesh) {
+    for (uint32_t index : mesh.fIndices) {
+        if (index >= mesh.fVertices.size()) {
+            return false;
+        }
+    }
+    return mesh.fIndices.size() % 3 == 0;
+}
+
+DEF_TEST(PathTriangulator, r) {
+    SkPathTriangulator triangulator;
+    SkPathTriangulator::Mesh mesh;
+
+    SkPath square = SkPath::Rect(SkRect::MakeWH(10, 10));
+    REPORTER_ASSERT(r, triangulator.triangulate(square, &mesh));
+    REPORTER_ASSERT(r, mesh.triangleCount() == 2);
+    REPORTER_ASSERT(r, mesh.fVertices.size() == 4);
+    REPORTER_ASSERT(r, indices_in_range(mesh));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(mesh_area(mesh), 100));
+
+    // A hole under even-odd, and the inverse fill of the same shape within a clip.
+    SkPath frame = square;
+    frame.addRect(SkRect::MakeLTRB(2, 2, 8, 8));
+    frame.setFillType(SkPathFillType::kEvenOdd);
+    REPORTER_ASSERT(r, triangulator.triangulate(frame, &mesh));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(mesh_area(mesh), 64));
+    frame.setFillType(SkPathFillType::kInverseEvenOdd);
+    REPORTER_ASSERT(r, triangulator.triangulate(frame, SkRect::MakeLTRB(-10, -10, 20, 20), &mesh));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(mesh_area(mesh), 900 - 64));
+
+    // Reusing the triangulator gives the same mesh.
+    SkPathTriangulator::Mesh again;
+    REPORTER_ASSERT(r, triangulator.triangulate(frame, SkRect::MakeLTRB(-10, -10, 20, 20), &again));
+    REPORTER_ASSERT(r, again.fVertices == mesh.fVertices && again.fIndices == mesh.fIndices);
+
+    SkPath empty;
+    REPORTER_ASSERT(r, triangulator.triangulate(empty, &mesh));
+    REPORTER_ASSERT(r, mesh.fIndices.empty() && mesh.fVertices.empty());
+
+    SkPath nonFinite;
+    nonFinite.moveTo(0, 0);
+    nonFinite.lineTo(SK_ScalarInfinity, 0);
+    nonFinite.lineTo(0, 1);
+    REPORTER_ASSERT(r, !triangulator.triangulate(nonFinite, &mesh));
+    REPORTER_ASSERT(r, mesh.fIndices.empty());
+}
+
+// Contour groups triangulated in parallel must cover the same area as the path as a whole.
+DEF_TEST(PathTriangulator_Threaded, r) {
+    SkPath path;
+    for (int i = 0; i < 50; ++i) {
+        // Pairs of overlapping circles, far enough apart that each pair is its own group.
+        path.addCircle(i * 30.f, 0, 10);
+        path.addCircle(i * 30.f + 8, 4, 6, SkPathDirection::kCCW);
+    }
+
+    SkPathTriangulator serial;
+    SkPathTriangulator::Mesh serialMesh;
+    REPORTER_ASSERT(r, serial.triangulate(path, &serialMesh));
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkPathTriangulator threaded(executor.get());
+    SkPathTriangulator::Mesh threadedMesh;
+    for (SkPathFillType fillType : { SkPathFillType::kWinding, SkPathFillType::kEvenOdd }) {
+        path.setFillType(fillType);
+        REPORTER_ASSERT(r, serial.triangulate(path, &serialMesh));
+        REPORTER_ASSERT(r, threaded.triangulate(path, &threadedMesh));
+        REPORTER_ASSERT(r, indices_in_range(threadedMesh));
+        REPORTER_ASSERT(r, threadedMesh.triangleCount() > 0);
+        float serialArea = mesh_area(serialMesh),
+              threadedArea = mesh_area(threadedMesh);
+        REPORTER_ASSERT(r, SkScalarNearlyEqual(serialArea, threadedArea, serialArea * 1e-4f),
+                        "%g vs %g", serialArea, threadedArea);
+    }
+}
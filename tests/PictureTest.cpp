@@ -11,7 +11,9 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -21,10 +23,12 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkClipOpPriv.h"
@@ -33,7 +37,9 @@
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 class SkRRect;
 class SkRegion;
@@ -999,3 +1005,125 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_lazySubPictures, r) {
+    auto make_pic = [](SkRect cull, SkColor color) {
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording(cull);
+        SkPaint paint;
+        paint.setColor(color);
+        c->drawRect(cull, paint);
+        paint.setColor(SK_ColorBLACK);
+        c->drawRect(cull.makeInset(10, 10), paint);
+        return rec.finishRecordingAsPicture();
+    };
+
+    SkPictureRecorder rec;
+    SkCanvas* c = rec.beginRecording({0,0, 300,300});
+    c->drawPicture(make_pic({ 0, 0,  50, 50}, SK_ColorRED));
+    c->drawPicture(make_pic({200,200, 250,250}, SK_ColorBLUE));
+    sk_sp<SkPicture> pic = rec.finishRecordingAsPicture();
+
+    auto draw = [](const SkPicture* pic, int size) {
+        SkBitmap bm;
+        bm.allocN32Pixels(size, size);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+    auto same = [](const SkBitmap& a, const SkBitmap& b) {
+        return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    sk_sp<SkData> data = pic->serialize();
+    sk_sp<SkPicture> back = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, back && same(draw(pic.get(), 300), draw(back.get(), 300)));
+
+    // Break the second sub-picture by claiming its ops run past the end of the data. (Pictures
+    // start with an 8 byte magic, a version, a cull rect, a byte saying data follows, and then
+    // the ops' tag and size.)
+    std::vector<size_t> starts;
+    for (size_t i = 0; i + 8 <= data->size(); i++) {
+        if (0 == memcmp(data->bytes() + i, "skiapict", 8)) {
+            starts.push_back(i);
+        }
+    }
+    REPORTER_ASSERT(r, starts.size() == 3);
+    if (starts.size() != 3) {
+        return;
+    }
+    sk_sp<SkData> broken = SkData::MakeWithCopy(data->data(), data->size());
+    const uint32_t pastTheEnd = SkToU32(data->size());
+    memcpy((char*)broken->writable_data() + starts[2] + 33, &pastTheEnd, sizeof(pastTheEnd));
+
+    // Parsed up front or left until playback, that's fatal.
+    SkDeserialProcs procs;
+    procs.fImageProc = [](const void*, size_t, void*) -> sk_sp<SkImage> { return nullptr; };
+    REPORTER_ASSERT(r, !SkPicture::MakeFromData(broken.get(), &procs));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromData(broken.get()));
+}
+
+DEF_TEST(Picture_parallelDeserialize, r) {
+    auto make_image = [](int i) {
+        SkBitmap bm;
+        bm.allocN32Pixels(16, 16);
+        bm.eraseColor(SkColorSetARGB(0xFF, 40*i, 255 - 40*i, 0x80));
+        bm.erase(SK_ColorBLACK, SkIRect::MakeXYWH(i, i, 4, 4));
+        bm.setImmutable();
+        return SkImage::MakeFromBitmap(bm);
+    };
+    auto make_pic = [&](int first) {
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording({0,0, 100,100});
+        for (int i = first; i < first + 3; i++) {
+            c->drawImage(make_image(i), 20*i % 100, 20*(i / 5));
+        }
+        return rec.finishRecordingAsPicture();
+    };
+
+    SkPictureRecorder rec;
+    SkCanvas* c = rec.beginRecording({0,0, 100,100});
+    c->drawPicture(make_pic(0));
+    c->drawPicture(make_pic(3));
+    c->drawImage(make_image(6), 50, 50);
+    c->drawImage(make_image(7), 70, 70);
+    sk_sp<SkData> data = rec.finishRecordingAsPicture()->serialize();
+
+    auto draw = [](const SkPicture* pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(100, 100);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+
+    // A custom image proc keeps the sub-pictures from being left unparsed, so all their images
+    // are decoded while deserializing.
+    std::atomic<int> decoded{0};
+    SkDeserialProcs procs;
+    procs.fImageProc = [](const void* data, size_t length, void* ctx) -> sk_sp<SkImage> {
+        static_cast<std::atomic<int>*>(ctx)->fetch_add(1);
+        return nullptr;
+    };
+    procs.fImageCtx = &decoded;
+
+    sk_sp<SkPicture> serial = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(r, serial && decoded == 8);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    procs.fExecutor = executor.get();
+    decoded = 0;
+    sk_sp<SkPicture> parallel = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(r, parallel && decoded == 8);
+    if (serial && parallel) {
+        SkBitmap a = draw(serial.get()),
+                 b = draw(parallel.get());
+        REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()));
+    }
+
+    // Sub-pictures parse on the pool's only thread, which can't wait on the pool itself.
+    executor = SkExecutor::MakeFIFOThreadPool(1, false);
+    procs.fExecutor = executor.get();
+    decoded = 0;
+    REPORTER_ASSERT(r, SkPicture::MakeFromData(data.get(), &procs) && decoded == 8);
+}
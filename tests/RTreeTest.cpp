@@ -89,3 +89,99 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_Hilbert, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        SkRTree rtree(SkRTree::BulkLoad::kHilbert);
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+        rtree.insert(rects.get(), NUM_RECTS);
+
+        // run_queries() expects results in ascending order, which the vector search() sorts into.
+        run_queries(reporter, rand, rects, rtree);
+        REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+}
+
+DEF_TEST(RTree_CallbackSearch, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int j = 0; j < NUM_RECTS; j++) {
+        rects[j] = random_rect(rand);
+    }
+    SkRTree rtree;
+    rtree.insert(rects.get(), NUM_RECTS);
+
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        std::vector<int> hits;
+        SkRect query = random_rect(rand);
+        rtree.search(query, [&](int index) { hits.push_back(index); });
+        // A tree bulk loaded in input order is walked in that order too.
+        REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+    }
+
+    // Empty and NaN queries find nothing.
+    int found = 0;
+    rtree.search(SkRect::MakeEmpty(), [&](int) { found++; });
+    rtree.search(SkRect::MakeLTRB(0, 0, SK_ScalarNaN, 1000), [&](int) { found++; });
+    REPORTER_ASSERT(reporter, found == 0);
+}
+
+DEF_TEST(RTree_Incremental, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int j = 0; j < NUM_RECTS; j++) {
+        rects[j] = random_rect(rand);
+    }
+
+    // Build half the tree in bulk, and the other half one at a time.
+    SkRTree rtree;
+    rtree.insert(rects.get(), NUM_RECTS / 2);
+    for (int j = NUM_RECTS / 2; j < NUM_RECTS; j++) {
+        rtree.insert(j, rects[j]);
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+    REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+    run_queries(reporter, rand, rects, rtree);
+
+    // Move every rect around, near and far.
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        int j = rand.nextULessThan(NUM_RECTS);
+        if (rand.nextBool()) {
+            rects[j].offset(rand.nextRangeF(-1, 1), rand.nextRangeF(-1, 1));
+        } else {
+            rects[j] = random_rect(rand);
+        }
+        rtree.update(j, rects[j]);
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+    REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+    run_queries(reporter, rand, rects, rtree);
+
+    // Remove every other rect, which verify_query() will expect to find empty.
+    for (int j = 0; j < NUM_RECTS; j += 2) {
+        rtree.remove(j);
+        rects[j].setEmpty();
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+    rtree.remove(0);  // Not there any more.
+    REPORTER_ASSERT(reporter, NUM_RECTS / 2 == rtree.getCount());
+    run_queries(reporter, rand, rects, rtree);
+
+    // Updating to empty bounds removes, and back again inserts.
+    rtree.update(1, SkRect::MakeEmpty());
+    REPORTER_ASSERT(reporter, NUM_RECTS / 2 - 1 == rtree.getCount());
+    rtree.update(1, rects[1]);
+    REPORTER_ASSERT(reporter, NUM_RECTS / 2 == rtree.getCount());
+
+    for (int j = 1; j < NUM_RECTS; j += 2) {
+        rtree.remove(j);
+        REPORTER_ASSERT(reporter, rtree.isValid());
+    }
+    REPORTER_ASSERT(reporter, 0 == rtree.getCount());
+    REPORTER_ASSERT(reporter, 0 == rtree.getDepth());
+}
@@ -8,11 +8,17 @@
 #include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
+#include "src/core/SkClipOpPriv.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -347,6 +353,221 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     index += 4;
 }
 
+// Draws record into a small raster surface before and after pass, and asserts they match.
+static void assert_draws_same(skiatest::Reporter* r, SkRecord* record,
+                              void (*pass)(SkRecord*), SkScalar scale = 1) {
+    SkBitmap before, after;
+    before.allocN32Pixels(200, 200);
+    after.allocN32Pixels(200, 200);
+    before.eraseColor(SK_ColorWHITE);
+    after.eraseColor(SK_ColorWHITE);
+
+    SkCanvas beforeCanvas(before);
+    beforeCanvas.scale(scale, scale);
+    SkRecordDraw(*record, &beforeCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    pass(record);
+    SkCanvas afterCanvas(after);
+    afterCanvas.scale(scale, scale);
+    SkRecordDraw(*record, &afterCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+
+    for (int y = 0; y < before.height(); y++) {
+        REPORTER_ASSERT(r, !memcmp(before.getAddr32(0, y), after.getAddr32(0, y),
+                                   before.rowBytes()), "row %d", y);
+    }
+}
+
+DEF_TEST(RecordOpts_NoopSubsumedClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.clipRect(SkRect::MakeLTRB(-10, -10, 200, 200));      // Contains the clip.
+    recorder.save();
+        recorder.translate(10, 10);
+        recorder.clipRect(SkRect::MakeLTRB(-10, -10, 90, 90));    // Same as the clip.
+        recorder.clipRect(SkRect::MakeLTRB(10, 10, 50, 50));      // Shrinks it.
+        recorder.clipRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(0, 0, 60, 60), 5, 5));
+        recorder.drawRect(SkRect::MakeWH(300, 300), SkPaint());
+    recorder.restore();
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 100, 150), SkClipOp::kDifference);
+    recorder.rotate(30);
+    recorder.clipRect(SkRect::MakeLTRB(-1000, -1000, 1000, 1000));  // Not a rect any more.
+
+    SkRecordNoopSubsumedClips(&record);
+    assert_type<SkRecords::ClipRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::NoOp>    (r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 5);
+    // The rrect's corners are outside (10,10)-(50,50) in device space.
+    assert_type<SkRecords::NoOp>    (r, record, 6);
+    assert_type<SkRecords::ClipRect>(r, record, 9);
+    assert_type<SkRecords::ClipRect>(r, record, 11);
+}
+
+DEF_TEST(RecordOpts_NoopSubsumedClipsAfterReplace, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // The deprecated ops can grow the clip, so what's intersected after them still counts.
+    recorder.clipRect(SkRect::MakeWH(50, 50));
+    recorder.clipRect(SkRect::MakeWH(150, 150), kReplace_SkClipOp, false);
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    recorder.clipRect(SkRect::MakeWH(20, 20));
+    recorder.clipRegion(SkRegion(SkIRect::MakeWH(150, 150)), kReplace_SkClipOp);
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+
+    assert_draws_same(r, &record, SkRecordNoopSubsumedClips);
+    assert_type<SkRecords::ClipRect>(r, record, 2);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+}
+
+DEF_TEST(RecordOpts_NoopSubsumedAAClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // Antialiased edges need room that depends on how much playback scales down, so no amount
+    // of it makes either clip a no-op.
+    recorder.clipRect(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 90.5f), true);
+    recorder.clipRect(SkRect::MakeLTRB(10, 10, 91, 91), false);   // Would drop edge pixels.
+    recorder.clipRect(SkRect::MakeLTRB(10, 10, 91, 91), true);    // Touches them too.
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), true);
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), false);
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+
+    SkRecordNoopSubsumedClips(&record);
+    for (int i = 0; i < 5; i++) {
+        assert_type<SkRecords::ClipRect>(r, record, i);
+    }
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, translucent, aa;
+    red.setColor(SK_ColorRED);
+    translucent.setColor(0x800000FF);
+    aa.setAntiAlias(true);
+
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), translucent);      // 0
+    recorder.drawOval(SkRect::MakeLTRB(20, 20, 90, 90), aa);               // 1
+    recorder.drawRect(SkRect::MakeLTRB(85, 85, 120, 120), red);            // 2, sticks out
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 100, 100), translucent);    // 3, see-through
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 100, 100), red);            // 4
+    recorder.save();                                                       // 5
+        recorder.translate(50, 50);                                        // 6
+        recorder.drawRect(SkRect::MakeLTRB(0, 0, 40, 40), translucent);    // 7
+    recorder.restore();                                                    // 8
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 150, 150), red);              // 9
+    recorder.drawRect(SkRect::MakeLTRB(20, 20, 30, 30), red);              // 10
+    recorder.drawPaint(red);                                               // 11
+
+    SkRecord copy;
+    SkRecorder copier(&copy, W, H);
+    SkRecordDraw(record, &copier, nullptr, nullptr, 0, nullptr, nullptr);
+
+    SkRecordNoopOccludedDraws(&record);
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::NoOp>    (r, record, 3);
+    // Runs end at state changes, so the draws inside the Save block, and 4, are left alone.
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::NoOp>    (r, record, 9);
+    assert_type<SkRecords::NoOp>    (r, record, 10);
+    assert_type<SkRecords::DrawPaint>(r, record, 11);
+
+    // Without the DrawPaint at the end, there's something to see.
+    copy.replace<SkRecords::NoOp>(11);
+    assert_draws_same(r, &copy, SkRecordNoopOccludedDraws);
+    REPORTER_ASSERT(r, 5 == count_instances_of_type<SkRecords::DrawRect>(copy));
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsAAClip, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    // The clip's edge only partly covers its pixels, so the first draws show through there.
+    recorder.clipRect(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 90.5f), true);
+    recorder.drawRect(SkRect::MakeLTRB(20, 20, 40, 40), blue);
+    recorder.drawRect(SkRect::MakeWH(200, 200), blue);
+    recorder.drawRect(SkRect::MakeWH(200, 200), red);
+    recorder.drawPaint(red);
+
+    assert_draws_same(r, &record, SkRecordNoopOccludedDraws);
+    REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawRect>(record));
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsAAPaint, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint blue, red;
+    blue.setColor(SK_ColorBLUE);
+    red.setColor(SK_ColorRED);
+    red.setAntiAlias(true);
+
+    // The red rect's edges fall between pixels here, but not once played back at half scale.
+    recorder.drawRect(SkRect::MakeWH(200, 200), blue);
+    recorder.drawRect(SkRect::MakeLTRB(11, 11, 101, 101), red);
+    recorder.drawRect(SkRect::MakeLTRB(11, 11, 101, 101), red);
+
+    assert_draws_same(r, &record, SkRecordNoopOccludedDraws, 0.5f);
+    REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawRect>(record));
+}
+
+DEF_TEST(RecordOpts_MergeImageDraws, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 20);
+    for (int y = 0; y < 20; y++) {
+        for (int x = 0; x < 20; x++) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(SkColorSetARGB(0xFF, x * 12, y * 12, 0));
+        }
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint, other;
+    paint.setAlphaf(0.5f);
+    other.setBlendMode(SkBlendMode::kMultiply);
+
+    recorder.drawImage(image, 0, 0, &paint);
+    recorder.drawImageRect(image, SkRect::MakeLTRB(5, 5, 10, 10), SkRect::MakeXYWH(30, 0, 5, 5),
+                           &paint, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(60, 0, 20, 20), &paint);
+    recorder.drawImage(image, 90, 0, &other);
+    recorder.drawImage(image, 120, 0, &other);
+    recorder.drawImage(image, 150, 0);
+    recorder.translate(0, 50);
+    recorder.drawImage(image, 0, 0);
+    recorder.drawImage(image, 30, 0);
+    // Sources outside the image are left to drawImageRect() to sort out.
+    recorder.drawImageRect(image, SkRect::MakeLTRB(-5, -5, 10, 10), SkRect::MakeXYWH(60, 0, 15, 15),
+                           nullptr);
+
+    assert_draws_same(r, &record, SkRecordMergeImageDraws);
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    REPORTER_ASSERT(r, set->count == 3);
+    REPORTER_ASSERT(r, set->paint && set->paint->getAlphaf() == 0.5f);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 3);
+    REPORTER_ASSERT(r, set->count == 2);
+    assert_type<SkRecords::DrawImage>(r, record, 5);
+    set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 7);
+    REPORTER_ASSERT(r, set->count == 2 && !set->paint);
+    assert_type<SkRecords::DrawImageRect>(r, record, 9);
+}
+
 static void do_draw(SkCanvas* canvas, SkColor color, bool doLayer) {
     canvas->drawColor(SK_ColorWHITE);
 
@@ -97,6 +97,25 @@ DEF_TEST(Record_defrag, r) {
     assert_type<SkRecords::Restore >(r, record, 3);
 }
 
+// Commands are allocated apart from the data they point to, so they sit next to each other.
+DEF_TEST(Record_CommandsAreContiguous, r) {
+    SkRecord record;
+    const int kCount = 32;
+    for (int i = 0; i < kCount; i++) {
+        SkPoint* pts = record.alloc<SkPoint>(4);
+        APPEND(record, SkRecords::DrawPoints, SkPaint(), SkCanvas::kPoints_PointMode, 4, pts);
+    }
+
+    // Only the arena's block boundaries can come between neighbors.
+    int adjacent = 0;
+    for (int i = 1; i < kCount; i++) {
+        auto prev = assert_type<SkRecords::DrawPoints>(r, record, i - 1),
+             curr = assert_type<SkRecords::DrawPoints>(r, record, i);
+        adjacent += (curr == prev + 1);
+    }
+    REPORTER_ASSERT(r, adjacent >= kCount / 2, "%d", adjacent);
+}
+
 #undef APPEND
 
 template <typename T>
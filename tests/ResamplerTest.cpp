@@ -0,0 +1,131 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "src/core/SkResampler.h"
+#include "tests/Test.h"
+
+static const SkPixmap::ResampleFilter kFilters[] = {
+    SkPixmap::ResampleFilter::kTriangle,
+    SkPixmap::ResampleFilter::kMitchell,
+    SkPixmap::ResampleFilter::kCatmullRom,
+    SkPixmap::ResampleFilter::kLanczos3,
+};
+
+static SkBitmap make_checkerboard(int w, int h, SkColor a, SkColor b) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32(w, h, kPremul_SkAlphaType, SkColorSpace::MakeSRGB()));
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            *bm.getAddr32(x, y) = SkPreMultiplyColor(((x ^ y) & 1) ? a : b);
+        }
+    }
+    return bm;
+}
+
+// Weights sum to one, so a solid color scales to the same solid color, up or down.
+DEF_TEST(Resampler_SolidColor, r) {
+    const SkISize sizes[][2] = {
+        {{97, 61}, {31, 20}},
+        {{13, 9}, {40, 27}},
+        {{200, 3}, {7, 100}},
+        {{1, 1}, {5, 3}},
+    };
+    const SkColor unpremul = SkColorSetARGB(0x80, 0x40, 0xC0, 0x20);
+    const SkPMColor color = SkPreMultiplyColor(unpremul);
+    for (SkPixmap::ResampleFilter filter : kFilters) {
+        for (auto [srcSize, dstSize] : sizes) {
+            SkBitmap src, dst;
+            src.allocN32Pixels(srcSize.width(), srcSize.height());
+            src.eraseColor(unpremul);
+            dst.allocN32Pixels(dstSize.width(), dstSize.height());
+            REPORTER_ASSERT(r, src.pixmap().scalePixels(dst.pixmap(), filter));
+            for (int y = 0; y < dst.height(); ++y) {
+                for (int x = 0; x < dst.width(); ++x) {
+                    SkPMColor c = *dst.getAddr32(x, y);
+                    REPORTER_ASSERT(r, SkAbs32(SkGetPackedA32(c) - SkGetPackedA32(color)) <= 1 &&
+                                       SkAbs32(SkGetPackedR32(c) - SkGetPackedR32(color)) <= 1 &&
+                                       SkAbs32(SkGetPackedG32(c) - SkGetPackedG32(color)) <= 1 &&
+                                       SkAbs32(SkGetPackedB32(c) - SkGetPackedB32(color)) <= 1,
+                                    "%08x vs %08x", c, color);
+                }
+            }
+        }
+    }
+}
+
+// Reducing a checkerboard by 3, where point sampling would alias to black or white, averages it
+// to gray: 50% of the encoded values, or of linear light when filtering linear values.
+DEF_TEST(Resampler_Checkerboard, r) {
+    SkBitmap src = make_checkerboard(300, 240, SK_ColorWHITE, SK_ColorBLACK);
+    for (SkPixmap::ResampleFilter filter : kFilters) {
+        for (bool linear : {false, true}) {
+            SkBitmap dst;
+            dst.allocPixels(src.info().makeWH(100, 80));
+            REPORTER_ASSERT(r, src.pixmap().scalePixels(dst.pixmap(), filter, linear));
+            const int expected = linear ? 188 : 128;
+            for (int y = 0; y < dst.height(); ++y) {
+                for (int x = 0; x < dst.width(); ++x) {
+                    SkColor c = dst.getColor(x, y);
+                    REPORTER_ASSERT(r, SkColorGetA(c) == 0xFF);
+                    REPORTER_ASSERT(r, SkAbs32((int)SkColorGetG(c) - expected) <= 8,
+                                    "filter %d linear %d: %d", (int)filter, linear,
+                                    SkColorGetG(c));
+                }
+            }
+        }
+    }
+}
+
+// Rows of dst are filled in strips; a vertical ramp must stay a ramp across their edges. The
+// ramp steps every four rows, which Lanczos rings around by up to one.
+DEF_TEST(Resampler_Strips, r) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeA8(3, 1024));
+    for (int y = 0; y < src.height(); ++y) {
+        memset(src.getAddr8(0, y), y / 4, src.width());
+    }
+    for (SkPixmap::ResampleFilter filter : kFilters) {
+        for (int dstHeight : {700, 300}) {
+            SkBitmap dst;
+            dst.allocPixels(SkImageInfo::MakeA8(5, dstHeight));
+            SkResampler resampler(src.dimensions(), dst.dimensions(), filter);
+            REPORTER_ASSERT(r, resampler.resample(src.pixmap(), dst.pixmap()));
+            for (int y = 1; y < dst.height(); ++y) {
+                REPORTER_ASSERT(r, *dst.getAddr8(2, y - 1) <= *dst.getAddr8(2, y) + 1,
+                                "filter %d, row %d", (int)filter, y);
+            }
+            REPORTER_ASSERT(r, *dst.getAddr8(0, 0) <= 1);
+            REPORTER_ASSERT(r, *dst.getAddr8(0, dstHeight - 1) >= 254);
+
+            // Pixmaps of other sizes are rejected.
+            REPORTER_ASSERT(r, !resampler.resample(dst.pixmap(), src.pixmap()));
+        }
+    }
+}
+
+// Sharp filters ring around edges, but never into invalid premultiplied colors.
+DEF_TEST(Resampler_Premul, r) {
+    SkBitmap src = make_checkerboard(64, 64, SK_ColorTRANSPARENT, SK_ColorWHITE);
+    for (SkPixmap::ResampleFilter filter : kFilters) {
+        for (SkISize size : {SkISize{150, 150}, SkISize{40, 23}}) {
+            SkBitmap dst;
+            dst.allocPixels(src.info().makeDimensions(size));
+            REPORTER_ASSERT(r, src.pixmap().scalePixels(dst.pixmap(), filter));
+            for (int y = 0; y < dst.height(); ++y) {
+                for (int x = 0; x < dst.width(); ++x) {
+                    SkPMColor c = *dst.getAddr32(x, y);
+                    REPORTER_ASSERT(r, SkGetPackedR32(c) <= SkGetPackedA32(c) &&
+                                       SkGetPackedG32(c) <= SkGetPackedA32(c) &&
+                                       SkGetPackedB32(c) <= SkGetPackedA32(c));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/utils/SkRetainedPictureRecorder.h"
+#include "tests/Test.h"
+
+static const SkRect kBounds = SkRect::MakeWH(100, 100);
+
+// Each group draws a row of rects, in a color we can change between frames.
+static void draw_group(SkCanvas* canvas, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    for (int i = 0; i < 4; i++) {
+        canvas->drawRect(SkRect::MakeXYWH(i * 10, 0, 8, 8), paint);
+    }
+}
+
+// Records a frame of three groups, translated one below the next, with group 2 inside group 1.
+static sk_sp<SkPicture> record_frame(SkRetainedPictureRecorder* recorder, const SkColor colors[3],
+                                     SkBBHFactory* factory = nullptr) {
+    SkCanvas* canvas = recorder->beginRecording(kBounds, factory);
+    canvas->drawColor(SK_ColorWHITE);
+    if (!recorder->drawGroup(1)) {
+        SkCanvas* group = recorder->beginGroup(1, kBounds);
+        draw_group(group, colors[0]);
+        group->translate(0, 20);
+        if (!recorder->drawGroup(2)) {
+            draw_group(recorder->beginGroup(2, kBounds), colors[1]);
+            recorder->endGroup();
+        }
+        recorder->endGroup();
+    }
+    canvas->translate(0, 50);
+    if (!recorder->drawGroup(3)) {
+        draw_group(recorder->beginGroup(3, kBounds), colors[2]);
+        recorder->endGroup();
+    }
+    return recorder->finishRecordingAsPicture();
+}
+
+// What record_frame() should draw, recorded from scratch.
+static sk_sp<SkPicture> expected_frame(const SkColor colors[3]) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kBounds);
+    canvas->drawColor(SK_ColorWHITE);
+    draw_group(canvas, colors[0]);
+    canvas->save();
+    canvas->translate(0, 20);
+    draw_group(canvas, colors[1]);
+    canvas->restore();
+    canvas->translate(0, 50);
+    draw_group(canvas, colors[2]);
+    return recorder.finishRecordingAsPicture();
+}
+
+static void assert_draws_same(skiatest::Reporter* r, SkPicture* a, SkPicture* b) {
+    SkBitmap bitmapA, bitmapB;
+    bitmapA.allocN32Pixels(100, 100);
+    bitmapB.allocN32Pixels(100, 100);
+    SkCanvas(bitmapA).drawPicture(a);
+    SkCanvas(bitmapB).drawPicture(b);
+    for (int y = 0; y < 100; y++) {
+        REPORTER_ASSERT(r, !memcmp(bitmapA.getAddr32(0, y), bitmapB.getAddr32(0, y),
+                                   bitmapA.rowBytes()), "row %d", y);
+    }
+}
+
+DEF_TEST(RetainedPictureRecorder_Reuse, r) {
+    SkRTreeFactory factory;
+    SkRetainedPictureRecorder recorder;
+    SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+
+    sk_sp<SkPicture> frame = record_frame(&recorder, colors, &factory);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 3);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 0);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRetained == 3);
+    assert_draws_same(r, frame.get(), expected_frame(colors).get());
+
+    // Nothing's changed, so the next frame is all reused, even though the colors have.
+    SkColor changed[] = {SK_ColorBLACK, SK_ColorBLACK, SK_ColorBLACK};
+    frame = record_frame(&recorder, changed, &factory);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 0);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 2);  // Group 2 comes inside group 1.
+    assert_draws_same(r, frame.get(), expected_frame(colors).get());
+
+    recorder.invalidateAll();
+    frame = record_frame(&recorder, changed, &factory);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 3);
+    assert_draws_same(r, frame.get(), expected_frame(changed).get());
+}
+
+DEF_TEST(RetainedPictureRecorder_Invalidate, r) {
+    SkRetainedPictureRecorder recorder;
+    SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    record_frame(&recorder, colors);
+
+    // Invalidating group 2 means recording group 1 around it again, but not group 3.
+    colors[1] = SK_ColorYELLOW;
+    recorder.invalidate(2);
+    sk_sp<SkPicture> frame = record_frame(&recorder, colors);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 2);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 1);
+    assert_draws_same(r, frame.get(), expected_frame(colors).get());
+
+    // Keys we've never seen are ignored.
+    recorder.invalidate(42);
+    record_frame(&recorder, colors);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 0);
+}
+
+DEF_TEST(RetainedPictureRecorder_DropsUnusedGroups, r) {
+    SkRetainedPictureRecorder recorder;
+    SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    record_frame(&recorder, colors);
+
+    // A frame without group 3...
+    recorder.beginRecording(kBounds);
+    REPORTER_ASSERT(r, recorder.drawGroup(1));
+    recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRetained == 2);
+
+    // ... forgets it.
+    record_frame(&recorder, colors);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 1);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 1);
+}
+
+DEF_TEST(RetainedPictureRecorder_InvalidateWhileRecording, r) {
+    SkRetainedPictureRecorder recorder;
+    SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    record_frame(&recorder, colors);
+    recorder.invalidate(1);
+
+    // Group 1 is recorded around the old group 2, which goes stale before group 1 is done.
+    recorder.beginRecording(kBounds);
+    recorder.beginGroup(1, kBounds);
+    REPORTER_ASSERT(r, recorder.drawGroup(2));
+    recorder.invalidate(2);
+    recorder.endGroup();
+    REPORTER_ASSERT(r, recorder.drawGroup(3));
+    recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRetained == 1);
+
+    record_frame(&recorder, colors);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 2);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 1);
+}
+
+DEF_TEST(RetainedPictureRecorder_GroupInTwoContainers, r) {
+    // Group 2 is drawn inside both group 1 and group 3.
+    auto frame = [](SkRetainedPictureRecorder* recorder, SkColor color) {
+        recorder->beginRecording(kBounds);
+        for (uint64_t key : {1, 3}) {
+            if (!recorder->drawGroup(key)) {
+                recorder->beginGroup(key, kBounds);
+                if (!recorder->drawGroup(2)) {
+                    draw_group(recorder->beginGroup(2, kBounds), color);
+                    recorder->endGroup();
+                }
+                recorder->endGroup();
+            }
+        }
+        return recorder->finishRecordingAsPicture();
+    };
+
+    SkRetainedPictureRecorder recorder;
+    frame(&recorder, SK_ColorRED);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 3);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRetained == 3);
+
+    // Both containers hold the old group 2, so both are recorded again.
+    recorder.invalidate(2);
+    sk_sp<SkPicture> picture = frame(&recorder, SK_ColorBLUE);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 3);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsReused == 1);
+
+    SkPictureRecorder expected;
+    SkCanvas* canvas = expected.beginRecording(kBounds);
+    draw_group(canvas, SK_ColorBLUE);
+    draw_group(canvas, SK_ColorBLUE);
+    assert_draws_same(r, picture.get(), expected.finishRecordingAsPicture().get());
+
+    // Group 2 is kept while either container is drawn.
+    recorder.beginRecording(kBounds);
+    REPORTER_ASSERT(r, recorder.drawGroup(3));
+    recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRetained == 2);
+    recorder.invalidate(2);
+    frame(&recorder, SK_ColorBLUE);
+    REPORTER_ASSERT(r, recorder.stats().fGroupsRecorded == 3);
+}
@@ -886,3 +886,68 @@ DEF_TEST(ReadBuffer_empty, reporter) {
     REPORTER_ASSERT(reporter, data->size() == 0);
     REPORTER_ASSERT(reporter, reader.readInt() == 321);
 }
+
+DEF_TEST(ReadBuffer_views, reporter) {
+    const int32_t ints[] = {1, 2, 3};
+    const SkPoint points[] = {{1, 2}, {3, 4}};
+    SkBinaryWriteBuffer writer;
+    writer.writeByteArray("abcde", 5);
+    writer.writeIntArray(ints, 3);
+    writer.writePointArray(points, 2);
+    writer.writeIntArray(ints, 3);
+
+    size_t size = writer.bytesWritten();
+    SkAutoMalloc storage(size);
+    writer.writeToMemory(storage.get());
+
+    SkReadBuffer reader(storage.get(), size);
+    SkSpan<const uint8_t> bytes = reader.readByteArrayView();
+    REPORTER_ASSERT(reporter, bytes.size() == 5 && !memcmp(bytes.data(), "abcde", 5));
+    SkSpan<const int32_t> intView = reader.readIntArrayView();
+    REPORTER_ASSERT(reporter, intView.size() == 3 && !memcmp(intView.data(), ints, sizeof(ints)));
+    SkSpan<const SkPoint> pointView = reader.readPointArrayView();
+    REPORTER_ASSERT(reporter, pointView.size() == 2 && pointView[1] == points[1]);
+    // The views point into the buffer, rather than at copies.
+    REPORTER_ASSERT(reporter, (const char*)intView.data() > (const char*)storage.get() &&
+                              (const char*)intView.data() < (const char*)storage.get() + size);
+    REPORTER_ASSERT(reporter, reader.isValid());
+
+    // Truncating the last array leaves an empty view, and the buffer invalid.
+    SkReadBuffer truncated(storage.get(), size - 4);
+    truncated.readByteArrayView();
+    truncated.readIntArrayView();
+    truncated.readPointArrayView();
+    REPORTER_ASSERT(reporter, truncated.isValid());
+    REPORTER_ASSERT(reporter, truncated.readIntArrayView().empty());
+    REPORTER_ASSERT(reporter, !truncated.isValid());
+}
+
+DEF_TEST(ReadBuffer_sharesData, reporter) {
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(123);
+    writer.writeByteArray("abcdefgh", 8);
+    sk_sp<SkData> data = writer.snapshotAsData();
+    auto inside = [&](const sk_sp<SkData>& d) {
+        const char* p = (const char*)d->data();
+        return p >= (const char*)data->data() && p < (const char*)data->data() + data->size();
+    };
+
+    // Backed by an SkData, byte arrays share it...
+    SkReadBuffer shared(data);
+    REPORTER_ASSERT(reporter, shared.readInt() == 123);
+    sk_sp<SkData> bytes = shared.readByteArrayAsData();
+    REPORTER_ASSERT(reporter, bytes && bytes->size() == 8 && inside(bytes));
+    REPORTER_ASSERT(reporter, !memcmp(bytes->data(), "abcdefgh", 8));
+
+    // ... and keep it alive.
+    shared.setMemory(nullptr, 0);
+    data = nullptr;
+    REPORTER_ASSERT(reporter, !memcmp(bytes->data(), "abcdefgh", 8));
+
+    // Over plain memory, they're copied.
+    data = writer.snapshotAsData();
+    SkReadBuffer copied(data->data(), data->size());
+    REPORTER_ASSERT(reporter, copied.readInt() == 123);
+    bytes = copied.readByteArrayAsData();
+    REPORTER_ASSERT(reporter, bytes && bytes->size() == 8 && !inside(bytes));
+}
@@ -25,6 +25,8 @@
 #include "tools/ToolUtils.h"
 #include "tools/fonts/TestEmptyTypeface.h"
 
+#include <algorithm>
+
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
                            public SkStrikeClient::DiscardableHandleManager {
 public:
@@ -116,12 +118,13 @@ private:
     int fCacheMissCount[SkStrikeClient::CacheMissType::kLast + 1u];
 };
 
-sk_sp<SkTextBlob> buildTextBlob(sk_sp<SkTypeface> tf, int glyphCount) {
+sk_sp<SkTextBlob> buildTextBlob(sk_sp<SkTypeface> tf, int glyphCount,
+                                SkFont::Edging edging = SkFont::Edging::kAntiAlias) {
     SkFont font;
     font.setTypeface(tf);
     font.setHinting(SkFontHinting::kNormal);
     font.setSize(1u);
-    font.setEdging(SkFont::Edging::kAntiAlias);
+    font.setEdging(edging);
     font.setSubpixel(true);
 
     SkTextBlobBuilder builder;
@@ -483,6 +486,133 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRemoteGlyphCache_DrawTextAsPath, reporter,
     discardableManager->unlockAndDeleteAll();
 }
 
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkRemoteGlyphCache_PathsSentOnce, reporter, ctxInfo) {
+    auto direct = ctxInfo.directContext();
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager, false);
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(0);
+
+    // Server.
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+
+    int glyphCount = 10;
+    auto serverBlob = buildTextBlob(serverTf, glyphCount);
+    auto props = FindSurfaceProps(direct);
+    SkTextBlobCacheDiffCanvas cache_diff_canvas(
+            10, 10, props, &server, direct->supportsDistanceFieldText());
+    cache_diff_canvas.drawTextBlob(serverBlob.get(), 0, 0, paint);
+    std::vector<uint8_t> firstStrikeData;
+    server.writeStrikeData(&firstStrikeData);
+
+    // The same glyphs without antialiasing need another strike, but not their paths again.
+    auto aliasedServerBlob = buildTextBlob(serverTf, glyphCount, SkFont::Edging::kAlias);
+    cache_diff_canvas.drawTextBlob(aliasedServerBlob.get(), 0, 0, paint);
+    std::vector<uint8_t> secondStrikeData;
+    server.writeStrikeData(&secondStrikeData);
+
+    // The second batch has the strike, so it isn't empty, but it's smaller than the first by at
+    // least the bytes of every path: it sends each by its index instead.
+    SkFont font(serverTf, 1);
+    std::vector<sk_sp<SkData>> paths;
+    for (SkGlyphID glyph = 0; glyph < glyphCount; glyph++) {
+        SkPath path;
+        if (!font.getPath(glyph, &path) || path.isEmpty()) {
+            continue;
+        }
+        sk_sp<SkData> bytes = path.serialize();
+        if (std::none_of(paths.begin(), paths.end(),
+                         [&](const sk_sp<SkData>& p) { return p->equals(bytes.get()); })) {
+            paths.push_back(std::move(bytes));
+        }
+    }
+    size_t pathBytes = 0;
+    for (const sk_sp<SkData>& bytes : paths) {
+        pathBytes += bytes->size();
+    }
+    REPORTER_ASSERT(reporter, pathBytes > 0);
+    REPORTER_ASSERT(reporter, !secondStrikeData.empty());
+    REPORTER_ASSERT(reporter, secondStrikeData.size() + pathBytes <= firstStrikeData.size(),
+                    "%zu + %zu > %zu", secondStrikeData.size(), pathBytes, firstStrikeData.size());
+
+    // Client.
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(firstStrikeData.data(), firstStrikeData.size()));
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(secondStrikeData.data(), secondStrikeData.size()));
+    auto clientBlob = buildTextBlob(clientTf, glyphCount);
+    auto aliasedClientBlob = buildTextBlob(clientTf, glyphCount, SkFont::Edging::kAlias);
+
+    for (auto [expectedBlob, actualBlob] : {std::make_pair(serverBlob, clientBlob),
+                                            std::make_pair(aliasedServerBlob, aliasedClientBlob)}) {
+        SkBitmap expected = RasterBlob(expectedBlob, 10, 10, paint, direct);
+        SkBitmap actual = RasterBlob(actualBlob, 10, 10, paint, direct);
+        compare_blobs(expected, actual, reporter, 1);
+    }
+    REPORTER_ASSERT(reporter, !discardableManager->hasCacheMiss());
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
+
+DEF_TEST(SkRemoteGlyphCache_RejectsCorruptImageBlock, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+
+    // Glyphs big enough that their masks pack well.
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+    auto blob = SkTextBlob::MakeFromString("Skia", SkFont(serverTf, 48));
+    const SkSurfaceProps props;
+    SkTextBlobCacheDiffCanvas cache_diff_canvas(200, 200, props, &server);
+    cache_diff_canvas.drawTextBlob(blob.get(), 10, 100, SkPaint());
+    std::vector<uint8_t> strikeData;
+    server.writeStrikeData(&strikeData);
+
+    // The one strike ends with its image block, then no paths: the unpacked size, the packed
+    // size, the packed bytes, and a 0 path count aligned to 8 bytes.
+    auto read64 = [&](size_t offset) {
+        uint64_t value;
+        memcpy(&value, strikeData.data() + offset, sizeof(value));
+        return value;
+    };
+    const size_t pathCountOffset = strikeData.size() - 8;
+    REPORTER_ASSERT(reporter, strikeData.size() % 8 == 0 && read64(pathCountOffset) == 0);
+    size_t packedSizeOffset = 0;
+    for (size_t offset = 8; offset + 8 < pathCountOffset; offset += 8) {
+        uint64_t packedSize = read64(offset + 8);
+        if (packedSize > 0 && packedSize <= pathCountOffset &&
+            SkAlign8(offset + 16 + packedSize) == pathCountOffset) {
+            packedSizeOffset = offset + 8;
+        }
+    }
+    REPORTER_ASSERT(reporter, packedSizeOffset > 0);
+    if (packedSizeOffset == 0) {
+        return;
+    }
+    const uint64_t imagesSize = read64(packedSizeOffset - 8);
+    REPORTER_ASSERT(reporter, imagesSize / 64 > 1);
+
+    auto read_with_packed_size = [&](uint64_t packedSize) {
+        std::vector<uint8_t> corrupt = strikeData;
+        memcpy(corrupt.data() + packedSizeOffset, &packedSize, sizeof(packedSize));
+        SkStrikeClient client(discardableManager, false);
+        client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+        return client.readStrikeData(corrupt.data(), corrupt.size());
+    };
+    REPORTER_ASSERT(reporter, read_with_packed_size(read64(packedSizeOffset)));
+    // Claims to unpack to more than 64x its size.
+    REPORTER_ASSERT(reporter, !read_with_packed_size(imagesSize / 64 - 1));
+    // Runs past the end of the data.
+    REPORTER_ASSERT(reporter, !read_with_packed_size(strikeData.size()));
+
+    discardableManager->unlockAndDeleteAll();
+}
+
 sk_sp<SkTextBlob> make_blob_causing_fallback(
         sk_sp<SkTypeface> targetTf, const SkTypeface* glyphTf, skiatest::Reporter* reporter) {
     SkFont font;
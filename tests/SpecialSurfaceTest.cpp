@@ -10,6 +10,7 @@
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkSpecialSurfacePool.h"
 #include "src/gpu/GrCaps.h"
 #include "src/gpu/GrDirectContextPriv.h"
 #include "src/gpu/SkGr.h"
@@ -76,6 +77,52 @@ DEF_TEST(SpecialSurface_Raster2, reporter) {
     // TODO: check that the clear didn't escape the active region
 }
 
+// Pixels go back to the pool when the last surface or image using them does, and are handed out
+// again, cleared, for any size in the same bucket.
+DEF_TEST(SpecialSurface_Pool, reporter) {
+    auto pool = sk_make_sp<SkSpecialSurfacePool>(1 << 20);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+
+    sk_sp<SkSpecialSurface> surf = pool->makeRaster(info);
+    surf->getCanvas()->clear(SK_ColorRED);
+    sk_sp<SkSpecialImage> img = surf->makeImageSnapshot();
+    surf.reset();
+    REPORTER_ASSERT(reporter, pool->stats().fAllocations == 1);
+    REPORTER_ASSERT(reporter, pool->stats().fInUseBytes >= info.computeMinByteSize());
+    REPORTER_ASSERT(reporter, pool->stats().fIdleBytes == 0);
+
+    img.reset();
+    REPORTER_ASSERT(reporter, pool->stats().fInUseBytes == 0);
+    REPORTER_ASSERT(reporter, pool->stats().fIdleBytes >= info.computeMinByteSize());
+
+    // A slightly smaller surface reuses the block, which starts out transparent again.
+    surf = pool->makeRaster(info.makeWH(99, 101));
+    REPORTER_ASSERT(reporter, pool->stats().fReuses == 1);
+    REPORTER_ASSERT(reporter, pool->stats().fIdleBytes == 0);
+    SkBitmap pixels;
+    REPORTER_ASSERT(reporter, surf->makeImageSnapshot()->getROPixels(&pixels));
+    REPORTER_ASSERT(reporter, pixels.getColor(50, 50) == SK_ColorTRANSPARENT);
+
+    // A much bigger one doesn't.
+    sk_sp<SkSpecialSurface> big = pool->makeRaster(info.makeWH(300, 300));
+    REPORTER_ASSERT(reporter, pool->stats().fAllocations == 2);
+
+    // Idle blocks are freed down to the budget.
+    pixels.reset();
+    surf.reset();
+    big.reset();
+    const size_t idle = pool->stats().fIdleBytes;
+    pool->setBudget(idle - 1);
+    REPORTER_ASSERT(reporter, pool->stats().fIdleBytes > 0 && pool->stats().fIdleBytes < idle);
+    pool->purge();
+    REPORTER_ASSERT(reporter, pool->stats().fIdleBytes == 0);
+
+    // Surfaces can outlive their pool.
+    surf = pool->makeRaster(info);
+    pool.reset();
+    REPORTER_ASSERT(reporter, surf->getCanvas());
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SpecialSurface_Gpu1, reporter, ctxInfo) {
     auto direct = ctxInfo.directContext();
 
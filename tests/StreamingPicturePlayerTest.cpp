@@ -0,0 +1,146 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/utils/SkRandom.h"
+#include "include/utils/SkStreamingPicturePlayer.h"
+#include "tests/Test.h"
+
+#include <functional>
+#include <vector>
+
+static const SkRect kBounds = SkRect::MakeWH(128, 128);
+
+// Noise, so that the images are big however they're encoded.
+static sk_sp<SkImage> make_image(SkRandom* rand) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) {
+            *bitmap.getAddr32(x, y) = rand->nextU() | 0xFF000000;
+        }
+    }
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
+// Draws plenty of distinct paints, paths and images, a nested picture, and ops after an empty
+// clip that playback can skip.
+static sk_sp<SkPicture> make_picture() {
+    SkPictureRecorder nestedRecorder;
+    SkCanvas* nested = nestedRecorder.beginRecording(kBounds);
+    for (int i = 0; i < 8; i++) {
+        nested->drawCircle(64, 64, 60 - i * 6, SkPaint(SkColor4f{0, i / 8.0f, 1, 1}));
+    }
+    sk_sp<SkPicture> nestedPicture = nestedRecorder.finishRecordingAsPicture();
+
+    SkRandom rand;
+    std::vector<sk_sp<SkImage>> images;
+    for (int i = 0; i < 16; i++) {
+        images.push_back(make_image(&rand));
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kBounds);
+    canvas->drawColor(SK_ColorWHITE);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < 16; i++) {
+            canvas->drawImage(images[i], (i % 4) * 32, (i / 4) * 32);
+
+            SkPaint paint;
+            paint.setColor(SkColorSetARGB(0x80, i * 16, pass * 100, 255 - i * 16));
+            paint.setAntiAlias(true);
+            SkPath path;
+            path.moveTo(i * 8, 0).lineTo(128, i * 8).lineTo(128 - i * 8, 128).close();
+            canvas->drawPath(path, paint);
+        }
+
+        canvas->save();
+        canvas->clipRect(SkRect::MakeEmpty());
+        for (int i = 0; i < 64; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(i, i, 10, 10), SkPaint());
+        }
+        canvas->restore();
+
+        canvas->drawPicture(nestedPicture);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw(const std::function<void(SkCanvas*)>& fn) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(128, 128);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    fn(&canvas);
+    return bitmap;
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(StreamingPicturePlayer_matchesPicture, r) {
+    sk_sp<SkData> data = make_picture()->serialize();
+    sk_sp<SkPicture> picture = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, picture);
+    SkBitmap expected = draw([&](SkCanvas* canvas) { canvas->drawPicture(picture); });
+
+    for (size_t budget : {(size_t)1 << 30, (size_t)8 << 10}) {
+        SkStreamingPicturePlayer::Options options;
+        options.fMemoryBudget = budget;
+        options.fOpWindowBytes = 256;
+        auto player = SkStreamingPicturePlayer::Make(std::make_unique<SkMemoryStream>(data),
+                                                     options);
+        REPORTER_ASSERT(r, player);
+        REPORTER_ASSERT(r, player->cullRect() == picture->cullRect());
+
+        // Play it twice: the second playback starts with what the first kept.
+        for (int i = 0; i < 2; i++) {
+            bool ok = false;
+            SkBitmap actual = draw([&](SkCanvas* canvas) { ok = player->playback(canvas); });
+            REPORTER_ASSERT(r, ok);
+            REPORTER_ASSERT(r, same_pixels(expected, actual));
+        }
+
+        SkStreamingPicturePlayer::Stats stats = player->stats();
+        REPORTER_ASSERT(r, stats.fWindowsRead > 2);
+        REPORTER_ASSERT(r, stats.fResourcesLoaded > 0);
+        if (budget < data->size()) {
+            // Images are evicted and reloaded, but no more than one op's worth goes over budget.
+            REPORTER_ASSERT(r, stats.fResourcesEvicted > 0);
+            REPORTER_ASSERT(r, stats.fPeakBytes <= budget + 32 * 32 * 4 + 1024,
+                            "%zu", stats.fPeakBytes);
+        } else {
+            REPORTER_ASSERT(r, stats.fResourcesEvicted == 0);
+        }
+    }
+}
+
+DEF_TEST(StreamingPicturePlayer_rejectsBadStreams, r) {
+    sk_sp<SkData> data = make_picture()->serialize();
+
+    static const char kGarbage[] = "not a picture at all, just some bytes";
+    REPORTER_ASSERT(r, !SkStreamingPicturePlayer::Make(
+            std::make_unique<SkMemoryStream>(kGarbage, sizeof(kGarbage))));
+
+    // Cut off before the end, the picture can't be skimmed.
+    for (size_t size : {data->size() / 4, data->size() / 2, data->size() - 4}) {
+        REPORTER_ASSERT(r, !SkStreamingPicturePlayer::Make(
+                std::make_unique<SkMemoryStream>(SkData::MakeSubset(data.get(), 0, size))));
+    }
+}
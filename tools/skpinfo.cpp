@@ -11,6 +11,7 @@
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkPictureData.h"
+#include "src/core/SkPicturePriv.h"
 #include "tools/flags/CommandLineFlags.h"
 
 static DEFINE_string2(input, i, "", "skp on which to report");
@@ -130,13 +131,39 @@ int main(int argc, char** argv) {
             chunkSize = 0;
             break;
         }
-        case SK_PICT_PICTURE_TAG:
+        case SK_PICT_PICTURE_TAG: {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_PICTURE_TAG %d\n", chunkSize);
-                SkDebugf("Exiting early due to format limitations\n");
             }
-            return kSuccess;       // TODO: need to store size in bytes
+            if (info.getVersion() < SkPicturePriv::kIndexedSubPictures_Version) {
+                if (FLAGS_tags && !FLAGS_quiet) {
+                    SkDebugf("Exiting early due to format limitations\n");
+                }
+                return kSuccess;
+            }
+
+            // The index of sub-picture sizes lets us skip over all of them.
+            const int count = SkToInt(chunkSize);
+            size_t bytes = 0;
+            for (int i = 0; i < count; i++) {
+                uint32_t size, opCount;
+                if (!stream.readU32(&size) || !stream.readU32(&opCount)) {
+                    return kTruncatedFile;
+                }
+                if (FLAGS_tags && !FLAGS_quiet) {
+                    SkDebugf("    sub-picture %d: %u bytes, %u ops\n", i, size, opCount);
+                }
+                bytes += size;
+            }
+            if (stream.getPosition() + bytes > totStreamSize) {
+                if (!FLAGS_quiet) {
+                    SkDebugf("truncated file\n");
+                }
+                return kTruncatedFile;
+            }
+            chunkSize = SkToU32(bytes);
             break;
+        }
         case SK_PICT_BUFFER_SIZE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_BUFFER_SIZE_TAG %d\n", chunkSize);